@@ -7,6 +7,7 @@
 #include "Orders/RTSOrderTypeWithIndex.h"
 #include "Orders/RTSUseAbilityOrder.h"
 #include "AbilitySystem/RTSGameplayAbility.h"
+#include "AbilitySystem/RTSTagBitset.h"
 #include "RTSAbilitySystemComponent.generated.h"
 
 class UGameplayAbility;
@@ -21,6 +22,8 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FRTSAbilitySystemComponentAbility
                                                TSubclassOf<UGameplayAbility>, Ability, FGameplayAbilitySpecHandle,
                                                AbilitySpecHandle, bool, bWasCancelled);
 
+DECLARE_MULTICAST_DELEGATE(FRTSAbilitySystemComponentAbilitiesChangedSignature);
+
 /** Custom ability system component. */
 UCLASS(BlueprintType)
 class ORDERSABILITIES_API URTSAbilitySystemComponent : public UAbilitySystemComponent,
@@ -141,12 +144,24 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "RTS")
     FRTSAbilitySystemComponentAbilityEndedSignature OnGameplayAbilityEnded;
 
+    /** Event that is invoked when an ability has been granted to, removed from or leveled up by this ability system. */
+    FRTSAbilitySystemComponentAbilitiesChangedSignature OnAbilitiesChanged;
+
     /**
      * Gets the minimum range between the caster and the target that is needed to activate the specified ability.
      * '0' value is returned if the ability has no range.
      */
     float GetAbilityRange(TSubclassOf<URTSGameplayAbility> Ability);
 
+    /**
+     * Gets all tags owned by this ability system, including their parent tags, as bitset. The bitset is kept up to
+     * date as tags are added, and rebuilt lazily after tags have been removed.
+     */
+    const FRTSTagBitset& GetOwnedTagBitset() const;
+
+    /** Gets the order type that is used to issue a unit to activate an ability. */
+    TSoftClassPtr<URTSUseAbilityOrder> GetUseAbilityOrder() const;
+
     //~ Begin IRTSAutoOrderProvider Interface
     void GetAutoOrders_Implementation(TArray<FRTSOrderTypeWithIndex>& OutAutoOrders);
     //~ End IRTSAutoOrderProvider Interface
@@ -154,14 +169,25 @@ public:
 protected:
     //~ Begin UActorComponent Interface
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     //~ End UActorComponent Interface
 
     //~ Begin UAbilitySystemComponent Interface
     virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec);
     virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec);
+    virtual void OnTagUpdated(const FGameplayTag& Tag, bool TagExists) override;
     //~ End UAbilitySystemComponent Interface
 
 private:
+    /** Mirror of the tags owned by this ability system, including their parent tags. */
+    mutable FRTSTagBitset OwnedTagBitset;
+
+    /** Whether tags have been removed since 'OwnedTagBitset' was last rebuilt. */
+    mutable bool bOwnedTagBitsetDirty;
+
+    /** Generation of the gameplay tag dictionary 'OwnedTagBitset' has been built with. */
+    mutable uint32 OwnedTagBitsetGeneration;
+
     /**
      * Tag that is associated with the owner of this component. This is used to look up the attribute values inside the
      * data tables. In this context the last name of the tag is describing the group inside the curve table.
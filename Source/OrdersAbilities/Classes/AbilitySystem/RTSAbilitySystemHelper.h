@@ -9,6 +9,7 @@
 #include "GameplayEffect.h"
 #include "GameplayEffectTypes.h"
 #include "Text.h"
+#include "AbilitySystem/RTSTagBitset.h"
 #include "Orders/RTSOrderTargetData.h"
 #include "Orders/RTSTargetType.h"
 #include "RTSAbilitySystemHelper.generated.h"
@@ -269,6 +270,14 @@ public:
     UFUNCTION(Category = "RTS Ability|Tags", BlueprintPure)
     static FGameplayTagContainer GetRelationshipTags(const AActor* Actor, const AActor* Other);
 
+    /** Discards all cached relationships between teams. Call whenever teams change their attitude towards others. */
+    UFUNCTION(Category = "RTS Ability|Tags", BlueprintCallable)
+    static void NotifyOnTeamAttitudesChanged();
+
+    /** Updates all cached data depending on the team of the specified actor. Call whenever the actor changes teams. */
+    UFUNCTION(Category = "RTS Ability|Tags", BlueprintCallable)
+    static void NotifyOnTeamChanged(AActor* Actor);
+
     // NOTE(np): In A Year Of Rain, we're adding relationship tags based on the team assignments of both players.
     ///**
     // * Gets the tags describing the relationship of the first player to the other (friendly, hostile, neutral, same
@@ -302,6 +311,12 @@ public:
     static bool DoesSatisfyTagRequirements(const FGameplayTagContainer& Tags, const FGameplayTagContainer& RequiredTags,
                                            const FGameplayTagContainer& BlockedTags);
 
+    /**
+     * Gets all tags of the specified ability system, including their parent tags, as bitset. Uses the bitset mirrored
+     * by RTS ability systems, if possible.
+     */
+    static void GetTagBitset(const UAbilitySystemComponent* AbilitySystem, FRTSTagBitset& OutTagBitset);
+
     /** Checks if the specified tags has all of the specified required tags and none of the specified blocked tags. */
     UFUNCTION(Category = "RTS Ability|Tags", BlueprintPure)
     static bool DoesSatisfyTagRequirementsWithResult(const FGameplayTagContainer& Tags,
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/IndirectArray.h"
+#include "GameplayTagContainer.h"
+#include "AbilitySystem/RTSTagBitset.h"
+
+class AActor;
+
+/**
+ * Frame-scoped snapshot of the tags owned by actors, shared by all target searches. The tags of an actor are copied out
+ * of its ability system once per frame, when they are first needed, and stored by slot along with their bitset.
+ * Snapshots of RTS ability systems are discarded as soon as their tags change. Must only be used from the game thread.
+ */
+class ORDERSABILITIES_API FRTSActorTagSnapshot
+{
+public:
+    FRTSActorTagSnapshot();
+
+    /** Gets the snapshot singleton. */
+    static FRTSActorTagSnapshot& Get();
+
+    /**
+     * Gets the slot of the specified actor in the snapshot of the current frame, taking the snapshot of its tags if
+     * necessary. Slots stay the same for the rest of the frame. Returns INDEX_NONE for invalid actors.
+     */
+    int32 FindOrAddSlot(const AActor* Actor);
+
+    /** Gets the tags owned by the actor in the specified slot. */
+    const FGameplayTagContainer& GetOwnedTags(int32 Slot) const;
+
+    /** Gets the tags owned by the actor in the specified slot, including their parent tags. */
+    const FRTSTagBitset& GetOwnedTagBits(int32 Slot) const;
+
+    /** Gets the tags owned by the specified actor. */
+    const FGameplayTagContainer& GetOwnedTags(const AActor* Actor);
+
+    /** Gets the tags owned by the specified actor, including their parent tags. */
+    const FRTSTagBitset& GetOwnedTagBits(const AActor* Actor);
+
+    /** Discards the snapshot of the tags of the specified actor, e.g. because they have changed. */
+    void InvalidateActor(const AActor* Actor);
+
+private:
+    /** Tags owned by a single actor. */
+    struct FActorTags
+    {
+        FGameplayTagContainer OwnedTags;
+        FRTSTagBitset OwnedTagBits;
+
+        /** Whether the tags need to be copied from the ability system of the actor again. */
+        bool bIsOutdated;
+    };
+
+    /**
+     * Tags owned by all actors in the snapshot, by slot. Entries are reused across frames to avoid reallocating their
+     * tags. Using an indirect array to keep references stable when adding new slots.
+     */
+    TIndirectArray<FActorTags> ActorTags;
+
+    /** Number of entries of 'ActorTags' used in the current frame. */
+    int32 NumSlots;
+
+    /** Slots of all actors in the snapshot of the current frame. */
+    TMap<const AActor*, int32> ActorSlots;
+
+    /** Frame the snapshot has been taken in. */
+    uint64 SnapshotFrame;
+
+    /** Discards the snapshot of the previous frame, if this is a new frame. */
+    void ResetIfNewFrame();
+
+    /** Copies the tags from the ability system of the specified actor. */
+    void TakeSnapshot(const AActor* Actor, FActorTags& OutActorTags) const;
+};
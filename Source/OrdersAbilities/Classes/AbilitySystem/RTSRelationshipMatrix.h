@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "GenericTeamAgentInterface.h"
+#include "AbilitySystem/RTSTagBitset.h"
+
+class AActor;
+
+/**
+ * Relationship of an actor to another one, as bit flags. Each flag corresponds to one of the relationship tags.
+ */
+enum class ERTSRelationshipFlags : uint8
+{
+    NONE = 0,
+    FRIENDLY = 1 << 0,
+    HOSTILE = 1 << 1,
+    NEUTRAL = 1 << 2,
+    SAME_PLAYER = 1 << 3,
+    SELF = 1 << 4,
+    VISIBLE = 1 << 5,
+
+    /** Number of different combinations of the flags above. */
+    NUM_COMBINATIONS = 1 << 6
+};
+
+ENUM_CLASS_FLAGS(ERTSRelationshipFlags);
+
+/**
+ * Relationships between all pairs of teams, as provided by IGenericTeamAgentInterface. Each team is considered to be a
+ * single player. The relationship of a pair of teams is computed once and cached in a matrix, until team attitudes are
+ * changed. Tags and tag bitsets of all relationships are built up front, and again whenever the tag dictionary changes,
+ * so callers can reference them instead of building a new tag container for each pair of actors. Must only be used
+ * from the game thread.
+ */
+class ORDERSABILITIES_API FRTSRelationshipMatrix
+{
+public:
+    FRTSRelationshipMatrix();
+
+    /** Gets the matrix singleton. */
+    static FRTSRelationshipMatrix& Get();
+
+    /** Gets the relationship of the first actor to the other. */
+    ERTSRelationshipFlags GetRelationship(const AActor* Actor, const AActor* Other);
+
+    /** Gets the relationship of the first team to the other, without any actor specific flags like visibility. */
+    ERTSRelationshipFlags GetTeamRelationship(FGenericTeamId Team, FGenericTeamId OtherTeam);
+
+    /** Gets the team of the specified actor, or of the controller of the specified pawn. */
+    FGenericTeamId GetTeam(const AActor* Actor) const;
+
+    /** Gets the relationship tags of the first actor to the other. */
+    const FGameplayTagContainer& GetRelationshipTags(const AActor* Actor, const AActor* Other);
+
+    /** Gets the tags of the specified relationship. */
+    const FGameplayTagContainer& GetRelationshipTags(ERTSRelationshipFlags Relationship);
+
+    /** Gets the tags of the specified relationship, including their parent tags. */
+    const FRTSTagBitset& GetRelationshipTagBits(ERTSRelationshipFlags Relationship);
+
+    /** Gets the flags of all relationship tags in the specified container. */
+    ERTSRelationshipFlags GetRelationshipFlags(const FGameplayTagContainer& Tags);
+
+    /** Discards all cached relationships between teams, e.g. because teams have changed their attitude. */
+    void Invalidate();
+
+private:
+    /** Set for matrix entries that have been computed already. */
+    static const uint8 COMPUTED_FLAG = 1 << 7;
+
+    /** Number of different team ids. */
+    static const int32 NUM_TEAMS = 256;
+
+    /** Relationships of all pairs of teams, with 'COMPUTED_FLAG' set for entries that have been computed already. */
+    TArray<uint8> TeamRelationships;
+
+    /** Tags of all relationships, by relationship flags. */
+    TArray<FGameplayTagContainer> RelationshipTags;
+
+    /** Tags of all relationships including their parent tags, by relationship flags. */
+    TArray<FRTSTagBitset> RelationshipTagBits;
+
+    /** Generation of the tag dictionary 'RelationshipTags' and 'RelationshipTagBits' have been built for. */
+    uint32 RelationshipTagsGeneration;
+
+    /** Builds the tags and tag bitsets of all relationships, if the tag dictionary has changed since. */
+    void UpdateRelationshipTags();
+
+    /** Computes the relationship of the first team to the other. */
+    ERTSRelationshipFlags ComputeTeamRelationship(FGenericTeamId Team, FGenericTeamId OtherTeam) const;
+};
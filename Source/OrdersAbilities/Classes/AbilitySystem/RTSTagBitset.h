@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "GameplayTagContainer.h"
+
+/** Number of 64 bit words that are stored inline, enough for the first 512 gameplay tags. */
+#define RTS_TAG_BITSET_INLINE_WORDS 8
+
+/**
+ * Set of gameplay tags with one bit per tag, indexed by the network index of the tag in the gameplay tag dictionary.
+ * Checking tag requirements against these sets only takes a few bitwise operations per 64 tags, instead of searching
+ * tag containers tag by tag. Network indices change along with the dictionary, so bitsets that are kept around have to
+ * be rebuilt whenever 'GetDictionaryGeneration' changes.
+ */
+struct ORDERSABILITIES_API FRTSTagBitset
+{
+    /** Adds the specified tag, but not its parent tags. Used for tag requirements. */
+    void AddTag(const FGameplayTag& Tag);
+
+    /**
+     * Adds the specified tag along with all of its parent tags. Used for the tags of actors, so a required parent tag
+     * is satisfied by any of its child tags, like with FGameplayTagContainer::HasTag.
+     */
+    void AddTagWithParents(const FGameplayTag& Tag);
+
+    /** Adds all specified tags, but not their parent tags. */
+    void AddTags(const FGameplayTagContainer& Tags);
+
+    /** Adds all specified tags along with all of their parent tags. */
+    void AddTagsWithParents(const FGameplayTagContainer& Tags);
+
+    /** Adds all tags of the specified set to this one. */
+    void Append(const FRTSTagBitset& Other);
+
+    /** Removes all tags from this set, keeping the allocated memory. */
+    void Reset();
+
+    /** Whether this set does not contain any tags. */
+    bool IsEmpty() const;
+
+    /** Whether this set contains any of the tags of the specified set. */
+    bool HasAny(const FRTSTagBitset& Other) const;
+
+    /** Whether this set contains all of the tags of the specified set. */
+    bool HasAll(const FRTSTagBitset& Other) const;
+
+    /** Gets the number of times the gameplay tag dictionary has changed, e.g. because tags have been edited. */
+    static uint32 GetDictionaryGeneration();
+
+private:
+    /** One bit per tag. Words beyond the end of the array are considered to be zero. */
+    TArray<uint64, TInlineAllocator<RTS_TAG_BITSET_INLINE_WORDS>> Words;
+
+    /** Sets the bit of the specified tag, growing the set if necessary. */
+    void SetBit(const FGameplayTag& Tag);
+
+    /** Counts changes to the gameplay tag dictionary. */
+    static void OnGameplayTagTreeChanged();
+
+    /** Gets the number of times the gameplay tag dictionary has changed since it has first been checked. */
+    static uint32& GetDictionaryGenerationCounter();
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITypes.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "BTTask_RTSMoveTo.generated.h"
+
+class AAIController;
+
+struct FBTRTSMoveToTaskMemory
+{
+    /** Location the pawn is currently moving to directly, if following a flow field. */
+    FVector Waypoint;
+
+    /** Whether the pawn is following a flow field. */
+    uint8 bIsFollowingFlowField : 1;
+
+    /** Whether the pawn is moving directly towards the target location while its flow field is being built. */
+    uint8 bIsWaitingForFlowField : 1;
+};
+
+/**
+ * Moves the pawn to the location of the specified blackboard key. Pawns ordered to move as part of a large group
+ * follow the flow field built for their group by FRTSFlowFieldService, and only find a path on their own when getting
+ * close to their target location. While the flow field is still being built, they head towards their target location
+ * directly, and switch to the flow field as soon as it's ready.
+ */
+UCLASS()
+class ORDERSABILITIES_API UBTTask_RTSMoveTo : public UBTTask_BlackboardBase
+{
+    GENERATED_BODY()
+
+public:
+    UBTTask_RTSMoveTo(const FObjectInitializer& ObjectInitializer);
+
+    //~ Begin UBTTaskNode Interface
+    virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+    virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+    virtual void OnMessage(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message, int32 RequestID,
+                           bool bSuccess) override;
+    virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory,
+                                EBTNodeResult::Type TaskResult) override;
+    virtual uint16 GetInstanceMemorySize() const override;
+    virtual FString GetStaticDescription() const override;
+    //~ End UBTTaskNode Interface
+
+protected:
+    //~ Begin UBTTaskNode Interface
+    virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+    //~ End UBTTaskNode Interface
+
+private:
+    /** Distance to the target location at which the move succeeds. */
+    UPROPERTY(Category = RTS, EditAnywhere, meta = (ClampMin = 0))
+    float AcceptableRadius;
+
+    /** Maximum number of flow field cells to move straight ahead at once. */
+    UPROPERTY(Category = RTS, EditAnywhere, meta = (ClampMin = 1))
+    int32 FlowFieldLookAheadCells;
+
+    /** Distance to the target location at which the pawn stops following the flow field and finds a path instead. */
+    UPROPERTY(Category = RTS, EditAnywhere, meta = (ClampMin = 0))
+    float FlowFieldHandOffDistance;
+
+    /** Starts or continues moving towards the target location. */
+    EBTNodeResult::Type PerformMove(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory);
+
+    /** Moves towards the target location along a path found for the pawn alone. */
+    EBTNodeResult::Type MoveAlongPath(UBehaviorTreeComponent& OwnerComp, FBTRTSMoveToTaskMemory* Memory,
+                                      const FVector& TargetLocation);
+
+    /** Moves to the specified location in a straight line, without finding a path. */
+    FPathFollowingRequestResult MoveDirectly(AAIController* AIController, const FVector& Location) const;
+
+    /**
+     * Gets the next location to move to directly along the flow field of the pawn.
+     * @param[out] bOutIsWaitingForFlowField Whether the flow field of the pawn is still being built.
+     * @return Whether the pawn should follow a flow field.
+     */
+    bool GetFlowFieldWaypoint(const AAIController* AIController, const FVector& TargetLocation,
+                              FVector& OutWaypoint, bool& bOutIsWaitingForFlowField) const;
+};
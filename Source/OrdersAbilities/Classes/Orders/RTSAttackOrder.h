@@ -26,6 +26,7 @@ public:
 
     virtual float GetTargetScore(const AActor* OrderedActor, const FRTSOrderTargetData& TargetData,
                                  int32 Index) const override;
+    virtual bool SupportsParallelTargetScoring(const AActor* OrderedActor, int32 Index) const override;
     virtual bool AreAutoOrdersAllowedDuringOrder() const override;
     //~ End URTSOrder Interface
 };
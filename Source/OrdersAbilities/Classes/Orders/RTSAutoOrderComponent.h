@@ -2,11 +2,14 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "GameplayTagContainer.h"
 #include "Orders/RTSOrderTypeWithIndex.h"
 #include "Orders/RTSOrderData.h"
 #include "RTSAutoOrderComponent.generated.h"
 
 class APlayerState;
+class UAbilitySystemComponent;
+class URTSOrderComponent;
 
 /**
  * Manages the orders of a unit that should be issued automatically.
@@ -35,9 +38,36 @@ public:
 
     //~ Begin UActorComponent Interface
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     //~ End UActorComponent Interface
 
-    void CheckAutoOrders();
+    /** Issues the first enabled auto order that has a target. Returns whether any auto order has been issued. */
+    bool CheckAutoOrders();
+
+    /**
+     * Whether the unit is likely to find targets for its auto orders soon, because it has just found one or is busy
+     * with an order on a target actor.
+     */
+    bool IsInCombat() const;
+
+    /**
+     * Whether the unit doesn't need to check its auto orders until something relevant happens, because it hasn't found
+     * any targets when checking them last.
+     */
+    bool IsAsleep() const;
+
+    /** Makes the unit check its auto orders again, e.g. because a potential target has come close. */
+    void WakeUp();
+
+    /** Gets the largest acquisition radius of all auto orders of the unit. */
+    float GetMaxAcquisitionRadius();
+
+    /**
+     * Gets the mask of relationships other actors might be targets of any enabled auto order of the unit with, as
+     * derived from the target tag requirements of the orders. Bit n is set for the relationship flag combination n.
+     * Visibility is ignored, as it changes without actors moving.
+     */
+    uint64 GetTargetRelationshipMask();
 
 private:
     UFUNCTION()
@@ -46,9 +76,38 @@ private:
     UFUNCTION()
     void OnOwnerChanged(APlayerState* PreviousOwner, APlayerState* NewOwner);
 
-    bool IssueAutoOrder(const FRTSOrderTypeWithIndex& Order);
+    void OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+    /** Target most recently found for an auto order, to avoid searching for targets on every check. */
+    struct FCachedTarget
+    {
+        FCachedTarget();
+
+        TWeakObjectPtr<AActor> Target;
+
+        /** Score of 'Target' when it has been found. */
+        float Score;
+
+        /** Runner-up targets of the last full search, best first. */
+        TArray<TWeakObjectPtr<AActor>> FallbackTargets;
+
+        /** Game time of the last full target search, in seconds. */
+        float SearchTime;
+    };
+
+    /** Whether the auto order with the specified index is enabled to be issued automatically. */
+    bool IsAutoOrderEnabled(int32 OrderIndex) const;
+
+    bool IssueAutoOrder(const FRTSOrderTypeWithIndex& Order, FCachedTarget& CachedTarget);
     float GetAcquisitionRadius(const FRTSOrderTypeWithIndex& Order);
 
+    /**
+     * Finds a target for the specified auto order. Keeps the cached target until the next full search is due, as long
+     * as it stays valid and in range, falling back to the runner-ups of the last search otherwise. Full searches only
+     * switch to a new target if it scores sufficiently better.
+     */
+    AActor* FindTarget(const FRTSOrderTypeWithIndex& Order, float AcquisitionRadius, FCachedTarget& CachedTarget);
+
     /** Contains all orders that may be issued automatically with their associated index. */
     TArray<FRTSOrderTypeWithIndex> Orders;
 
@@ -65,4 +124,23 @@ private:
     TArray<bool> HumanPlayerAutoOrderStates;
 
     bool bCheckAutoOrders;
+
+    /** Whether an auto order has been issued when the auto orders have been checked last. */
+    bool bIssuedAutoOrderOnLastCheck;
+
+    /** Whether the unit waits for any relevant event before checking its auto orders again. */
+    bool bIsAsleep;
+
+    /** Target most recently found for each auto order. */
+    TArray<FCachedTarget> CachedTargets;
+
+    /** Order component of the owner the auto orders are issued to. */
+    UPROPERTY()
+    URTSOrderComponent* OrderComponent;
+
+    /** Ability system of the owner whose tag changes wake up the unit, e.g. when cooldowns expire. */
+    TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+
+    /** Handle of the delegate that is registered for tag changes of 'AbilitySystem'. */
+    FDelegateHandle GameplayTagChangedHandle;
 };
\ No newline at end of file
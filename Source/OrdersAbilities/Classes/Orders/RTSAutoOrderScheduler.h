@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include "Orders/RTSPerWorld.h"
+
+class AActor;
+class UWorld;
+class URTSAutoOrderComponent;
+
+/**
+ * Checks the auto orders of all registered units in round-robin fashion, spread across frames. Each frame, units are
+ * checked until the configured time budget is used up, starting with units in combat. Units that haven't found any
+ * targets are asleep and kept apart from the awake ones, so they don't cost anything per frame, until a potential
+ * target of their auto orders enters any spatial grid cell within their acquisition radius, they move themselves, they
+ * are woken up by their own events, or they have been asleep for too long. Potential targets might come in range
+ * without entering another cell, so units don't fall asleep while any of them is in these cells already. There is one
+ * scheduler per world, which runs at the start of each frame before any actor ticks. Must only be used from the game
+ * thread.
+ */
+class ORDERSABILITIES_API FRTSAutoOrderScheduler
+{
+public:
+    FRTSAutoOrderScheduler();
+    ~FRTSAutoOrderScheduler();
+
+    /**
+     * Gets the scheduler of the specified world, creating it if necessary. Schedulers are destroyed when their world
+     * is.
+     */
+    static FRTSAutoOrderScheduler* Get(UWorld* World);
+
+    /** Gets the scheduler of the specified world, or 'nullptr' if no unit has been added in that world yet. */
+    static FRTSAutoOrderScheduler* Find(const UWorld* World);
+
+    /** Starts checking the auto orders of the specified unit. */
+    void AddAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent);
+
+    /** Stops checking the auto orders of the specified unit. */
+    void RemoveAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent);
+
+    /** Starts checking the auto orders of the specified asleep unit again. Does nothing if the unit is awake. */
+    void WakeUpAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent);
+
+    /** Checks the auto orders of as many units as the time budget of a single frame allows. */
+    void Tick();
+
+private:
+    /** Unit whose auto orders are checked by the scheduler. */
+    struct FScheduledComponent
+    {
+        TWeakObjectPtr<URTSAutoOrderComponent> AutoOrderComponent;
+
+        /** Time the auto orders of the unit have been checked last, in seconds. */
+        double LastCheckTime;
+
+        /** Frame the auto orders of the unit have been checked last. */
+        uint64 LastCheckFrame;
+    };
+
+    /** Asleep unit, along with the spatial grid cells it watches. */
+    struct FSleepingComponent
+    {
+        /** Scheduling state of the unit, restored when it wakes up. */
+        FScheduledComponent ScheduledComponent;
+
+        /** Actor owning the auto order component. */
+        const AActor* Owner;
+
+        /** Spatial grid cells within the acquisition radius of the unit. */
+        TArray<FIntPoint> WatchedCells;
+
+        /** Relationships of actors that might be targets of the auto orders of the unit, as bits of their flags. */
+        uint64 TargetRelationshipMask;
+    };
+
+    /** Time an asleep unit has fallen asleep at. */
+    struct FSleepStart
+    {
+        TWeakObjectPtr<URTSAutoOrderComponent> AutoOrderComponent;
+
+        /** Time the unit has fallen asleep at, in seconds. Outdated if the unit has fallen asleep again since. */
+        double SleepTime;
+    };
+
+    /** Awake units that have been in combat when their auto orders have been checked last. */
+    TArray<FScheduledComponent> CombatComponents;
+
+    /** Awake units that have been out of combat when their auto orders have been checked last. */
+    TArray<FScheduledComponent> IdleComponents;
+
+    /** All asleep units. */
+    TMap<TWeakObjectPtr<URTSAutoOrderComponent>, FSleepingComponent> SleepingComponents;
+
+    /** Asleep units in the order they have fallen asleep, for waking them up after the maximum sleep time. */
+    TQueue<FSleepStart> SleepStarts;
+
+    /** Asleep units watching each spatial grid cell. */
+    TMap<FIntPoint, TArray<TWeakObjectPtr<URTSAutoOrderComponent>>> SleepingComponentsByCell;
+
+    /** Asleep units, by the actor owning them. */
+    TMap<const AActor*, TWeakObjectPtr<URTSAutoOrderComponent>> SleepingComponentsByOwner;
+
+    /** World whose spatial grid notifies the scheduler about actors entering cells. */
+    TWeakObjectPtr<UWorld> GridWorld;
+
+    /** Handle of the delegate that is registered for actors entering cells of the spatial grid of 'GridWorld'. */
+    FDelegateHandle ActorEnteredCellHandle;
+
+    /** Index of the next unit to check in 'CombatComponents'. */
+    int32 NextCombatIndex;
+
+    /** Index of the next unit to check in 'IdleComponents'. */
+    int32 NextIdleIndex;
+
+    /**
+     * Checks the auto orders of the awake units with the specified combat state, continuing at the specified index,
+     * until all of them have been checked or the specified time is reached. At least the specified number of units is
+     * checked, regardless of the time. Units whose state changes are moved to the list of their new state.
+     */
+    void CheckComponents(bool bInCombat, double EndTime, int32 MinChecks, int32& InOutNumChecked,
+                         float& InOutMaxStalenessMs);
+
+    /** Removes the specified unit from the specified list of awake units. Returns whether it has been in that list. */
+    bool RemoveAwakeComponent(TArray<FScheduledComponent>& Components, int32& NextIndex,
+                              const URTSAutoOrderComponent* AutoOrderComponent);
+
+    /** Wakes up all units that have been asleep for longer than the maximum sleep time. */
+    void WakeUpOversleptComponents(double Now);
+
+    /**
+     * Stops checking the specified unit until it is woken up. Returns whether the unit has fallen asleep, which it
+     * doesn't while any potential target is in the spatial grid cells within its acquisition radius.
+     */
+    bool PutToSleep(const FScheduledComponent& ScheduledComponent, URTSAutoOrderComponent* AutoOrderComponent);
+
+    /** Wakes up the specified unit as soon as a potential target enters any of its watched spatial grid cells. */
+    void StartWatchingCells(const TWeakObjectPtr<URTSAutoOrderComponent>& AutoOrderComponent,
+                            const FSleepingComponent& SleepingComponent);
+
+    /** Stops waking up the specified unit for actors entering spatial grid cells. */
+    void StopWatchingCells(const TWeakObjectPtr<URTSAutoOrderComponent>& AutoOrderComponent,
+                           const FSleepingComponent& SleepingComponent);
+
+    /** Checks whether the specified actor might be a target of the auto orders of the specified asleep unit. */
+    bool IsPotentialTarget(const FSleepingComponent& SleepingComponent, const AActor* Actor) const;
+
+    void OnActorEnteredCell(AActor* Actor, const FIntPoint& Cell);
+
+    static TRTSPerWorld<FRTSAutoOrderScheduler>& GetWorldSchedulers();
+    static void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+};
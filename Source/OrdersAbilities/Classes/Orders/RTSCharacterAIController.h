@@ -35,10 +35,6 @@ public:
     /** Issues this unit to obey the specified order. */
     void IssueOrder(const FRTSOrderData& Order, FRTSOrderCallback Callback, const FVector& HomeLocation);
 
-    //~ Begin AActor Interface
-    virtual void Tick(float DeltaTime) override;
-    //~ End AActor Interface
-
     UFUNCTION(Category = RTS, BlueprintPure)
     TSoftClassPtr<URTSStopOrder> GetStopOrder() const;
 
@@ -49,8 +45,26 @@ public:
     /** Gets the current units home location from the black board. */
     FVector GetHomeLocation();
 
+    /**
+     * Reports the result of the ended behavior tree to the current order. Called by FRTSOrderResultDispatcher in the
+     * frame after the behavior tree has ended.
+     */
+    void DispatchOrderResult();
+
+    //~ Begin AActor Interface
+    virtual void Tick(float DeltaSeconds) override;
+    //~ End AActor Interface
+
+    //~ Begin AAIController Interface
+    virtual void SetFocalPoint(FVector NewFocus,
+                               EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay) override;
+    virtual void SetFocus(AActor* NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay) override;
+    virtual void ClearFocus(EAIFocusPriority::Type InPriority) override;
+    //~ End AAIController Interface
+
 protected:
     virtual void Possess(APawn* InPawn) override;
+    virtual void UnPossess() override;
 
 private:
     /** Collision object types that are used to detect attack targets. */
@@ -76,6 +90,24 @@ private:
     /** Just used to cache the result of a behavior tree */
     EBTNodeResult::Type BehaviorTreeResult;
 
+    /** Whether an order has been issued before the behavior tree of this controller has been set up. */
+    bool bHasPendingOrder;
+
+    /** Order to apply as soon as the behavior tree of this controller has been set up. */
+    FRTSOrderData PendingOrder;
+
+    /** Home location of the order to apply as soon as the behavior tree of this controller has been set up. */
+    FVector PendingOrderHomeLocation;
+
+    /** Sets up the blackboard and behavior tree of this controller, after the stop order has been loaded. */
+    void InitializeOrderBehavior();
+
+    /**
+     * Ticks this controller only while it has a focus, which is the only time it needs to update its control rotation
+     * each frame.
+     */
+    void UpdateTickEnabled();
+
     void SetBlackboardValues(const FRTSOrderData& Order, const FVector& HomeLocation);
     void ApplyOrder(const FRTSOrderData& Order, UBehaviorTree* BehaviorTree);
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystem/RTSTagBitset.h"
+#include "Orders/RTSOrderTagRequirements.h"
+
+/**
+ * Tag requirements for an order, along with bitsets of the required and blocked tags that allow checking them
+ * without searching tag containers. The tag containers are still used for reporting missing and blocking tags.
+ */
+struct ORDERSABILITIES_API FRTSCompiledOrderTagRequirements : public FRTSOrderTagRequirements
+{
+    FRTSCompiledOrderTagRequirements();
+    explicit FRTSCompiledOrderTagRequirements(const FRTSOrderTagRequirements& InTagRequirements);
+
+    /** Bitset of 'SourceRequiredTags'. */
+    FRTSTagBitset SourceRequiredTagBits;
+
+    /** Bitset of 'SourceBlockedTags'. */
+    FRTSTagBitset SourceBlockedTagBits;
+
+    /** Bitset of 'TargetRequiredTags'. */
+    FRTSTagBitset TargetRequiredTagBits;
+
+    /** Bitset of 'TargetBlockedTags'. */
+    FRTSTagBitset TargetBlockedTagBits;
+
+    /** Rebuilds the bitsets from the tag containers. Needs to be called whenever the tag containers are changed. */
+    void Compile();
+
+    /** Checks if the specified ordered actor tags, including their parent tags, satisfy these requirements. */
+    bool DoesSatisfySourceRequirements(const FRTSTagBitset& SourceTags) const;
+
+    /** Checks if the specified target actor tags, including their parent tags, satisfy these requirements. */
+    bool DoesSatisfyTargetRequirements(const FRTSTagBitset& TargetTags) const;
+
+    /** Empty compiled tag requirements. */
+    static const FRTSCompiledOrderTagRequirements EMPTY_COMPILED_TAG_REQUIREMENTS;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ANavigationData;
+
+/**
+ * Directions towards a single destination for every location in a square region around it, built once from the
+ * navigation data. Units moving to the same destination can follow the field instead of finding paths on their own.
+ * The field is a grid centered on the destination. Cells are walkable if they can be projected to the navigation data,
+ * and neighboring cells are connected if the navigation data can be raycast between them. Each cell points to the next
+ * cell on its shortest path to the destination. Fields are built on the game thread, spread across several frames, so
+ * the navigation data is never queried while it's being updated.
+ */
+class ORDERSABILITIES_API FRTSFlowField
+{
+public:
+    FRTSFlowField(const FVector& InDestination, float InCellSize, int32 InHalfExtentInCells);
+
+    /**
+     * Continues building the field from the specified navigation data, until it has been built or the specified time
+     * is reached.
+     * @return Whether the field has been built.
+     */
+    bool Build(const ANavigationData* NavData, double EndTime);
+
+    /** Whether the field has been built completely. */
+    bool IsBuilt() const;
+
+    /** Whether the destination could be projected to the navigation data when building the field. */
+    bool IsValid() const;
+
+    /** Gets the location the field leads to. */
+    const FVector& GetDestination() const;
+
+    /** Gets the width and height of a single cell of the field, in world units. */
+    float GetCellSize() const;
+
+    /** Gets the number of cells between the destination cell and the border of the field. */
+    int32 GetHalfExtentInCells() const;
+
+    /** Gets the time spent on building the field so far, in seconds. */
+    double GetBuildTime() const;
+
+    /**
+     * Gets the location to move to from the specified location in order to reach the destination. Follows the field
+     * for up to the specified number of cells, as long as it goes straight, so units can move there directly.
+     * @return Whether the destination can be reached from the specified location.
+     */
+    bool GetWaypoint(const FVector& Location, int32 MaxCells, FVector& OutWaypoint) const;
+
+private:
+    /** Set for cells that could be projected to the navigation data. */
+    static const uint8 CELL_WALKABLE = 1 << 0;
+
+    /** Set for cells connected to their neighbor with the next higher X coordinate. */
+    static const uint8 CELL_OPEN_POSITIVE_X = 1 << 1;
+
+    /** Set for cells connected to their neighbor with the next higher Y coordinate. */
+    static const uint8 CELL_OPEN_POSITIVE_Y = 1 << 2;
+
+    /** Height of the box used for projecting cells to the navigation data. */
+    static const float PROJECTION_HEIGHT;
+
+    /** Number of cells to process between checking the time while building. */
+    static const int32 CELLS_PER_TIME_CHECK = 32;
+
+    /** Steps of building the field, in the order they are performed. */
+    enum class EBuildStep : uint8
+    {
+        PROJECT_CELLS,
+        CONNECT_CELLS,
+        FIND_PATHS,
+        DONE
+    };
+
+    /** Cell on the open list of the search for shortest paths, along with its cost. */
+    typedef TPair<float, int32> FOpenCell;
+
+    FVector Destination;
+    float CellSize;
+    int32 HalfExtentInCells;
+
+    /** Number of cells along each axis of the field. */
+    int32 NumCellsPerAxis;
+
+    /** Location of the corner of the field with the lowest coordinates. */
+    FVector Origin;
+
+    /** CELL_* flags of all cells. */
+    TArray<uint8> CellFlags;
+
+    /** Cell centers projected to the navigation data. */
+    TArray<FVector> CellLocations;
+
+    /** Index of the next cell on the shortest path to the destination, or INDEX_NONE, for all cells. */
+    TArray<int32> NextCells;
+
+    bool bIsValid;
+    double BuildTime;
+
+    /** Step of building the field to continue with. */
+    EBuildStep BuildStep;
+
+    /** Index of the cell to continue the current build step with. */
+    int32 NextBuildCell;
+
+    /** Costs of the shortest paths to the destination found so far, for all cells. Only used while building. */
+    TArray<float> Costs;
+
+    /** Cells whose neighbors still have to be checked for shorter paths. Only used while building. */
+    TArray<FOpenCell> OpenCells;
+
+    /** Projects the next cell centers to the navigation data. Returns whether all cells have been projected. */
+    bool ProjectCells(const ANavigationData* NavData, double EndTime);
+
+    /** Raycasts between the next neighboring cells. Returns whether all cells have been connected. */
+    bool ConnectCells(const ANavigationData* NavData, double EndTime);
+
+    /** Continues the search for shortest paths to the destination. Returns whether all paths have been found. */
+    bool FindPaths(double EndTime);
+
+    /** Gets the index of the cell with the specified coordinates, or INDEX_NONE if it's outside of the field. */
+    int32 GetCellIndex(int32 X, int32 Y) const;
+
+    /** Checks whether units can move directly between the specified cell and its specified neighbor. */
+    bool IsConnected(int32 X, int32 Y, int32 OffsetX, int32 OffsetY) const;
+
+    /** Checks whether the specified cell is connected to its neighbor with the specified X or Y offset. */
+    bool IsConnectedOrthogonally(int32 X, int32 Y, int32 OffsetX, int32 OffsetY) const;
+};
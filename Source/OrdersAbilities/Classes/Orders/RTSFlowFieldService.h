@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include "Orders/RTSPerWorld.h"
+
+class AActor;
+class ANavigationData;
+class FRTSFlowField;
+class UWorld;
+
+/**
+ * Builds flow fields for large groups of units moving to the same destination region, and assigns units to them.
+ * Fields are built on the game thread within a time budget per frame, and shared by all groups moving to the same
+ * region, until they haven't been used for a while. Must only be used from the game thread.
+ */
+class ORDERSABILITIES_API FRTSFlowFieldService
+{
+public:
+    FRTSFlowFieldService(UWorld* InWorld);
+    ~FRTSFlowFieldService();
+
+    /**
+     * Gets the service of the specified world, creating it if necessary. Services are destroyed when their world is.
+     */
+    static FRTSFlowFieldService* Get(UWorld* World);
+
+    /** Gets the service of the specified world, or 'nullptr' if no flow field has been requested in that world yet. */
+    static FRTSFlowFieldService* Find(const UWorld* World);
+
+    /**
+     * Makes the specified actors follow a flow field to the specified destination, building a new one if no field
+     * covering all of them is available for the region of the destination.
+     * @param Destination Location the whole group is moving to.
+     * @param Actors Actors to assign to the flow field.
+     * @param TargetLocations Individual target location of each actor.
+     */
+    void RequestFlowField(const FVector& Destination, const TArray<AActor*>& Actors,
+                          const TArray<FVector2D>& TargetLocations);
+
+    /**
+     * Gets the flow field assigned to the specified actor for moving to the specified target location.
+     * @param bOutIsBuilding Whether a flow field has been assigned, but is still being built. Not set anymore once the
+     *                       actor has been waiting for too long, so it can find a path on its own instead.
+     * @return The flow field, if it has been built already.
+     */
+    const FRTSFlowField* FindFlowField(const AActor* Actor, const FVector& TargetLocation, bool& bOutIsBuilding);
+
+    /** Stops the specified actor from following its flow field. */
+    void ReleaseActor(const AActor* Actor);
+
+private:
+    /** Flow field of a destination region. */
+    struct FFlowFieldEntry
+    {
+        FFlowFieldEntry();
+
+        TSharedPtr<FRTSFlowField> FlowField;
+
+        /** Game time the flow field has been requested at, in seconds. */
+        float RequestTime;
+
+        /** Game time the flow field has been used for the last time, in seconds. */
+        float LastUsedTime;
+    };
+
+    /** Flow field an actor is following. */
+    struct FAssignment
+    {
+        /** Region of the destination of the flow field. */
+        FIntPoint Region;
+
+        /** Location the actor is moving to. */
+        FVector2D TargetLocation;
+    };
+
+    UWorld* World;
+
+    /** Flow fields by destination region. */
+    TMap<FIntPoint, FFlowFieldEntry> FlowFields;
+
+    /** Flow fields of all actors. */
+    TMap<TWeakObjectPtr<const AActor>, FAssignment> Assignments;
+
+    /** Frame flow fields have been built in last. */
+    uint64 BuildFrame;
+
+    /** Time spent on building flow fields in 'BuildFrame', in seconds. */
+    double BuildTimeInFrame;
+
+    /** Gets the destination region of the specified location. */
+    FIntPoint GetRegion(const FVector& Location) const;
+
+    /** Gets the navigation data to build flow fields from. */
+    const ANavigationData* GetNavData() const;
+
+    /** Continues building unfinished flow fields, as long as the time budget of the current frame allows. */
+    void BuildFlowFields();
+
+    /** Discards flow fields that haven't been used for a while, and assignments of destroyed actors. */
+    void RemoveUnusedFlowFields();
+
+    /** Gets the services of all worlds. */
+    static TRTSPerWorld<FRTSFlowFieldService>& GetWorldServices();
+};
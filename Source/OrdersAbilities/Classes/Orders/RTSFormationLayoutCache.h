@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Tuple.h"
+#include "Orders/RTSFormationTemplate.h"
+
+/**
+ * Slot layouts of formation templates in the local frame of the formation, cached by template and unit count. Slots
+ * are centered around the origin, with X pointing to the side and Y pointing backwards, starting from the front line.
+ * Placing a formation just rotates and translates its cached layout. Must only be used from the game thread.
+ */
+class ORDERSABILITIES_API FRTSFormationLayoutCache
+{
+public:
+    FRTSFormationLayoutCache();
+
+    /** Gets the layout cache singleton. */
+    static FRTSFormationLayoutCache& Get();
+
+    /**
+     * Gets the local slots of the specified formation for the specified number of units, building them if necessary.
+     * The returned slots stay valid for as long as the caller holds on to them, even if the cache is reset meanwhile.
+     */
+    TSharedRef<const TArray<FVector2D>> GetLocalSlots(const FRTSFormationTemplate& Template, int32 UnitCount);
+
+    /**
+     * Rotates the specified local slots by the specified angle (in radians) and adds the specified location, two slots
+     * at a time.
+     */
+    static void TransformSlots(const TArray<FVector2D>& LocalSlots, float Angle, const FVector2D& Location,
+                               TArray<FVector2D>& OutSlots);
+
+    /** Discards all cached layouts. */
+    void Reset();
+
+private:
+    /** Maximum number of layouts to cache before discarding all of them. */
+    static const int32 MAX_CACHED_LAYOUTS = 256;
+
+    /** Cached layouts, by shape, unit count and unit spacing. */
+    TMap<TTuple<uint8, int32, float, float>, TSharedPtr<const TArray<FVector2D>>> Layouts;
+
+    /** Builds the local slots of the specified formation for the specified number of units. */
+    void BuildLayout(const FRTSFormationTemplate& Template, int32 UnitCount, TArray<FVector2D>& OutSlots) const;
+
+    void BuildBoxLayout(int32 UnitCount, int32 EdgeLengthX, const FVector2D& UnitSpacing,
+                        TArray<FVector2D>& OutSlots) const;
+    void BuildWedgeLayout(int32 UnitCount, const FVector2D& UnitSpacing, TArray<FVector2D>& OutSlots) const;
+    void BuildColumnLayout(int32 UnitCount, const FVector2D& UnitSpacing, TArray<FVector2D>& OutSlots) const;
+    void BuildRingLayout(int32 UnitCount, const FVector2D& UnitSpacing, TArray<FVector2D>& OutSlots) const;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+/** Shape of the formation units move into. All formations face the direction the units are moving to. */
+UENUM(BlueprintType)
+enum class ERTSFormationShape : uint8
+{
+    /** Square block of rows, with the last row centered if it is not full. */
+    BOX,
+
+    /** Single row. */
+    LINE,
+
+    /** Rows growing by one unit each, with the tip at the front. */
+    WEDGE,
+
+    /** Single file, one unit behind the other. */
+    COLUMN,
+
+    /** Single ring around the target location. */
+    RING
+};
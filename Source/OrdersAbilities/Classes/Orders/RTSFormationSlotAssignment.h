@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Orders/RTSFormationSlotAssignmentMode.h"
+
+/**
+ * Assigns the slots of a formation to the units moving into it, keeping the relative positions of the units as much as
+ * possible. Units and slots are both given relative to the center of their group.
+ */
+class ORDERSABILITIES_API FRTSFormationSlotAssignment
+{
+public:
+    /**
+     * Assigns each unit a different slot.
+     * @param UnitOffsets Locations of the units, relative to the center of the units.
+     * @param SlotOffsets Locations of the slots, relative to the center of the formation. Must contain as many slots as
+     *                    there are units.
+     * @param Direction Direction the formation faces to. Does not have to be normalized.
+     * @param Mode How to assign the slots.
+     * @param MaxUnitsForOptimalAssignment Number of units above which the optimal mode falls back to the sweep.
+     * @param[out] OutSlotIndices Index of the slot assigned to each unit.
+     */
+    static void AssignSlots(const TArray<FVector2D>& UnitOffsets, const TArray<FVector2D>& SlotOffsets,
+                            const FVector2D& Direction, ERTSFormationSlotAssignmentMode Mode,
+                            int32 MaxUnitsForOptimalAssignment, TArray<int32>& OutSlotIndices);
+
+    /**
+     * Assigns the slots row by row: Sorts units and slots along the formation direction, splits the units into rows of
+     * the same size as the rows of slots, and pairs units and slots of each row from left to right. O(n log n).
+     */
+    static void AssignSlotsBySweep(const TArray<FVector2D>& UnitOffsets, const TArray<FVector2D>& SlotOffsets,
+                                   const FVector2D& Direction, TArray<int32>& OutSlotIndices);
+
+    /**
+     * Assigns the slots minimizing the total squared distance between units and their slots, using the Hungarian
+     * algorithm. O(n^3).
+     */
+    static void AssignSlotsOptimally(const TArray<FVector2D>& UnitOffsets, const TArray<FVector2D>& SlotOffsets,
+                                     TArray<int32>& OutSlotIndices);
+
+    /** Gets the total squared distance between all units and their assigned slots. */
+    static float GetTotalCost(const TArray<FVector2D>& UnitOffsets, const TArray<FVector2D>& SlotOffsets,
+                              const TArray<int32>& SlotIndices);
+
+#if !UE_BUILD_SHIPPING
+    /** Logs the time and total cost of all modes for 50, 200 and 1000 randomly placed units. */
+    static void LogBenchmark();
+#endif
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+/** Describes how the slots of a formation are assigned to the units moving into it. */
+UENUM(BlueprintType)
+enum class ERTSFormationSlotAssignmentMode : uint8
+{
+    /**
+     * Sorts units and slots along the formation direction, and pairs them row by row from left to right. Scales well
+     * to large groups of units, but might cause some units to cross paths.
+     */
+    SWEEP,
+
+    /**
+     * Minimizes the total squared distance between the units and their slots, relative to the center of the group.
+     * Takes cubic time in the number of units, so larger groups of units fall back to the sweep.
+     */
+    OPTIMAL
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Orders/RTSFormationShape.h"
+#include "RTSFormationTemplate.generated.h"
+
+/**
+ * Describes the formation units move into. The slot layouts of templates are cached by FRTSFormationLayoutCache.
+ */
+USTRUCT(BlueprintType)
+struct ORDERSABILITIES_API FRTSFormationTemplate
+{
+    GENERATED_BODY()
+
+    FRTSFormationTemplate();
+
+    /** Shape of the formation. */
+    UPROPERTY(Category = RTS, EditDefaultsOnly, BlueprintReadWrite)
+    ERTSFormationShape Shape;
+
+    /** Space between two units in cm, side by side (X) and between rows (Y). */
+    UPROPERTY(Category = RTS, EditDefaultsOnly, BlueprintReadWrite)
+    FVector2D UnitSpacing;
+};
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "Orders/RTSCharacterAIOrder.h"
+#include "Orders/RTSFormationSlotAssignmentMode.h"
+#include "Orders/RTSFormationTemplate.h"
 #include "RTSMoveOrder.generated.h"
 
 class AActor;
@@ -25,9 +27,35 @@ public:
                                                  TArray<FVector2D>& OutTargetLocations) const override;
     //~ End URTSOrder Interface
 
+    /**
+     * Lets the specified actors share a flow field for moving to their individual target locations, if the group is
+     * large enough. Called when the order is actually issued to the group, so previews never build flow fields.
+     */
+    void RequestFlowField(const TArray<AActor*>& OrderedActors, const FRTSOrderTargetData& TargetData,
+                          const TArray<FVector2D>& TargetLocations) const;
+
 private:
+    /** Formation multiple units move into. */
+    UPROPERTY(Category = RTS, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+    FRTSFormationTemplate Formation;
+
+    /** How to assign the slots of the formation to the units of each formation rank. */
+    UPROPERTY(Category = RTS, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+    ERTSFormationSlotAssignmentMode SlotAssignmentMode;
+
+    /** Number of units of the same formation rank above which optimal slot assignment falls back to the sweep. */
+    UPROPERTY(Category = RTS, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true, ClampMin = 0))
+    int32 MaxUnitsForOptimalSlotAssignment;
+
+    /**
+     * Number of units from which on groups share a flow field for moving to their formation, instead of finding paths
+     * on their own. Requires their behavior tree to move with UBTTask_RTSMoveTo. 0 to never use flow fields.
+     */
+    UPROPERTY(Category = RTS, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true, ClampMin = 0))
+    int32 MinUnitsForFlowField;
+
     /**
-     * Creates a block formation of unit locations.
+     * Creates the formation of unit locations from the cached layout of the formation template.
      * @param UnitCount The required amount of locations.
      * @param Direction The direction the formation should face to. Does not have to be normalized.
      * @param TargetLocation Target location of the formation.
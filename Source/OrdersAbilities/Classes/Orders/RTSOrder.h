@@ -121,6 +121,13 @@ public:
      */
     virtual float GetTargetScore(const AActor* OrderedActor, const FRTSOrderTargetData& TargetData, int32 Index) const;
 
+    /**
+     * Whether 'IsValidTarget' and 'GetTargetScore' can be evaluated for several targets in parallel, off the game
+     * thread. This requires them to only read the target data, and the ordered and target actors, without calling into
+     * Blueprints. Disabled by default, so only orders that have been checked for this are scored in parallel.
+     */
+    virtual bool SupportsParallelTargetScoring(const AActor* OrderedActor, int32 Index) const;
+
     /**
      * Gets the group execution type of this order.
      */
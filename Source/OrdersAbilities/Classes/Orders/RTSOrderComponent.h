@@ -2,10 +2,17 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Orders/RTSCompiledOrderTagRequirements.h"
 #include "Orders/RTSOrderData.h"
+#include "Orders/RTSOrderIssueMode.h"
+#include "Orders/RTSOrderLifecycleTrace.h"
+#include "Orders/RTSOrderProcessPolicy.h"
 #include "Orders/RTSOrderResult.h"
+#include "Orders/RTSPendingOrder.h"
+#include "Orders/RTSReplicatedOrderQueue.h"
 #include "RTSOrderComponent.generated.h"
 
+class UAbilitySystemComponent;
 class URTSSelectableComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRTSOrderComponentOrderEnqueuedSignature, const FRTSOrderData&, Order);
@@ -25,8 +32,13 @@ public:
 
     //~ Begin UActorComponent Interface
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     //~ Begin UActorComponent Interface
 
+    //~ Begin UObject Interface
+    virtual void PostNetReceive() override;
+    //~ End UObject Interface
+
     void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
     /** Event when the actor has received a new order. */
@@ -39,6 +51,12 @@ public:
     /** Issues this unit to obey the specified order. */
     void IssueOrder(const FRTSOrderData& Order);
 
+    /**
+     * Issues this unit to obey the specified order, without checking whether the unit can obey it. Should only be
+     * used if the order has already been checked by the caller, e.g. when issuing an order to a whole group.
+     */
+    void IssueCheckedOrder(const FRTSOrderData& Order);
+
     /** Enqueues an order that will be issued to the unit if all other orders has succeeded. */
     void EnqueueOrder(const FRTSOrderData& Order);
 
@@ -64,6 +82,8 @@ public:
 
     FRTSOrderData GetCurrentOrderData() const;
 
+    /** Gets all orders that will be issued after the current order, starting with the next one. */
+    UFUNCTION(Category = RTS, BlueprintPure)
     TArray<FRTSOrderData> GetCurrentOrderDataQueue() const;
 
     /** Gets the target actor of the current order of this pawn. */
@@ -86,6 +106,27 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "RTS")
     FRTSOrderComponentOrderQueueClearedSignature OnOrderQueueCleared;
 
+    /**
+     * Records that the current order has reached the specified stage of its lifecycle, e.g. when the AI controller has
+     * applied it. Does nothing in shipping builds.
+     */
+    void TraceOrderLifecycleStage(ERTSOrderLifecycleStage Stage);
+
+    /**
+     * Gets the compiled tag requirements of the specified order for the owner of this component. Requirements are
+     * computed once per order type and index, and cached until the abilities of the owner or the gameplay tag
+     * dictionary change. The returned requirements stay valid for as long as the caller holds on to them, even if the
+     * cache is invalidated in the meantime, e.g. by an ability granted while checking the order.
+     */
+    TSharedRef<const FRTSCompiledOrderTagRequirements> GetTagRequirements(const URTSOrder* OrderObject,
+                                                                          int32 Index) const;
+
+    /**
+     * Gets the path that has been found to the target location of the current order while it was still queued, if it
+     * leads to the specified location and starts close to the owner. The path is handed out only once.
+     */
+    FNavPathSharedPtr ConsumePrefetchedPath(const FVector& TargetLocation);
+
 private:
     UPROPERTY(BlueprintReadOnly, Category = "RTS", ReplicatedUsing = ReceivedCurrentOrder,
               meta = (AllowPrivateAccess = true))
@@ -95,9 +136,16 @@ private:
               meta = (AllowPrivateAccess = true))
     FRTSOrderData LastOrder;
 
-    UPROPERTY(BlueprintReadOnly, Category = "RTS", ReplicatedUsing = ReceivedOrderQueue,
-              meta = (AllowPrivateAccess = true))
-    TArray<FRTSOrderData> OrderQueue;
+    /** Orders that will be issued after the current order has ended. */
+    UPROPERTY(Replicated)
+    FRTSReplicatedOrderQueue QueuedOrders;
+
+    /** Orders that have been passed to this unit while their order types were still being loaded. */
+    UPROPERTY()
+    TArray<FRTSPendingOrder> PendingOrders;
+
+    /** Whether 'PendingOrders' are currently being passed to this unit, after their order types have been loaded. */
+    bool bIsIssuingPendingOrders;
 
     UPROPERTY()
     TSoftClassPtr<URTSOrder> StopOrder;
@@ -127,6 +175,30 @@ private:
      */
     TMap<FGameplayTag, FDelegateHandle> RegisteredTargetTagEventHandles;
 
+    /** Ability system of the target the delegates in 'RegisteredTargetTagEventHandles' are registered on. */
+    TWeakObjectPtr<UAbilitySystemComponent> RegisteredTargetAbilitySystem;
+
+    /**
+     * Tag requirements of all orders that have been checked for the owner of this component, by order default object
+     * and index.
+     */
+    mutable TMap<TPair<const URTSOrder*, int32>, TSharedPtr<const FRTSCompiledOrderTagRequirements>>
+        CachedTagRequirements;
+
+    /** Generation of the gameplay tag dictionary 'CachedTagRequirements' have been compiled with. */
+    mutable uint32 CachedTagRequirementsGeneration;
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+    /** Times at which the most recent orders of this unit have reached each stage of their lifecycle. */
+    FRTSOrderLifecycleTrace LifecycleTrace;
+#endif
+
+    /** Id of the asynchronous path query for the next queued order, or INVALID_NAVQUERYID if none is running. */
+    uint32 PathPrefetchQueryId;
+
+    /** Target location of the order 'PathPrefetchQueryId' has been started for. */
+    FVector2D PathPrefetchLocation;
+
     /** Last order home location if set. */
     FVector LastOrderHomeLocation;
 
@@ -139,8 +211,25 @@ private:
     UFUNCTION()
     void ReceivedCurrentOrder();
 
-    UFUNCTION()
-    void ReceivedOrderQueue();
+    void IssueOrder(const FRTSOrderData& Order, bool bIsOrderChecked);
+
+    /** Streams in all order types this unit is likely to use, without blocking the game thread. */
+    void PreloadOrderTypes();
+
+    /**
+     * Stores the specified order as pending and starts loading its order type, if the type is not loaded yet or other
+     * orders are still pending. Returns whether the order has been deferred.
+     */
+    bool DeferOrderUntilLoaded(const FRTSOrderData& Order, ERTSOrderIssueMode IssueMode);
+
+    /** Passes all pending orders to this unit whose order types have been loaded, in the order they were issued. */
+    void OnPendingOrderTypesLoaded();
+
+    /**
+     * Drops all pending orders of the specified order type if it couldn't be loaded, so they don't block the orders
+     * issued after them, and passes the remaining pending orders to this unit.
+     */
+    void OnPendingOrderTypeLoaded(FSoftObjectPath OrderTypePath);
 
     void ObeyOrder(const FRTSOrderData& Order);
     bool CheckOrder(const FRTSOrderData& Order) const;
@@ -151,8 +240,23 @@ private:
 
     void OrderEnded(ERTSOrderResult OrderResult);
     void OrderCanceled();
-    void RegisterTagListeners(const FRTSOrderData& Order);
-    void UnregisterTagListeners(const FRTSOrderData& Order);
+    ERTSOrderProcessPolicy GetOrderProcessPolicy(const FRTSOrderData& Order) const;
+
+    TSharedRef<const FRTSCompiledOrderTagRequirements> GetTagRequirements(const FRTSOrderData& Order) const;
+
+    /** Discards all cached tag requirements, e.g. because abilities have been granted or leveled up. */
+    void InvalidateTagRequirements();
+
+    /**
+     * Makes sure delegates are registered for exactly the tags that can cancel the specified order. Delegates for tags
+     * that are shared with the previous order are kept.
+     */
+    void UpdateTagListeners(const FRTSOrderData& Order);
+
+    /** Adds and removes tag event delegates on the specified ability system to match the specified tags. */
+    void UpdateTagEventHandles(UAbilitySystemComponent* AbilitySystem, const FGameplayTagContainer& Tags,
+                               TMap<FGameplayTag, FDelegateHandle>& TagEventHandles,
+                               void (URTSOrderComponent::*Callback)(const FGameplayTag, int32));
 
     UFUNCTION()
     void OnTargetTagsChanged(const FGameplayTag Tag, int32 NewCount);
@@ -162,6 +266,18 @@ private:
 
     void ObeyStopOrder();
 
+    /**
+     * Starts finding a path from the target location of the current order to the one of the next queued move order
+     * in the background, unless already done.
+     */
+    void PrefetchNextPath();
+
+    /** Stops finding a path for the next queued order. */
+    void AbortPathPrefetch();
+
+    /** Caches the path found for the next queued order on that order. */
+    void OnPathPrefetched(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
     AActor* CreateOrderPreviewActor(const FRTSOrderData& Order);
 
     UFUNCTION()
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AI/Navigation/NavigationTypes.h"
 #include "Orders/RTSOrder.h"
 #include "RTSOrderData.generated.h"
 
 class AActor;
+struct FRTSResolvedOrderType;
 
 /**
  * An order that can be issued to units and buildings.
@@ -46,13 +48,41 @@ struct ORDERSABILITIES_API FRTSOrderData
     UPROPERTY(Category = RTS, EditAnywhere, BlueprintReadWrite)
     int32 Index;
 
+    /**
+     * Handle of the resolved order type, cached by FRTSOrderTypeRegistry to avoid resolving the soft class pointer
+     * again. Not replicated.
+     */
+    mutable const FRTSResolvedOrderType* ResolvedOrderType;
+
+    /**
+     * Path to the target location of this order, found while the order was still queued behind another one. Cached by
+     * URTSOrderComponent, so the order doesn't have to wait for a path when it becomes current. Not replicated.
+     */
+    FNavPathSharedPtr PrefetchedPath;
+
     /**
      * Get a textual representation of this order.
      * @return A string describing the order.
      */
     FString ToString() const;
 
+    /**
+     * Serializes this order for replication. The order type is sent as class reference through the package map, the
+     * location is quantized to the precision set by 'RTS.Net.OrderLocationPrecision' (or sent as it is if too far away
+     * for that precision) and omitted if not used, and the index is sent with variable length encoding.
+     */
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
     bool operator==(const FRTSOrderData& Other) const;
 
     bool operator!=(const FRTSOrderData& Other) const;
+};
+
+template <>
+struct TStructOpsTypeTraits<FRTSOrderData> : public TStructOpsTypeTraitsBase2<FRTSOrderData>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "GameplayTagContainer.h"
 #include "Text.h"
 #include "Vector2D.h"
+#include "Orders/RTSCompiledOrderTagRequirements.h"
 #include "Orders/RTSOrder.h"
 #include "Orders/RTSOrderData.h"
 #include "Orders/RTSOrderErrorTags.h"
@@ -17,6 +18,7 @@
 class AActor;
 class UTexture2D;
 class URTSOrderWithBehavior;
+struct FRTSScoredTarget;
 
 /**
  * Helper functions for accessing the default objects of order classes.
@@ -40,6 +42,14 @@ public:
     static bool CanObeyOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor, int32 Index,
                              FRTSOrderErrorTags* OutErrorTags);
 
+    /**
+     * Whether the specified actor can obey the order with the specified default object. Uses the passed compiled tag
+     * requirements instead of querying them from the order, if specified.
+     */
+    static bool CanObeyOrder(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                             FRTSOrderErrorTags* OutErrorTags,
+                             const FRTSCompiledOrderTagRequirements* TagRequirements = nullptr);
+
     /** Whether the specified actor and/or location is a valid target for this order. */
     UFUNCTION(Category = "RTS Order", BlueprintPure)
     static bool IsValidTarget(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -55,6 +65,14 @@ public:
     static bool IsValidTarget(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
                               const FRTSOrderTargetData& TargetData, int32 Index, FRTSOrderErrorTags* OutErrorTags);
 
+    /**
+     * Whether the specified actor and/or location is a valid target for the specified order default object. Uses the
+     * passed compiled tag requirements instead of querying them from the order, if specified.
+     */
+    static bool IsValidTarget(const URTSOrder* Order, const AActor* OrderedActor, const FRTSOrderTargetData& TargetData,
+                              int32 Index, FRTSOrderErrorTags* OutErrorTags,
+                              const FRTSCompiledOrderTagRequirements* TagRequirements = nullptr);
+
     /** Creates individual target locations for the group of actors. */
     UFUNCTION(Category = "RTS Order", BlueprintPure)
     static void CreateIndividualTargetLocations(TSoftClassPtr<URTSOrder> OrderType,
@@ -66,6 +84,14 @@ public:
     UFUNCTION(Category = "RTS Order", BlueprintCallable)
     static void IssueOrder(AActor* OrderedActor, const FRTSOrderData& Order);
 
+    /**
+     * Issues all specified actors to obey this order on the specified target. The order type is resolved once for the
+     * whole group, all actors are validated in a single pass and the group execution type of the order is respected.
+     * The first valid actor is considered to be the main selected unit.
+     */
+    UFUNCTION(Category = "RTS Order", BlueprintCallable)
+    static void IssueOrderToGroup(const TArray<AActor*>& OrderedActors, const FRTSOrderData& Order);
+
     /** Clears the order of the specified actor. Should probably only be used if queuing orders immediately after. */
     UFUNCTION(Category = "RTS Order", BlueprintCallable)
     static void ClearOrderQueue(AActor* OrderedActor);
@@ -267,6 +293,24 @@ public:
                                                      int32 Index, float AcquisitionRadius, float ChaseDistance,
                                                      const FVector& OrderedActorHomeLocation, float& OutScore);
 
+    /**
+     * Checks whether the specified target, found for the specified order before, is still valid and inside the
+     * acquisition radius, and scores it again. Much cheaper than searching for a new target, because the tag
+     * requirements are checked against the tag bitsets of the current frame.
+     * @param Order                     The order default object.
+     * @param OrderedActor              The ordered actor
+     * @param Index                     Order index. This is needed for certain orders to differentiate. Default '-1'.
+     * @param Target                    The target to check.
+     * @param AcquisitionRadius         Max distance from the ordered actor to the target.
+     * @param TagRequirements           Compiled tag requirements of the order for the ordered actor.
+     * @param OutScore                  Score of the target if it is still valid.
+     * @return                          Whether the target is still valid and has a positive score, as required for
+     *                                  new targets.
+     */
+    static bool RevalidateTargetForOrder(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                         AActor* Target, float AcquisitionRadius,
+                                         const FRTSCompiledOrderTagRequirements& TagRequirements, float& OutScore);
+
     /**
      * Finds the most suitable actor to obey the specified order.
      * @param OrderType                 The order type.
@@ -313,4 +357,22 @@ public:
      */
     static AActor* FindBestScoredTargetForOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
                                                 const TArray<AActor*> Targets, int32 Index, float& OutScore);
+
+    /**
+     * Finds the best matching targets for the specified order, best first. Checks the tag requirements against the tag
+     * bitsets of the current frame, before checking and scoring the remaining targets, in parallel if there are many of
+     * them. Only targets with a positive score are considered.
+     * @param Order                     The order default object.
+     * @param OrderedActor              The ordered actor
+     * @param Index                     Order index. This is needed for certain orders to differentiate. Default '-1'.
+     * @param Targets                   All potential target actors.
+     * @param TagRequirements           Compiled tag requirements of the order for the ordered actor.
+     * @param MaxTargets                Maximum number of targets to find.
+     * @param OutTargets                Best targets along with their scores, best first. Targets with the same score
+     *                                  keep their order in 'Targets'.
+     */
+    static void FindBestScoredTargetsForOrder(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                              const TArray<AActor*>& Targets,
+                                              const FRTSCompiledOrderTagRequirements& TagRequirements,
+                                              int32 MaxTargets, TArray<FRTSScoredTarget>& OutTargets);
 };
@@ -0,0 +1,20 @@
+#pragma once
+
+/**
+ * Describes how an order is passed to the order component of a unit.
+ */
+UENUM()
+enum class ERTSOrderIssueMode : uint8
+{
+    /** The order replaces the current order and clears the order queue. */
+    ISSUE,
+
+    /** The order is added to the end of the order queue. */
+    ENQUEUE,
+
+    /** The order is issued when the current order has succeeded. */
+    INSERT_AFTER_CURRENT_ORDER,
+
+    /** The order is issued immediately. The current order will be issued again when this order finishes. */
+    INSERT_BEFORE_CURRENT_ORDER,
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Whether the lifecycle of orders is traced. Tracing is compiled out of shipping builds. */
+#define RTS_ORDER_LIFECYCLE_TRACE !UE_BUILD_SHIPPING
+
+/** Number of orders each order component remembers the lifecycle of. */
+#define RTS_ORDER_LIFECYCLE_TRACE_CAPACITY 16
+
+/** Maximum number of latency samples that are aggregated per order type and lifecycle stage. */
+#define RTS_ORDER_LIFECYCLE_MAX_SAMPLES 1024
+
+/**
+ * Stages an order passes through, from being issued until it has ended.
+ */
+enum class ERTSOrderLifecycleStage : uint8
+{
+    /** The order has been issued to the order component. */
+    ISSUED,
+
+    /** The order component has checked whether the unit can obey the order. */
+    CHECKED,
+
+    /** The order component has passed the order to the order type. */
+    OBEYED,
+
+    /** The AI controller has applied the order, and its behavior tree is running. */
+    APPLIED,
+
+    /** The order has succeeded, failed, or has been canceled. */
+    ENDED,
+
+    NUM
+};
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+
+/**
+ * Times at which a single order has reached each stage of its lifecycle.
+ */
+struct ORDERSABILITIES_API FRTSOrderLifecycleRecord
+{
+    FRTSOrderLifecycleRecord();
+
+    /** Name of the order type. */
+    FName OrderType;
+
+    /** Time at which the order has reached each stage, in seconds. Zero if the order hasn't reached the stage. */
+    double StageTimes[(int32)ERTSOrderLifecycleStage::NUM];
+
+    /** Whether this record has been added to the global statistics, and further stages are ignored. */
+    bool bIsClosed;
+};
+
+/**
+ * Fixed-size ring buffer of the lifecycles of the most recent orders of a single unit. The record of the current order
+ * is updated as the order reaches new stages, and added to the global order lifecycle statistics when it's closed.
+ * Must only be used from the game thread.
+ */
+class ORDERSABILITIES_API FRTSOrderLifecycleTrace
+{
+public:
+    FRTSOrderLifecycleTrace();
+
+    /** Closes the record of the current order, and starts a new one at the specified stage. */
+    void BeginOrder(FName OrderType, ERTSOrderLifecycleStage Stage);
+
+    /**
+     * Records that the current order has reached the specified stage, if it hasn't been closed yet. Stages that have
+     * already been reached are not recorded again.
+     */
+    void MarkStage(ERTSOrderLifecycleStage Stage);
+
+    /**
+     * Records that the current order has reached the specified stage, if it's of the specified type and hasn't reached
+     * the stage yet. Otherwise, starts a new record at that stage, e.g. for orders that have been queued.
+     */
+    void MarkStage(FName OrderType, ERTSOrderLifecycleStage Stage);
+
+    /** Records that the current order has ended, and closes its record. */
+    void EndOrder();
+
+    /** Gets the record of the current order, or 'nullptr' if there is no current order or it has been closed. */
+    const FRTSOrderLifecycleRecord* GetCurrentRecord() const;
+
+    /** Gets the recorded orders, starting with the most recent one. */
+    void GetRecords(TArray<FRTSOrderLifecycleRecord>& OutRecords) const;
+
+private:
+    /** Most recent orders of the unit. */
+    FRTSOrderLifecycleRecord Records[RTS_ORDER_LIFECYCLE_TRACE_CAPACITY];
+
+    /** Total number of orders that have been recorded. The current record is at this number minus one. */
+    int32 NumRecords;
+
+    /** Gets the record of the current order, if it hasn't been closed yet. */
+    FRTSOrderLifecycleRecord* FindOpenRecord();
+
+    /** Closes the record of the current order, and adds it to the global statistics. */
+    void CloseCurrentRecord();
+};
+
+/**
+ * Process-wide latencies between the lifecycle stages of all orders, by order type. Must only be used from the game
+ * thread.
+ */
+class ORDERSABILITIES_API FRTSOrderLifecycleStats
+{
+public:
+    /** Gets the statistics singleton. */
+    static FRTSOrderLifecycleStats& Get();
+
+    /** Adds the latencies between all stages of the specified order that have been reached. */
+    void AddRecord(const FRTSOrderLifecycleRecord& Record);
+
+    /** Logs the 50th, 95th and 99th percentile of the latencies of each stage, by order type. */
+    void DumpLatencies() const;
+
+    /** Discards all latencies. */
+    void Reset();
+
+private:
+    /**
+     * Latest latencies between each stage and the previous stage that has been reached, of all orders of a single
+     * type, in milliseconds.
+     */
+    struct FOrderTypeLatencies
+    {
+        TArray<float> Samples[(int32)ERTSOrderLifecycleStage::NUM];
+        int32 NumSamples[(int32)ERTSOrderLifecycleStage::NUM] = {};
+    };
+
+    TMap<FName, FOrderTypeLatencies> LatenciesByOrderType;
+};
+
+#endif
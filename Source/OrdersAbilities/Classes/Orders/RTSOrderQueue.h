@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "Orders/RTSOrderData.h"
+#include "RTSOrderQueue.generated.h"
+
+class FReferenceCollector;
+
+/** Number of queued orders that are stored inline before the queue needs to allocate memory. */
+#define RTS_ORDER_QUEUE_INLINE_CAPACITY 8
+
+/**
+ * Double ended queue of orders with constant time push and pop at both ends. The orders are stored in a ring buffer
+ * whose capacity is always a power of two. The first few orders are stored inline.
+ */
+USTRUCT()
+struct ORDERSABILITIES_API FRTSOrderQueue
+{
+    GENERATED_BODY()
+
+    FRTSOrderQueue();
+
+    /** Gets the number of orders in this queue. */
+    int32 Num() const;
+
+    /** Whether this queue does not contain any orders. */
+    bool IsEmpty() const;
+
+    /** Whether the specified index refers to an order in this queue. */
+    bool IsValidIndex(int32 Index) const;
+
+    /** Gets the order at the specified position. '0' is the order that will be issued next. */
+    const FRTSOrderData& operator[](int32 Index) const;
+
+    /** Gets the order that will be issued next. */
+    const FRTSOrderData& First() const;
+
+    /** Gets the order that will be issued next, for caching data with it that isn't part of the order itself. */
+    FRTSOrderData& First();
+
+    /** Gets the order that will be issued last. */
+    const FRTSOrderData& Last() const;
+
+    /** Adds the specified order to the end of this queue. */
+    void PushBack(const FRTSOrderData& Order);
+
+    /** Adds the specified order to the front of this queue. */
+    void PushFront(const FRTSOrderData& Order);
+
+    /** Removes the order at the front of this queue. */
+    void PopFront();
+
+    /** Removes all orders from this queue, keeping the allocated memory. */
+    void Reset();
+
+    /** Copies all orders to the specified array, starting with the order that will be issued next. */
+    void ToArray(TArray<FRTSOrderData>& OutOrders) const;
+
+    /** Replaces the contents of this queue with the specified orders. */
+    void FromArray(const TArray<FRTSOrderData>& Orders);
+
+    /** Reports the target actors of all queued orders to the garbage collector. */
+    void AddStructReferencedObjects(FReferenceCollector& Collector) const;
+
+private:
+    /** Ring buffer storage. Its size is always zero or a power of two. */
+    TArray<FRTSOrderData, TInlineAllocator<RTS_ORDER_QUEUE_INLINE_CAPACITY>> Slots;
+
+    /** Slot of the order at the front of this queue. */
+    int32 Head;
+
+    /** Number of orders in this queue. */
+    int32 Count;
+
+    /** Gets the slot of the order at the specified position. */
+    int32 GetSlotIndex(int32 Index) const;
+
+    /** Doubles the capacity of the ring buffer, moving all orders to the start of the storage. */
+    void Grow();
+};
+
+template <>
+struct TStructOpsTypeTraits<FRTSOrderQueue> : public TStructOpsTypeTraitsBase2<FRTSOrderQueue>
+{
+    enum
+    {
+        WithAddStructReferencedObjects = true,
+    };
+};
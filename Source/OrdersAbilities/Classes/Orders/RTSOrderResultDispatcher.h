@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include "Orders/RTSPerWorld.h"
+
+class ARTSCharacterAIController;
+class UWorld;
+
+/**
+ * Reports the results of ended behavior trees of AI controllers to their orders, deferred to the start of the next
+ * frame before any actor ticks. This way, controllers don't need to tick just for checking whether their behavior tree
+ * has ended, and orders are never ended from within the behavior tree that is executing them. Must only be used from
+ * the game thread.
+ */
+class ORDERSABILITIES_API FRTSOrderResultDispatcher
+{
+public:
+    /**
+     * Gets the dispatcher of the specified world, creating it if necessary. Dispatchers are destroyed when their world
+     * is.
+     */
+    static FRTSOrderResultDispatcher* Get(UWorld* World);
+
+    /** Gets the dispatcher of the specified world, or 'nullptr' if no result has been scheduled in that world yet. */
+    static FRTSOrderResultDispatcher* Find(const UWorld* World);
+
+    /** Reports the behavior tree result of the specified controller at the start of the next frame. */
+    void ScheduleOrderResult(ARTSCharacterAIController* Controller);
+
+    /** Reports the behavior tree results of all controllers that have been scheduled before. */
+    void DispatchOrderResults();
+
+private:
+    /** Controllers whose behavior tree results have to be reported in the next frame. */
+    TArray<TWeakObjectPtr<ARTSCharacterAIController>> ScheduledControllers;
+
+    static TRTSPerWorld<FRTSOrderResultDispatcher>& GetWorldDispatchers();
+    static void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+};
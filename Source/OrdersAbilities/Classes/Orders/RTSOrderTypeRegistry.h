@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/IndirectArray.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/GCObject.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/SoftObjectPtr.h"
+
+class UClass;
+class URTSOrder;
+struct FRTSOrderData;
+
+/**
+ * Order type whose class has been loaded, along with its default object.
+ */
+struct ORDERSABILITIES_API FRTSResolvedOrderType
+{
+    /** Path of the order class. */
+    FSoftObjectPath Path;
+
+    /** Loaded order class. */
+    UClass* Class;
+
+    /** Default object of the order class. */
+    const URTSOrder* DefaultObject;
+};
+
+/**
+ * Process-wide registry of all order types that have been resolved so far. Resolved order types are never removed
+ * again, so handles returned by the registry stay valid for the lifetime of the process. Must only be used from the
+ * game thread.
+ */
+class ORDERSABILITIES_API FRTSOrderTypeRegistry : public FGCObject
+{
+public:
+    /** Gets the registry singleton. */
+    static FRTSOrderTypeRegistry& Get();
+
+    /** Resolves the specified order type, loading its class if necessary. Returns 'nullptr' if it can't be loaded. */
+    const FRTSResolvedOrderType* Resolve(const FSoftObjectPath& OrderTypePath);
+
+    /** Gets the default object of the specified order type, loading its class if necessary. */
+    const URTSOrder* GetDefaultObject(const TSoftClassPtr<URTSOrder>& OrderType);
+
+    /**
+     * Gets the default object of the type of the specified order, loading its class if necessary. Uses the handle
+     * cached with the order, if it still refers to the order type of the order.
+     */
+    const URTSOrder* GetDefaultObject(const FRTSOrderData& Order);
+
+    /** Whether the class of the specified order type is in memory, so it can be resolved without blocking. */
+    bool IsLoaded(const FSoftObjectPath& OrderTypePath) const;
+
+    /**
+     * Loads the classes of the specified order types through the streamable manager without blocking the game thread,
+     * and resolves them when done. The delegate is executed when all order types have been loaded. It's executed
+     * immediately if all of them are loaded already.
+     */
+    void LoadAsync(const TArray<FSoftObjectPath>& OrderTypePaths, FStreamableDelegate OnLoaded);
+
+    //~ Begin FGCObject Interface
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+    //~ End FGCObject Interface
+
+private:
+    /** All order types resolved so far. Using an indirect array to keep handles stable when adding new ones. */
+    TIndirectArray<FRTSResolvedOrderType> ResolvedOrderTypes;
+
+    /** Maps order type paths to their index in 'ResolvedOrderTypes'. */
+    TMap<FSoftObjectPath, int32> ResolvedOrderTypeIndices;
+
+    /** Streams in order classes asynchronously. */
+    FStreamableManager StreamableManager;
+
+    /** Resolves the specified order types after they have been streamed in, and notifies the requester. */
+    void OnAsyncLoadCompleted(TArray<FSoftObjectPath> OrderTypePaths, FStreamableDelegate OnLoaded);
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Orders/RTSOrderData.h"
+#include "Orders/RTSOrderIssueMode.h"
+#include "RTSPendingOrder.generated.h"
+
+/**
+ * An order that has been passed to a unit before its order type has been loaded.
+ */
+USTRUCT()
+struct ORDERSABILITIES_API FRTSPendingOrder
+{
+    GENERATED_BODY()
+
+    FRTSPendingOrder();
+    FRTSPendingOrder(const FRTSOrderData& InOrder, ERTSOrderIssueMode InIssueMode);
+
+    /** Order to pass to the unit when its order type has been loaded. */
+    UPROPERTY()
+    FRTSOrderData Order;
+
+    /** How to pass the order to the unit. */
+    UPROPERTY()
+    ERTSOrderIssueMode IssueMode;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * Holds one object of the specified type per world, creating it on first use and destroying it when its world is
+ * cleaned up. Meant to be kept in a function-local static by the owning class, for objects that have to exist in
+ * every world, even ones without an AOrdersAbilitiesGameMode (e.g. on clients). Must only be used from the game thread.
+ */
+template <typename T>
+class TRTSPerWorld
+{
+public:
+    /**
+     * Gets the object of the specified world, creating it from the specified constructor arguments if necessary.
+     * Returns 'nullptr' for 'nullptr' worlds.
+     */
+    template <typename... ArgTypes>
+    T* FindOrAdd(const UWorld* World, ArgTypes&&... Args)
+    {
+        check(IsInGameThread());
+
+        if (World == nullptr)
+        {
+            return nullptr;
+        }
+
+        TUniquePtr<T>* ExistingObject = Objects.Find(World);
+        if (ExistingObject != nullptr)
+        {
+            return ExistingObject->Get();
+        }
+
+        // Destroy objects along with their worlds. Never unbound, as the holder lives as long as the process.
+        if (!WorldCleanupHandle.IsValid())
+        {
+            WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &TRTSPerWorld::OnWorldCleanup);
+        }
+
+        TUniquePtr<T>& Object = Objects.Add(World, MakeUnique<T>(Forward<ArgTypes>(Args)...));
+        return Object.Get();
+    }
+
+    /** Gets the object of the specified world, or 'nullptr' if none has been created yet. */
+    T* Find(const UWorld* World) const
+    {
+        check(IsInGameThread());
+
+        const TUniquePtr<T>* ExistingObject = Objects.Find(World);
+        return ExistingObject != nullptr ? ExistingObject->Get() : nullptr;
+    }
+
+private:
+    /** Objects by world. */
+    TMap<const UWorld*, TUniquePtr<T>> Objects;
+
+    /** Handle of the binding to 'FWorldDelegates::OnWorldCleanup', once the first object has been created. */
+    FDelegateHandle WorldCleanupHandle;
+
+    /** Destroys the object of the specified world. */
+    void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+    {
+        Objects.Remove(World);
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Orders/RTSOrderData.h"
+#include "Orders/RTSOrderQueue.h"
+#include "RTSReplicatedOrderQueue.generated.h"
+
+struct FRTSReplicatedOrderQueue;
+
+/**
+ * Single order of a replicated order queue.
+ */
+USTRUCT()
+struct ORDERSABILITIES_API FRTSReplicatedOrder : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    FRTSReplicatedOrder();
+    FRTSReplicatedOrder(const FRTSOrderData& InOrder, int32 InSequenceNumber);
+
+    /** Queued order. */
+    UPROPERTY()
+    FRTSOrderData Order;
+
+    /**
+     * Position of the order in the queue. Fast arrays don't preserve the order of their items, so clients sort the
+     * orders by this.
+     */
+    UPROPERTY()
+    int32 SequenceNumber;
+
+    void PreReplicatedRemove(const FRTSReplicatedOrderQueue& InArraySerializer);
+    void PostReplicatedAdd(const FRTSReplicatedOrderQueue& InArraySerializer);
+    void PostReplicatedChange(const FRTSReplicatedOrderQueue& InArraySerializer);
+};
+
+/**
+ * Order queue that is replicated with delta serialization, so only orders that have been added, removed or changed
+ * are sent to clients, instead of the whole queue. Keeps a local copy of the orders in the correct order for reading,
+ * so the replicated items never have to be sorted on the server.
+ */
+USTRUCT()
+struct ORDERSABILITIES_API FRTSReplicatedOrderQueue : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    FRTSReplicatedOrderQueue();
+
+    /** Gets the number of orders in this queue. */
+    int32 Num() const;
+
+    /** Whether this queue does not contain any orders. */
+    bool IsEmpty() const;
+
+    /** Whether the specified index refers to an order in this queue. */
+    bool IsValidIndex(int32 Index) const;
+
+    /** Gets the order at the specified position. '0' is the order that will be issued next. */
+    const FRTSOrderData& operator[](int32 Index) const;
+
+    /** Gets the order that will be issued next. */
+    const FRTSOrderData& First() const;
+
+    /**
+     * Gets the order that will be issued next, for caching data with it that isn't part of the order itself. Changes
+     * to the returned order are not replicated.
+     */
+    FRTSOrderData& First();
+
+    /** Gets the order that will be issued last. */
+    const FRTSOrderData& Last() const;
+
+    /** Adds the specified order to the end of this queue. */
+    void PushBack(const FRTSOrderData& Order);
+
+    /** Adds the specified order to the front of this queue. */
+    void PushFront(const FRTSOrderData& Order);
+
+    /** Removes the order at the front of this queue. */
+    void PopFront();
+
+    /** Removes all orders from this queue. */
+    void Reset();
+
+    /** Copies all orders to the specified array, starting with the order that will be issued next. */
+    void ToArray(TArray<FRTSOrderData>& OutOrders) const;
+
+    /**
+     * Rebuilds the orders of this queue from the replicated items, if any changes have been received since the last
+     * call. Returns whether the queue has changed.
+     */
+    bool ApplyReceivedChanges();
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+private:
+    /** Replicated orders, in no particular order. */
+    UPROPERTY()
+    TArray<FRTSReplicatedOrder> Items;
+
+    /** Queued orders in the correct order. Rebuilt from 'Items' on clients. */
+    UPROPERTY(NotReplicated)
+    FRTSOrderQueue Orders;
+
+    /** Indices of the orders in 'Items', by their sequence number. Only used on the server. */
+    TMap<int32, int32> ItemIndices;
+
+    /** Sequence number of the order at the front of this queue. Only used on the server. */
+    int32 FrontSequenceNumber;
+
+    /** Sequence number of the next order to add to the end of this queue. Only used on the server. */
+    int32 BackSequenceNumber;
+
+    /** Whether changes to 'Items' have been received that haven't been applied to 'Orders' yet. */
+    mutable bool bHasReceivedChanges;
+
+    /** Adds the specified order to 'Items' and marks it for replication. */
+    void AddItem(const FRTSOrderData& Order, int32 SequenceNumber);
+
+    friend struct FRTSReplicatedOrder;
+};
+
+template <>
+struct TStructOpsTypeTraits<FRTSReplicatedOrderQueue> : public TStructOpsTypeTraitsBase2<FRTSReplicatedOrderQueue>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "Engine/EngineTypes.h"
+#include "GenericTeamAgentInterface.h"
+
+#include "Orders/RTSPerWorld.h"
+
+class AActor;
+class UWorld;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FRTSSpatialHashGridActorEnteredCellSignature, AActor*, const FIntPoint&);
+
+/**
+ * Uniform 2D hash grid of all actors with an order or ability system component in a world. Actors are moved between
+ * grid cells as their root components move, so radius queries only have to check the actors in the few cells that
+ * overlap the query radius, without going through the physics scene. Each cell stores the locations of its actors in
+ * contiguous arrays, so queries can filter them with vector instructions without touching the actors themselves.
+ * Must only be used from the game thread.
+ */
+class ORDERSABILITIES_API FRTSSpatialHashGrid
+{
+public:
+    FRTSSpatialHashGrid(float InCellSize);
+    ~FRTSSpatialHashGrid();
+
+    /** Gets the grid of the specified world, creating it if necessary. Grids are destroyed when their world is. */
+    static FRTSSpatialHashGrid* Get(const UWorld* World);
+
+    /** Gets the grid of the specified world, or 'nullptr' if no actors have been registered in that world yet. */
+    static FRTSSpatialHashGrid* Find(const UWorld* World);
+
+    /**
+     * Adds the specified actor to the grid. Actors can be registered multiple times, e.g. by several of their
+     * components, and stay in the grid until they have been unregistered as often.
+     */
+    void RegisterActor(AActor* Actor);
+
+    /** Removes the specified actor from the grid, if it has been unregistered as often as it has been registered. */
+    void UnregisterActor(AActor* Actor);
+
+    /** Moves the specified actor to the grid cell of its current location. */
+    void UpdateActor(AActor* Actor);
+
+    /** Updates the team the specified actor is counted for in its grid cell. Call whenever its team changes. */
+    void UpdateActorTeam(AActor* Actor);
+
+    /** Finds all actors whose location is inside the specified radius around the specified location, in 2D. */
+    void FindActorsInRadius(const FVector& Location, float Radius, TArray<AActor*>& OutActors) const;
+
+    /**
+     * Finds all actors whose location is inside the specified radius around the specified location, and inside the
+     * specified chase distance around the specified home location, in 2D.
+     */
+    void FindActorsInChaseDistance(const FVector& Location, float Radius, const FVector& HomeLocation,
+                                   float ChaseDistance, TArray<AActor*>& OutActors) const;
+
+    /**
+     * Checks whether any actor hostile towards the specified actor is inside the specified radius around the specified
+     * location, in 2D. Cells completely inside the radius are checked by the number of actors of each team only,
+     * without looking at any actors.
+     */
+    bool IsHostileInRadius(const AActor* Actor, const FVector& Location, float Radius) const;
+
+    /** Gets the number of actors in the grid. */
+    int32 Num() const;
+
+    /** Gets the width and height of a single grid cell, in world units. */
+    float GetCellSize() const;
+
+    /** Gets the grid cell containing the specified location. */
+    FIntPoint GetCell(const FVector& Location) const;
+
+    /** Gets all grid cells overlapping the bounds of the specified radius around the specified location. */
+    void GetCellsInRadius(const FVector& Location, float Radius, TArray<FIntPoint>& OutCells) const;
+
+    /** Gets all actors in the specified grid cells. */
+    void GetActorsInCells(const TArray<FIntPoint>& CellsToSearch, TArray<AActor*>& OutActors) const;
+
+    /** Event when an actor has been added to a grid cell, because it has been registered or has moved. */
+    FRTSSpatialHashGridActorEnteredCellSignature OnActorEnteredCell;
+
+private:
+    /** Number of actors of a single team in a grid cell. */
+    struct FCellTeam
+    {
+        FGenericTeamId TeamId;
+        int32 NumActors;
+    };
+
+    /** Actors in a single grid cell. */
+    struct FCell
+    {
+        TArray<AActor*> Actors;
+
+        /** X coordinates of the locations of 'Actors'. */
+        TArray<float> LocationsX;
+
+        /** Y coordinates of the locations of 'Actors'. */
+        TArray<float> LocationsY;
+
+        /** Number of actors of each team in the cell. */
+        TArray<FCellTeam, TInlineAllocator<2>> Teams;
+    };
+
+    /** Grid cell and registration state of a single actor. */
+    struct FActorEntry
+    {
+        /** Grid cell the actor is stored in. */
+        FIntPoint Cell;
+
+        /** Index of the actor in the arrays of its grid cell. */
+        int32 CellIndex;
+
+        /** Team the actor is counted for in its grid cell. */
+        FGenericTeamId TeamId;
+
+        /** How often the actor has been registered. */
+        int32 RegistrationCount;
+
+        /** Component whose movement moves the actor between grid cells. */
+        TWeakObjectPtr<USceneComponent> RootComponent;
+
+        /** Handle of the delegate that is registered for the movement of 'RootComponent'. */
+        FDelegateHandle TransformUpdatedHandle;
+    };
+
+    /** Width and height of a single grid cell, in world units. */
+    float CellSize;
+
+    /** Actors in each grid cell that contains any. */
+    TMap<FIntPoint, FCell> Cells;
+
+    /** Grid cell and registration state of each actor in the grid. */
+    TMap<AActor*, FActorEntry> Entries;
+
+    /** Gets the grids of all worlds. */
+    static TRTSPerWorld<FRTSSpatialHashGrid>& GetWorldGrids();
+
+    /** Adds the specified actor at the specified location to the grid cell and team of its entry. */
+    void AddToCell(AActor* Actor, FActorEntry& Entry, const FVector& Location);
+
+    /** Removes the actor with the specified entry from its grid cell. */
+    void RemoveFromCell(const FActorEntry& Entry);
+
+    /**
+     * Finds the indices of all actors in the specified cell whose location is inside the specified squared radius
+     * around the specified location, and inside the specified squared chase distance around the specified home
+     * location, in 2D.
+     */
+    static void FilterCell(const FCell& Cell, const FVector& Location, float RadiusSquared,
+                           const FVector& HomeLocation, float ChaseDistanceSquared, TArray<int32>& OutIndices);
+
+    void OnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags,
+                            ETeleportType Teleport);
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Tuple.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "Orders/RTSPerWorld.h"
+
+class AActor;
+class URTSOrder;
+class UWorld;
+
+/** Target found for an order, along with its score. */
+struct ORDERSABILITIES_API FRTSScoredTarget
+{
+    FRTSScoredTarget(AActor* InActor, float InScore);
+
+    AActor* Actor;
+    float Score;
+};
+
+/** Search for targets for an order of a single unit. */
+struct ORDERSABILITIES_API FRTSTargetAcquisitionRequest
+{
+    FRTSTargetAcquisitionRequest(const AActor* InOrderedActor, TSoftClassPtr<URTSOrder> InOrderType, int32 InIndex,
+                                 float InAcquisitionRadius);
+
+    const AActor* OrderedActor;
+    TSoftClassPtr<URTSOrder> OrderType;
+    int32 Index;
+    float AcquisitionRadius;
+};
+
+/**
+ * Finds the best targets for orders of many units, sharing the work between units standing close to each other.
+ * Units in the same spatial grid cell searching for targets for the same order in the same frame form a group, which
+ * gathers potential targets from the grid only once. Each unit then just ranks the targets of its group in its own
+ * acquisition radius. There's one target acquisition per world. Must only be used from the game thread.
+ */
+class ORDERSABILITIES_API FRTSTargetAcquisition
+{
+public:
+    FRTSTargetAcquisition();
+
+    /**
+     * Gets the target acquisition of the specified world, creating it if necessary. Target acquisitions are destroyed
+     * when their world is.
+     */
+    static FRTSTargetAcquisition* Get(const UWorld* World);
+
+    /**
+     * Finds the best targets for the specified order inside the specified acquisition radius, best first. Targets are
+     * checked and scored by URTSOrderHelper::FindBestScoredTargetsForOrder, so only targets with a positive score are
+     * considered.
+     */
+    void FindBestTargets(const FRTSTargetAcquisitionRequest& Request, int32 MaxTargets,
+                         TArray<FRTSScoredTarget>& OutTargets);
+
+    /** Finds the best targets for all specified requests, best first per request. */
+    void FindBestTargets(const TArray<FRTSTargetAcquisitionRequest>& Requests, int32 MaxTargets,
+                         TArray<TArray<FRTSScoredTarget>>& OutTargets);
+
+private:
+    /** Potential targets gathered for all units in a grid cell searching for targets for the same order. */
+    struct FCandidateGroup
+    {
+        FCandidateGroup();
+
+        /** Radius around the center of the grid cell the targets have been gathered in. */
+        float GatherRadius;
+
+        TArray<AActor*> Actors;
+
+        /** X coordinates of the locations of 'Actors' when they have been gathered. */
+        TArray<float> LocationsX;
+
+        /** Y coordinates of the locations of 'Actors' when they have been gathered. */
+        TArray<float> LocationsY;
+    };
+
+    /** Groups of potential targets of the current frame, by grid cell, order default object and order index. */
+    TMap<TTuple<FIntPoint, const URTSOrder*, int32>, FCandidateGroup> CandidateGroups;
+
+    /** Frame the groups have been gathered in. */
+    uint64 CandidateGroupsFrame;
+
+    /** Gets the target acquisitions of all worlds. */
+    static TRTSPerWorld<FRTSTargetAcquisition>& GetWorldTargetAcquisitions();
+
+    /** Discards the groups of the previous frame, if this is a new frame. */
+    void ResetIfNewFrame();
+
+    /**
+     * Gets the group of potential targets for the specified order of units in the grid cell of the specified actor,
+     * gathering the targets if they haven't been gathered for the specified acquisition radius in this frame yet.
+     */
+    const FCandidateGroup* GatherCandidates(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                            float AcquisitionRadius);
+};
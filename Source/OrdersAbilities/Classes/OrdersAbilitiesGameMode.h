@@ -4,10 +4,21 @@
 #include "GameFramework/GameModeBase.h"
 #include "OrdersAbilitiesGameMode.generated.h"
 
+class URTSAutoOrderComponent;
+
 
 UCLASS()
 class ORDERSABILITIES_API AOrdersAbilitiesGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
+public:
+	/** Starts checking the auto orders of the specified unit each few frames, by the scheduler of its world. */
+	void AddAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent);
+
+	/** Stops checking the auto orders of the specified unit. */
+	void RemoveAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent);
+
+	/** Starts checking the auto orders of the specified unit again, after it has been asleep. */
+	void WakeUpAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent);
 };
@@ -19,7 +19,8 @@ public class OrdersAbilities : ModuleRules
                 "AIModule",
                 "GameplayAbilities",
                 "GameplayTags",
-                "GameplayTasks"
+                "GameplayTasks",
+                "NavigationSystem"
             });
 	}
 }
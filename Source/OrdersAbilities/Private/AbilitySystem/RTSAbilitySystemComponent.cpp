@@ -13,16 +13,20 @@
 #include "GameFramework/PlayerState.h"
 
 #include "AbilitySystem/RTSAbilitySystemHelper.h"
+#include "AbilitySystem/RTSActorTagSnapshot.h"
 #include "AbilitySystem/RTSAttributeSet.h"
 #include "AbilitySystem/RTSGameplayAbility.h"
 #include "AbilitySystem/RTSGlobalTags.h"
 #include "AbilitySystem/RTSInitialStatusTagsProvider.h"
+#include "Orders/RTSSpatialHashGrid.h"
 
 URTSAbilitySystemComponent::URTSAbilitySystemComponent()
 {
     Level = 1;
     CollectedXP = 0;
     AbilityPoints = 0;
+    bOwnedTagBitsetDirty = true;
+    OwnedTagBitsetGeneration = 0;
 }
 
 void URTSAbilitySystemComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -235,6 +239,8 @@ void URTSAbilitySystemComponent::IncreaseAbilityLevel(TSubclassOf<UGameplayAbili
             }
         }
 
+        OnAbilitiesChanged.Broadcast();
+
         if (bUseAbilityPoint)
         {
             // Remove ability point.
@@ -358,6 +364,13 @@ void URTSAbilitySystemComponent::BeginPlay()
         return;
     }
 
+    // Make the owner a potential target for orders.
+    FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Get(GetWorld());
+    if (Grid != nullptr)
+    {
+        Grid->RegisterActor(Owner);
+    }
+
     // Register ability ended callback.
     OnAbilityEnded.AddUObject(this, &URTSAbilitySystemComponent::AbilityEndedCallback);
 
@@ -433,10 +446,23 @@ void URTSAbilitySystemComponent::BeginPlay()
     //}
 }
 
+void URTSAbilitySystemComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(GetWorld());
+    if (Grid != nullptr)
+    {
+        Grid->UnregisterActor(GetOwner());
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void URTSAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
 {
     Super::OnGiveAbility(AbilitySpec);
 
+    OnAbilitiesChanged.Broadcast();
+
     if (!AbilitySpec.Ability)
     {
         return;
@@ -465,6 +491,31 @@ void URTSAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec
 void URTSAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
 {
     Super::OnRemoveAbility(AbilitySpec);
+
+    OnAbilitiesChanged.Broadcast();
+}
+
+void URTSAbilitySystemComponent::OnTagUpdated(const FGameplayTag& Tag, bool TagExists)
+{
+    Super::OnTagUpdated(Tag, TagExists);
+
+    FRTSActorTagSnapshot::Get().InvalidateActor(GetOwner());
+
+    if (bOwnedTagBitsetDirty || OwnedTagBitsetGeneration != FRTSTagBitset::GetDictionaryGeneration())
+    {
+        bOwnedTagBitsetDirty = true;
+        return;
+    }
+
+    // Parent tags might still be owned through other child tags, so removing tags requires a full rebuild.
+    if (TagExists)
+    {
+        OwnedTagBitset.AddTagWithParents(Tag);
+    }
+    else
+    {
+        bOwnedTagBitsetDirty = true;
+    }
 }
 
 void URTSAbilitySystemComponent::InitializeAttributes(int AttributeLevel, bool bInitialInit)
@@ -782,6 +833,31 @@ float URTSAbilitySystemComponent::GetAbilityRange(TSubclassOf<URTSGameplayAbilit
     return 0.0f;
 }
 
+const FRTSTagBitset& URTSAbilitySystemComponent::GetOwnedTagBitset() const
+{
+    // Network indices of all tags might have changed along with the tag dictionary.
+    const uint32 DictionaryGeneration = FRTSTagBitset::GetDictionaryGeneration();
+
+    if (bOwnedTagBitsetDirty || OwnedTagBitsetGeneration != DictionaryGeneration)
+    {
+        FGameplayTagContainer OwnedTags;
+        GetOwnedGameplayTags(OwnedTags);
+
+        OwnedTagBitset.Reset();
+        OwnedTagBitset.AddTagsWithParents(OwnedTags);
+
+        bOwnedTagBitsetDirty = false;
+        OwnedTagBitsetGeneration = DictionaryGeneration;
+    }
+
+    return OwnedTagBitset;
+}
+
+TSoftClassPtr<URTSUseAbilityOrder> URTSAbilitySystemComponent::GetUseAbilityOrder() const
+{
+    return UseAbilityOrder;
+}
+
 void URTSAbilitySystemComponent::GetAutoOrders_Implementation(TArray<FRTSOrderTypeWithIndex>& OutAutoOrders)
 {
     TArray<TSubclassOf<UGameplayAbility>> BasicAttackAbilities = URTSAbilitySystemHelper::GetBasicAttackAbilities(this);
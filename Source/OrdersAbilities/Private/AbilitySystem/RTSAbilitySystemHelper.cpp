@@ -23,7 +23,9 @@
 #include "AbilitySystem/RTSGameplayAbility.h"
 #include "AbilitySystem/RTSGameplayEffect.h"
 #include "AbilitySystem/RTSGlobalTags.h"
+#include "AbilitySystem/RTSRelationshipMatrix.h"
 #include "Orders/RTSOrderTargetData.h"
+#include "Orders/RTSSpatialHashGrid.h"
 
 
 // ---------------------------------------------------------------------------------------------------
@@ -725,46 +727,28 @@ void URTSAbilitySystemHelper::GetPlayerOwnerTags(const AActor* Actor, FGameplayT
 
 FGameplayTagContainer URTSAbilitySystemHelper::GetRelationshipTags(const AActor* Actor, const AActor* Other)
 {
+    // NOTE(np): In A Year Of Rain, we're adding more relationship tags based on the current owners of both units.
+    // Here, the team ids of both units are used instead. Relationships between teams are cached by the matrix.
+    return FRTSRelationshipMatrix::Get().GetRelationshipTags(Actor, Other);
+}
 
-    FGameplayTagContainer RelationshipTags;
-    if (Actor == nullptr || Other == nullptr)
-    {
-        RelationshipTags.AddTag(URTSGlobalTags::Relationship_Neutral());
-    }
+void URTSAbilitySystemHelper::NotifyOnTeamAttitudesChanged()
+{
+    FRTSRelationshipMatrix::Get().Invalidate();
+}
 
-    else if (Actor == Other)
+void URTSAbilitySystemHelper::NotifyOnTeamChanged(AActor* Actor)
+{
+    if (!IsValid(Actor))
     {
-        RelationshipTags.AddTag(URTSGlobalTags::Relationship_Friendly());
-        RelationshipTags.AddTag(URTSGlobalTags::Relationship_Self());
-        RelationshipTags.AddTag(URTSGlobalTags::Relationship_Visible());
+        return;
     }
 
-    else
+    FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(Actor->GetWorld());
+    if (Grid != nullptr)
     {
-        // NOTE(np): In A Year Of Rain, we're adding more relationship tags based on the current owners of both units.
-        /* const URTSOwnerComponent* ActorOwnerComponent = Actor->FindComponentByClass<URTSOwnerComponent>();
-         const URTSOwnerComponent* OtherOwnerComponent = Other->FindComponentByClass<URTSOwnerComponent>();
-
-         if (ActorOwnerComponent == nullptr || OtherOwnerComponent == nullptr)
-         {
-             RelationshipTags.AddTag(URTSGlobalTags::Relationship_Neutral());
-         }
-
-         else
-         {
-             const ARTSPlayerState* ActorPlayerState = ActorOwnerComponent->GetPlayerOwner();
-             const ARTSPlayerState* OtherPlayerState = OtherOwnerComponent->GetPlayerOwner();
-
-             GetRelationshipTagsFromPlayers(ActorPlayerState, OtherPlayerState, RelationshipTags);
-         }*/
-
-        if (!RelationshipTags.HasTag(URTSGlobalTags::Relationship_Visible()) && IsVisibleForActor(Actor, Other))
-        {
-            RelationshipTags.AddTag(URTSGlobalTags::Relationship_Visible());
-        }
+        Grid->UpdateActorTeam(Actor);
     }
-
-    return RelationshipTags;
 }
 
 // NOTE(np): In A Year Of Rain, we're adding relationship tags based on the team assignments of both players.
@@ -806,7 +790,8 @@ void URTSAbilitySystemHelper::GetSourceAndTargetTags(const AActor* SourceActor,
     GetTags(SourceActor, OutSourceTags);
     GetTags(TargetActor, OutTargetTags);
 
-    FGameplayTagContainer RelationshipTags = URTSAbilitySystemHelper::GetRelationshipTags(SourceActor, TargetActor);
+    const FGameplayTagContainer& RelationshipTags =
+        FRTSRelationshipMatrix::Get().GetRelationshipTags(SourceActor, TargetActor);
 
     OutSourceTags.AppendTags(RelationshipTags);
     OutTargetTags.AppendTags(RelationshipTags);
@@ -869,6 +854,28 @@ bool URTSAbilitySystemHelper::DoesSatisfyTagRequirements(const FGameplayTagConta
     return true;
 }
 
+void URTSAbilitySystemHelper::GetTagBitset(const UAbilitySystemComponent* AbilitySystem,
+                                           FRTSTagBitset& OutTagBitset)
+{
+    OutTagBitset.Reset();
+
+    if (AbilitySystem == nullptr)
+    {
+        return;
+    }
+
+    const URTSAbilitySystemComponent* RTSAbilitySystem = Cast<URTSAbilitySystemComponent>(AbilitySystem);
+    if (RTSAbilitySystem != nullptr)
+    {
+        OutTagBitset.Append(RTSAbilitySystem->GetOwnedTagBitset());
+        return;
+    }
+
+    FGameplayTagContainer OwnedTags;
+    AbilitySystem->GetOwnedGameplayTags(OwnedTags);
+    OutTagBitset.AddTagsWithParents(OwnedTags);
+}
+
 bool URTSAbilitySystemHelper::DoesSatisfyTagRequirementsWithResult(const FGameplayTagContainer& Tags,
                                                                    const FGameplayTagContainer& InRequiredTags,
                                                                    const FGameplayTagContainer& InBlockedTags,
@@ -0,0 +1,128 @@
+#include "AbilitySystem/RTSActorTagSnapshot.h"
+
+#include "OrdersAbilities.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameFramework/Actor.h"
+
+#include "AbilitySystem/RTSAbilitySystemHelper.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Actor Tag Snapshots Taken"), STAT_RTSActorTagSnapshotsTaken, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Actor Tag Snapshot Hits"), STAT_RTSActorTagSnapshotHits, STATGROUP_RTS);
+
+
+FRTSActorTagSnapshot::FRTSActorTagSnapshot()
+    : NumSlots(0)
+    , SnapshotFrame(0)
+{
+}
+
+FRTSActorTagSnapshot& FRTSActorTagSnapshot::Get()
+{
+    static FRTSActorTagSnapshot Snapshot;
+    return Snapshot;
+}
+
+int32 FRTSActorTagSnapshot::FindOrAddSlot(const AActor* Actor)
+{
+    check(IsInGameThread());
+
+    if (!IsValid(Actor))
+    {
+        return INDEX_NONE;
+    }
+
+    ResetIfNewFrame();
+
+    const int32* ExistingSlot = ActorSlots.Find(Actor);
+    if (ExistingSlot != nullptr)
+    {
+        FActorTags& ExistingActorTags = ActorTags[*ExistingSlot];
+        if (ExistingActorTags.bIsOutdated)
+        {
+            TakeSnapshot(Actor, ExistingActorTags);
+        }
+        else
+        {
+            INC_DWORD_STAT(STAT_RTSActorTagSnapshotHits);
+        }
+
+        return *ExistingSlot;
+    }
+
+    int32 Slot = NumSlots++;
+    if (Slot >= ActorTags.Num())
+    {
+        ActorTags.Add(new FActorTags());
+    }
+
+    TakeSnapshot(Actor, ActorTags[Slot]);
+    ActorSlots.Add(Actor, Slot);
+
+    return Slot;
+}
+
+const FGameplayTagContainer& FRTSActorTagSnapshot::GetOwnedTags(int32 Slot) const
+{
+    return Slot != INDEX_NONE ? ActorTags[Slot].OwnedTags : FGameplayTagContainer::EmptyContainer;
+}
+
+const FRTSTagBitset& FRTSActorTagSnapshot::GetOwnedTagBits(int32 Slot) const
+{
+    static const FRTSTagBitset EmptyTagBits;
+    return Slot != INDEX_NONE ? ActorTags[Slot].OwnedTagBits : EmptyTagBits;
+}
+
+const FGameplayTagContainer& FRTSActorTagSnapshot::GetOwnedTags(const AActor* Actor)
+{
+    return GetOwnedTags(FindOrAddSlot(Actor));
+}
+
+const FRTSTagBitset& FRTSActorTagSnapshot::GetOwnedTagBits(const AActor* Actor)
+{
+    return GetOwnedTagBits(FindOrAddSlot(Actor));
+}
+
+void FRTSActorTagSnapshot::InvalidateActor(const AActor* Actor)
+{
+    if (SnapshotFrame != GFrameCounter)
+    {
+        // The whole snapshot will be discarded anyway.
+        return;
+    }
+
+    const int32* ExistingSlot = ActorSlots.Find(Actor);
+    if (ExistingSlot != nullptr)
+    {
+        ActorTags[*ExistingSlot].bIsOutdated = true;
+    }
+}
+
+void FRTSActorTagSnapshot::ResetIfNewFrame()
+{
+    if (SnapshotFrame == GFrameCounter)
+    {
+        return;
+    }
+
+    SnapshotFrame = GFrameCounter;
+    NumSlots = 0;
+    ActorSlots.Reset();
+}
+
+void FRTSActorTagSnapshot::TakeSnapshot(const AActor* Actor, FActorTags& OutActorTags) const
+{
+    INC_DWORD_STAT(STAT_RTSActorTagSnapshotsTaken);
+
+    OutActorTags.OwnedTags.Reset();
+    OutActorTags.bIsOutdated = false;
+
+    const UAbilitySystemComponent* AbilitySystem = Actor->FindComponentByClass<UAbilitySystemComponent>();
+    if (AbilitySystem != nullptr)
+    {
+        AbilitySystem->GetOwnedGameplayTags(OutActorTags.OwnedTags);
+    }
+
+    URTSAbilitySystemHelper::GetTagBitset(AbilitySystem, OutActorTags.OwnedTagBits);
+}
@@ -0,0 +1,204 @@
+#include "AbilitySystem/RTSRelationshipMatrix.h"
+
+#include "OrdersAbilities.h"
+
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+
+#include "AbilitySystem/RTSAbilitySystemHelper.h"
+#include "AbilitySystem/RTSGlobalTags.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Team Relationships Computed"), STAT_RTSTeamRelationshipsComputed,
+                           STATGROUP_RTS);
+
+
+FRTSRelationshipMatrix::FRTSRelationshipMatrix()
+{
+    TeamRelationships.SetNumZeroed(NUM_TEAMS * NUM_TEAMS);
+
+    // Build the tags of all possible relationships up front.
+    RelationshipTagsGeneration = FRTSTagBitset::GetDictionaryGeneration() - 1;
+    UpdateRelationshipTags();
+}
+
+FRTSRelationshipMatrix& FRTSRelationshipMatrix::Get()
+{
+    static FRTSRelationshipMatrix Matrix;
+    return Matrix;
+}
+
+ERTSRelationshipFlags FRTSRelationshipMatrix::GetRelationship(const AActor* Actor, const AActor* Other)
+{
+    check(IsInGameThread());
+
+    if (Actor == nullptr || Other == nullptr)
+    {
+        return ERTSRelationshipFlags::NEUTRAL;
+    }
+
+    if (Actor == Other)
+    {
+        return ERTSRelationshipFlags::FRIENDLY | ERTSRelationshipFlags::SELF | ERTSRelationshipFlags::VISIBLE;
+    }
+
+    ERTSRelationshipFlags Relationship = GetTeamRelationship(GetTeam(Actor), GetTeam(Other));
+
+    // Visibility differs per unit, unless both are of the same team.
+    if (!EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::VISIBLE) &&
+        URTSAbilitySystemHelper::IsVisibleForActor(Actor, Other))
+    {
+        Relationship |= ERTSRelationshipFlags::VISIBLE;
+    }
+
+    return Relationship;
+}
+
+ERTSRelationshipFlags FRTSRelationshipMatrix::GetTeamRelationship(FGenericTeamId Team, FGenericTeamId OtherTeam)
+{
+    uint8& TeamRelationship = TeamRelationships[Team.GetId() * NUM_TEAMS + OtherTeam.GetId()];
+    if ((TeamRelationship & COMPUTED_FLAG) == 0)
+    {
+        INC_DWORD_STAT(STAT_RTSTeamRelationshipsComputed);
+        TeamRelationship = (uint8)ComputeTeamRelationship(Team, OtherTeam) | COMPUTED_FLAG;
+    }
+
+    return (ERTSRelationshipFlags)(TeamRelationship & ~COMPUTED_FLAG);
+}
+
+const FGameplayTagContainer& FRTSRelationshipMatrix::GetRelationshipTags(const AActor* Actor, const AActor* Other)
+{
+    return GetRelationshipTags(GetRelationship(Actor, Other));
+}
+
+const FGameplayTagContainer& FRTSRelationshipMatrix::GetRelationshipTags(ERTSRelationshipFlags Relationship)
+{
+    UpdateRelationshipTags();
+    return RelationshipTags[(int32)Relationship];
+}
+
+const FRTSTagBitset& FRTSRelationshipMatrix::GetRelationshipTagBits(ERTSRelationshipFlags Relationship)
+{
+    UpdateRelationshipTags();
+    return RelationshipTagBits[(int32)Relationship];
+}
+
+ERTSRelationshipFlags FRTSRelationshipMatrix::GetRelationshipFlags(const FGameplayTagContainer& Tags)
+{
+    UpdateRelationshipTags();
+
+    ERTSRelationshipFlags Relationship = ERTSRelationshipFlags::NONE;
+
+    // Combinations of a single flag have exactly the tag of that flag.
+    for (int32 Flag = 1; Flag < (int32)ERTSRelationshipFlags::NUM_COMBINATIONS; Flag <<= 1)
+    {
+        if (Tags.HasAnyExact(RelationshipTags[Flag]))
+        {
+            Relationship |= (ERTSRelationshipFlags)Flag;
+        }
+    }
+
+    return Relationship;
+}
+
+void FRTSRelationshipMatrix::Invalidate()
+{
+    FMemory::Memzero(TeamRelationships.GetData(), TeamRelationships.Num());
+}
+
+FGenericTeamId FRTSRelationshipMatrix::GetTeam(const AActor* Actor) const
+{
+    const IGenericTeamAgentInterface* TeamAgent = Cast<const IGenericTeamAgentInterface>(Actor);
+    if (TeamAgent != nullptr)
+    {
+        return TeamAgent->GetGenericTeamId();
+    }
+
+    // Units usually get their team from the controller possessing them.
+    const APawn* Pawn = Cast<APawn>(Actor);
+    if (Pawn != nullptr)
+    {
+        TeamAgent = Cast<const IGenericTeamAgentInterface>(Pawn->GetController());
+        if (TeamAgent != nullptr)
+        {
+            return TeamAgent->GetGenericTeamId();
+        }
+    }
+
+    return FGenericTeamId::NoTeam;
+}
+
+void FRTSRelationshipMatrix::UpdateRelationshipTags()
+{
+    const uint32 DictionaryGeneration = FRTSTagBitset::GetDictionaryGeneration();
+    if (RelationshipTagsGeneration == DictionaryGeneration)
+    {
+        return;
+    }
+
+    RelationshipTagsGeneration = DictionaryGeneration;
+
+    const int32 NumCombinations = (int32)ERTSRelationshipFlags::NUM_COMBINATIONS;
+    RelationshipTags.Reset();
+    RelationshipTags.SetNum(NumCombinations);
+    RelationshipTagBits.Reset();
+    RelationshipTagBits.SetNum(NumCombinations);
+
+    for (int32 Combination = 0; Combination < NumCombinations; ++Combination)
+    {
+        ERTSRelationshipFlags Relationship = (ERTSRelationshipFlags)Combination;
+        FGameplayTagContainer& Tags = RelationshipTags[Combination];
+
+        if (EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::FRIENDLY))
+        {
+            Tags.AddTag(URTSGlobalTags::Relationship_Friendly());
+        }
+        if (EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::HOSTILE))
+        {
+            Tags.AddTag(URTSGlobalTags::Relationship_Hostile());
+        }
+        if (EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::NEUTRAL))
+        {
+            Tags.AddTag(URTSGlobalTags::Relationship_Neutral());
+        }
+        if (EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::SAME_PLAYER))
+        {
+            Tags.AddTag(URTSGlobalTags::Relationship_SamePlayer());
+        }
+        if (EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::SELF))
+        {
+            Tags.AddTag(URTSGlobalTags::Relationship_Self());
+        }
+        if (EnumHasAnyFlags(Relationship, ERTSRelationshipFlags::VISIBLE))
+        {
+            Tags.AddTag(URTSGlobalTags::Relationship_Visible());
+        }
+
+        RelationshipTagBits[Combination].AddTagsWithParents(Tags);
+    }
+}
+
+ERTSRelationshipFlags FRTSRelationshipMatrix::ComputeTeamRelationship(FGenericTeamId Team,
+                                                                      FGenericTeamId OtherTeam) const
+{
+    // Units without team are neither friends nor enemies of anybody.
+    if (Team == FGenericTeamId::NoTeam || OtherTeam == FGenericTeamId::NoTeam)
+    {
+        return ERTSRelationshipFlags::NEUTRAL;
+    }
+
+    if (Team == OtherTeam)
+    {
+        return ERTSRelationshipFlags::FRIENDLY | ERTSRelationshipFlags::SAME_PLAYER | ERTSRelationshipFlags::VISIBLE;
+    }
+
+    switch (FGenericTeamId::GetAttitude(Team, OtherTeam))
+    {
+        case ETeamAttitude::Friendly:
+            return ERTSRelationshipFlags::FRIENDLY;
+        case ETeamAttitude::Hostile:
+            return ERTSRelationshipFlags::HOSTILE;
+        default:
+            return ERTSRelationshipFlags::NEUTRAL;
+    }
+}
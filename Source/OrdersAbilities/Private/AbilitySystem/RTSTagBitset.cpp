@@ -0,0 +1,168 @@
+#include "AbilitySystem/RTSTagBitset.h"
+
+#include "OrdersAbilities.h"
+
+#include "GameplayTagsManager.h"
+#include "GameplayTagsModule.h"
+
+
+void FRTSTagBitset::AddTag(const FGameplayTag& Tag)
+{
+    if (!Tag.IsValid())
+    {
+        return;
+    }
+
+    SetBit(Tag);
+}
+
+void FRTSTagBitset::AddTagWithParents(const FGameplayTag& Tag)
+{
+    if (!Tag.IsValid())
+    {
+        return;
+    }
+
+    TSharedPtr<FGameplayTagNode> TagNode = UGameplayTagsManager::Get().FindTagNode(Tag);
+    if (!TagNode.IsValid())
+    {
+        return;
+    }
+
+    // Walk up the tag tree. The root node doesn't represent a tag. Don't use the network indices of the nodes directly,
+    // as they aren't rebuilt before being accessed after the dictionary has changed, unlike the ones used by AddTag.
+    for (FGameplayTagNode* Node = TagNode.Get(); Node != nullptr && Node->GetParentTagNode() != nullptr;
+         Node = Node->GetParentTagNode())
+    {
+        SetBit(Node->GetCompleteTag());
+    }
+}
+
+void FRTSTagBitset::AddTags(const FGameplayTagContainer& Tags)
+{
+    for (const FGameplayTag& Tag : Tags)
+    {
+        AddTag(Tag);
+    }
+}
+
+void FRTSTagBitset::AddTagsWithParents(const FGameplayTagContainer& Tags)
+{
+    for (const FGameplayTag& Tag : Tags)
+    {
+        AddTagWithParents(Tag);
+    }
+}
+
+void FRTSTagBitset::Append(const FRTSTagBitset& Other)
+{
+    if (Words.Num() < Other.Words.Num())
+    {
+        Words.AddZeroed(Other.Words.Num() - Words.Num());
+    }
+
+    for (int32 WordIndex = 0; WordIndex < Other.Words.Num(); ++WordIndex)
+    {
+        Words[WordIndex] |= Other.Words[WordIndex];
+    }
+}
+
+void FRTSTagBitset::Reset()
+{
+    Words.Reset();
+}
+
+bool FRTSTagBitset::IsEmpty() const
+{
+    uint64 AllBits = 0;
+
+    for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+    {
+        AllBits |= Words[WordIndex];
+    }
+
+    return AllBits == 0;
+}
+
+bool FRTSTagBitset::HasAny(const FRTSTagBitset& Other) const
+{
+    const int32 NumCommonWords = FMath::Min(Words.Num(), Other.Words.Num());
+
+    // Accumulate without branching, so the compiler is free to vectorize the loop.
+    uint64 CommonBits = 0;
+
+    for (int32 WordIndex = 0; WordIndex < NumCommonWords; ++WordIndex)
+    {
+        CommonBits |= Words[WordIndex] & Other.Words[WordIndex];
+    }
+
+    return CommonBits != 0;
+}
+
+bool FRTSTagBitset::HasAll(const FRTSTagBitset& Other) const
+{
+    const int32 NumCommonWords = FMath::Min(Words.Num(), Other.Words.Num());
+
+    // Accumulate without branching, so the compiler is free to vectorize the loop.
+    uint64 MissingBits = 0;
+
+    for (int32 WordIndex = 0; WordIndex < NumCommonWords; ++WordIndex)
+    {
+        MissingBits |= Other.Words[WordIndex] & ~Words[WordIndex];
+    }
+
+    for (int32 WordIndex = NumCommonWords; WordIndex < Other.Words.Num(); ++WordIndex)
+    {
+        MissingBits |= Other.Words[WordIndex];
+    }
+
+    return MissingBits == 0;
+}
+
+uint32 FRTSTagBitset::GetDictionaryGeneration()
+{
+    check(IsInGameThread());
+
+    // Changes before the first check don't matter, as no bitsets have been kept around yet.
+    static FDelegateHandle GameplayTagTreeChangedHandle;
+    if (!GameplayTagTreeChangedHandle.IsValid())
+    {
+        GameplayTagTreeChangedHandle =
+            IGameplayTagsModule::OnGameplayTagTreeChanged.AddStatic(&FRTSTagBitset::OnGameplayTagTreeChanged);
+    }
+
+    return GetDictionaryGenerationCounter();
+}
+
+void FRTSTagBitset::SetBit(const FGameplayTag& Tag)
+{
+    const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+    const FGameplayTagNetIndex NetIndex = TagsManager.GetNetIndexFromTag(Tag);
+
+    // Tags that have been removed from the dictionary can't be owned or required anymore.
+    if (NetIndex == TagsManager.InvalidTagNetIndex)
+    {
+        return;
+    }
+
+    const int32 BitIndex = NetIndex;
+    const int32 WordIndex = BitIndex >> 6;
+
+    if (WordIndex >= Words.Num())
+    {
+        Words.AddZeroed(WordIndex + 1 - Words.Num());
+    }
+
+    Words[WordIndex] |= uint64(1) << (BitIndex & 63);
+}
+
+void FRTSTagBitset::OnGameplayTagTreeChanged()
+{
+    ++GetDictionaryGenerationCounter();
+}
+
+uint32& FRTSTagBitset::GetDictionaryGenerationCounter()
+{
+    static uint32 DictionaryGeneration = 0;
+    return DictionaryGeneration;
+}
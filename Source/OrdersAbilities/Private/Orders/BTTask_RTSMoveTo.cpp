@@ -0,0 +1,326 @@
+#include "Orders/BTTask_RTSMoveTo.h"
+
+#include "OrdersAbilities.h"
+
+#include "AIController.h"
+#include "AITypes.h"
+#include "BrainComponent.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "GameFramework/Pawn.h"
+#include "Navigation/PathFollowingComponent.h"
+
+#include "Orders/RTSFlowField.h"
+#include "Orders/RTSFlowFieldService.h"
+#include "Orders/RTSOrderComponent.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Move To Path Query Time"), STAT_RTSMoveToPathQueryTime, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Move To Path Queries"), STAT_RTSMoveToPathQueries, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Move To Flow Field Waypoints"), STAT_RTSMoveToFlowFieldWaypoints,
+                           STATGROUP_RTS);
+
+
+UBTTask_RTSMoveTo::UBTTask_RTSMoveTo(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    NodeName = TEXT("RTS Move To");
+    bNotifyTick = true;
+    bNotifyTaskFinished = true;
+
+    AcceptableRadius = 5.0f;
+    FlowFieldLookAheadCells = 4;
+    FlowFieldHandOffDistance = 1000.0f;
+
+    BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_RTSMoveTo, BlackboardKey));
+}
+
+EBTNodeResult::Type UBTTask_RTSMoveTo::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+    FBTRTSMoveToTaskMemory* Memory = CastInstanceNodeMemory<FBTRTSMoveToTaskMemory>(NodeMemory);
+    Memory->bIsFollowingFlowField = false;
+    Memory->bIsWaitingForFlowField = false;
+
+    return PerformMove(OwnerComp, NodeMemory);
+}
+
+EBTNodeResult::Type UBTTask_RTSMoveTo::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+    StopWaitingForMessages(OwnerComp);
+
+    AAIController* AIController = OwnerComp.GetAIOwner();
+    if (AIController != nullptr)
+    {
+        AIController->StopMovement();
+    }
+
+    return EBTNodeResult::Aborted;
+}
+
+void UBTTask_RTSMoveTo::OnMessage(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message,
+                                  int32 RequestID, bool bSuccess)
+{
+    FBTRTSMoveToTaskMemory* Memory = CastInstanceNodeMemory<FBTRTSMoveToTaskMemory>(NodeMemory);
+
+    if ((Memory->bIsFollowingFlowField || Memory->bIsWaitingForFlowField) &&
+        OwnerComp.GetTaskStatus(this) == EBTTaskStatus::Active)
+    {
+        // Reached a waypoint or the target location, or got stuck on the way there. Either way, carry on towards the
+        // target location.
+        EBTNodeResult::Type Result = EBTNodeResult::Failed;
+
+        if (bSuccess)
+        {
+            Result = PerformMove(OwnerComp, NodeMemory);
+        }
+        else
+        {
+            const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+            if (Blackboard != nullptr)
+            {
+                const FVector TargetLocation =
+                    Blackboard->GetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID());
+                Result = MoveAlongPath(OwnerComp, Memory, TargetLocation);
+            }
+        }
+
+        if (Result != EBTNodeResult::InProgress)
+        {
+            FinishLatentTask(OwnerComp, Result);
+        }
+
+        return;
+    }
+
+    Super::OnMessage(OwnerComp, NodeMemory, Message, RequestID, bSuccess);
+}
+
+void UBTTask_RTSMoveTo::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory,
+                                       EBTNodeResult::Type TaskResult)
+{
+    // The flow field has served its purpose for this pawn.
+    AAIController* AIController = OwnerComp.GetAIOwner();
+    APawn* Pawn = AIController != nullptr ? AIController->GetPawn() : nullptr;
+
+    if (Pawn != nullptr)
+    {
+        FRTSFlowFieldService* FlowFieldService = FRTSFlowFieldService::Find(Pawn->GetWorld());
+        if (FlowFieldService != nullptr)
+        {
+            FlowFieldService->ReleaseActor(Pawn);
+        }
+    }
+
+    Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+uint16 UBTTask_RTSMoveTo::GetInstanceMemorySize() const
+{
+    return sizeof(FBTRTSMoveToTaskMemory);
+}
+
+FString UBTTask_RTSMoveTo::GetStaticDescription() const
+{
+    return FString::Printf(TEXT("%s: %s\nFollows flow fields of large groups"), *Super::GetStaticDescription(),
+                           *GetSelectedBlackboardKey().ToString());
+}
+
+void UBTTask_RTSMoveTo::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+    FBTRTSMoveToTaskMemory* Memory = CastInstanceNodeMemory<FBTRTSMoveToTaskMemory>(NodeMemory);
+    if (!Memory->bIsFollowingFlowField && !Memory->bIsWaitingForFlowField)
+    {
+        return;
+    }
+
+    const AAIController* AIController = OwnerComp.GetAIOwner();
+    const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+    if (AIController == nullptr || Blackboard == nullptr)
+    {
+        return;
+    }
+
+    // Move on to the next waypoint before reaching the current one, so the pawn doesn't stop in between.
+    const FVector TargetLocation = Blackboard->GetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID());
+
+    FVector Waypoint;
+    bool bIsWaitingForFlowField;
+    const bool bShouldFollowFlowField =
+        GetFlowFieldWaypoint(AIController, TargetLocation, Waypoint, bIsWaitingForFlowField);
+
+    if (bIsWaitingForFlowField ||
+        (bShouldFollowFlowField && Memory->bIsFollowingFlowField && Waypoint.Equals(Memory->Waypoint, 1.0f)))
+    {
+        return;
+    }
+
+    const EBTNodeResult::Type Result = PerformMove(OwnerComp, NodeMemory);
+    if (Result != EBTNodeResult::InProgress)
+    {
+        FinishLatentTask(OwnerComp, Result);
+    }
+}
+
+EBTNodeResult::Type UBTTask_RTSMoveTo::PerformMove(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+    FBTRTSMoveToTaskMemory* Memory = CastInstanceNodeMemory<FBTRTSMoveToTaskMemory>(NodeMemory);
+    Memory->bIsFollowingFlowField = false;
+    Memory->bIsWaitingForFlowField = false;
+
+    AAIController* AIController = OwnerComp.GetAIOwner();
+    const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+    if (AIController == nullptr || AIController->GetPawn() == nullptr || Blackboard == nullptr)
+    {
+        return EBTNodeResult::Failed;
+    }
+
+    const FVector TargetLocation = Blackboard->GetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID());
+
+    FVector Waypoint;
+    bool bIsWaitingForFlowField;
+    if (!GetFlowFieldWaypoint(AIController, TargetLocation, Waypoint, bIsWaitingForFlowField))
+    {
+        return MoveAlongPath(OwnerComp, Memory, TargetLocation);
+    }
+
+    StopWaitingForMessages(OwnerComp);
+
+    // Don't find a path if the flow field will be available in a moment, but get going already.
+    if (bIsWaitingForFlowField)
+    {
+        const FPathFollowingRequestResult MoveResult = MoveDirectly(AIController, TargetLocation);
+        switch (MoveResult.Code)
+        {
+            case EPathFollowingRequestResult::AlreadyAtGoal:
+                return EBTNodeResult::Succeeded;
+            case EPathFollowingRequestResult::RequestSuccessful:
+                Memory->bIsWaitingForFlowField = true;
+                WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, MoveResult.MoveId);
+                return EBTNodeResult::InProgress;
+            default:
+                return MoveAlongPath(OwnerComp, Memory, TargetLocation);
+        }
+    }
+
+    // Move directly to the next waypoint, without finding a path.
+    const FPathFollowingRequestResult MoveResult = MoveDirectly(AIController, Waypoint);
+    if (MoveResult.Code != EPathFollowingRequestResult::RequestSuccessful)
+    {
+        return MoveAlongPath(OwnerComp, Memory, TargetLocation);
+    }
+
+    INC_DWORD_STAT(STAT_RTSMoveToFlowFieldWaypoints);
+
+    Memory->bIsFollowingFlowField = true;
+    Memory->Waypoint = Waypoint;
+
+    WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, MoveResult.MoveId);
+    return EBTNodeResult::InProgress;
+}
+
+EBTNodeResult::Type UBTTask_RTSMoveTo::MoveAlongPath(UBehaviorTreeComponent& OwnerComp,
+                                                     FBTRTSMoveToTaskMemory* Memory, const FVector& TargetLocation)
+{
+    SCOPE_CYCLE_COUNTER(STAT_RTSMoveToPathQueryTime);
+
+    Memory->bIsFollowingFlowField = false;
+    Memory->bIsWaitingForFlowField = false;
+
+    StopWaitingForMessages(OwnerComp);
+
+    AAIController* AIController = OwnerComp.GetAIOwner();
+    if (AIController == nullptr)
+    {
+        return EBTNodeResult::Failed;
+    }
+
+    FAIMoveRequest MoveRequest(TargetLocation);
+    MoveRequest.SetAcceptanceRadius(AcceptableRadius);
+
+    // Use the path that has been found while the order was still queued, if any.
+    URTSOrderComponent* OrderComponent =
+        AIController->GetPawn() != nullptr ? AIController->GetPawn()->FindComponentByClass<URTSOrderComponent>()
+                                           : nullptr;
+    FNavPathSharedPtr PrefetchedPath =
+        OrderComponent != nullptr ? OrderComponent->ConsumePrefetchedPath(TargetLocation) : nullptr;
+
+    if (PrefetchedPath.IsValid())
+    {
+        const FAIRequestID MoveId = AIController->RequestMove(MoveRequest, PrefetchedPath);
+        if (MoveId.IsValid())
+        {
+            WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, MoveId);
+            return EBTNodeResult::InProgress;
+        }
+    }
+
+    INC_DWORD_STAT(STAT_RTSMoveToPathQueries);
+
+    const FPathFollowingRequestResult MoveResult = AIController->MoveTo(MoveRequest);
+    switch (MoveResult.Code)
+    {
+        case EPathFollowingRequestResult::AlreadyAtGoal:
+            return EBTNodeResult::Succeeded;
+        case EPathFollowingRequestResult::RequestSuccessful:
+            WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, MoveResult.MoveId);
+            return EBTNodeResult::InProgress;
+        default:
+            return EBTNodeResult::Failed;
+    }
+}
+
+FPathFollowingRequestResult UBTTask_RTSMoveTo::MoveDirectly(AAIController* AIController,
+                                                            const FVector& Location) const
+{
+    FAIMoveRequest MoveRequest(Location);
+    MoveRequest.SetUsePathfinding(false);
+    MoveRequest.SetProjectGoalLocation(false);
+    MoveRequest.SetStopOnOverlap(false);
+    MoveRequest.SetAcceptanceRadius(AcceptableRadius);
+
+    return AIController->MoveTo(MoveRequest);
+}
+
+bool UBTTask_RTSMoveTo::GetFlowFieldWaypoint(const AAIController* AIController, const FVector& TargetLocation,
+                                             FVector& OutWaypoint, bool& bOutIsWaitingForFlowField) const
+{
+    bOutIsWaitingForFlowField = false;
+
+    const APawn* Pawn = AIController->GetPawn();
+    if (Pawn == nullptr)
+    {
+        return false;
+    }
+
+    FRTSFlowFieldService* FlowFieldService = FRTSFlowFieldService::Find(Pawn->GetWorld());
+    if (FlowFieldService == nullptr)
+    {
+        return false;
+    }
+
+    const FRTSFlowField* FlowField = FlowFieldService->FindFlowField(Pawn, TargetLocation, bOutIsWaitingForFlowField);
+    if (bOutIsWaitingForFlowField)
+    {
+        return true;
+    }
+
+    if (FlowField == nullptr)
+    {
+        return false;
+    }
+
+    // Find a path for the last few meters, once close to the target location, or about as close to the destination of
+    // the flow field as the target location is.
+    const FVector PawnLocation = Pawn->GetActorLocation();
+    const FVector& FlowFieldDestination = FlowField->GetDestination();
+
+    if (FVector::Dist2D(PawnLocation, TargetLocation) <= FlowFieldHandOffDistance ||
+        FVector::Dist2D(PawnLocation, FlowFieldDestination) <=
+            FVector::Dist2D(TargetLocation, FlowFieldDestination) + FlowFieldHandOffDistance)
+    {
+        return false;
+    }
+
+    return FlowField->GetWaypoint(PawnLocation, FlowFieldLookAheadCells, OutWaypoint);
+}
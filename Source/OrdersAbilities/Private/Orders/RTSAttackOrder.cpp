@@ -59,6 +59,16 @@ float URTSAttackOrder::GetTargetScore(const AActor* OrderedActor, const FRTSOrde
     return Score;
 }
 
+bool URTSAttackOrder::SupportsParallelTargetScoring(const AActor* OrderedActor, int32 Index) const
+{
+    // Scores only depend on actor locations, target tags and the acquisition radius properties of this order. Native
+    // subclasses overriding 'IsValidTarget' or 'GetTargetScore' need to check this again.
+    // Make sure the static tags used for scoring are initialized on the game thread, not concurrently by workers.
+    URTSGlobalTags::Status_Permanent_CanGather();
+    URTSGlobalTags::Building();
+    return true;
+}
+
 bool URTSAttackOrder::AreAutoOrdersAllowedDuringOrder() const
 {
     return true;
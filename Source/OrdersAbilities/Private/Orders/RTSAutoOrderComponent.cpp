@@ -2,16 +2,58 @@
 
 #include "OrdersAbilities.h"
 
+#include "AbilitySystemComponent.h"
 #include "UnrealNetwork.h"
 
+#include "Engine/World.h"
 #include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 
+#include "AbilitySystem/RTSRelationshipMatrix.h"
 #include "Orders/RTSAutoOrderProvider.h"
+#include "Orders/RTSAutoOrderScheduler.h"
+#include "Orders/RTSOrder.h"
 #include "Orders/RTSOrderHelper.h"
 #include "Orders/RTSOrderComponent.h"
+#include "Orders/RTSOrderTypeRegistry.h"
+#include "Orders/RTSTargetAcquisition.h"
 
 DECLARE_CYCLE_STAT(TEXT("RTS - Auto Order Target Acquisition"), STAT_RTSAutoOrderTargetAcquisition, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Target Cache Hits"), STAT_RTSAutoOrderTargetCacheHits,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Target Cache Invalidations"),
+                           STAT_RTSAutoOrderTargetCacheInvalidations, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Target Cache Fallbacks"), STAT_RTSAutoOrderTargetCacheFallbacks,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Target Searches"), STAT_RTSAutoOrderTargetSearches, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Target Switches Suppressed"),
+                           STAT_RTSAutoOrderTargetSwitchesSuppressed, STATGROUP_RTS);
+
+static TAutoConsoleVariable<float> CVarRTSAutoOrderTargetSearchInterval(
+    TEXT("RTS.AutoOrders.TargetSearchInterval"), 0.5f,
+    TEXT("Time during which units keep the target found for an auto order without searching for a better one, as "
+         "long as it stays valid and in range, in seconds. 0 to search on every check."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSAutoOrderTargetSwitchMargin(
+    TEXT("RTS.AutoOrders.TargetSwitchMargin"), 0.1f,
+    TEXT("Fraction by which a new target for an auto order has to score better than the previous one, which is "
+         "still valid, for units to switch targets."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRTSAutoOrderFallbackTargets(
+    TEXT("RTS.AutoOrders.FallbackTargets"), 2,
+    TEXT("Number of runner-up targets units remember from each search for an auto order, to switch to if the best "
+         "target becomes invalid before the next search is due."),
+    ECVF_Default);
+
+
+URTSAutoOrderComponent::FCachedTarget::FCachedTarget()
+    : Score(0.0f)
+    , SearchTime(0.0f)
+{
+}
 
 
 URTSAutoOrderComponent::URTSAutoOrderComponent()
@@ -19,6 +61,9 @@ URTSAutoOrderComponent::URTSAutoOrderComponent()
     SetIsReplicated(true);
 
     bCheckAutoOrders = false;
+    bIssuedAutoOrderOnLastCheck = false;
+    bIsAsleep = false;
+    OrderComponent = nullptr;
 }
 
 void URTSAutoOrderComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -51,6 +96,7 @@ void URTSAutoOrderComponent::SetHumanPlayerAutoOrderState(const FRTSOrderTypeWit
             if (bEnable)
             {
                 bCheckAutoOrders = true;
+                WakeUp();
             }
 
             break;
@@ -82,7 +128,7 @@ void URTSAutoOrderComponent::BeginPlay()
         return;
     }
 
-    URTSOrderComponent* OrderComponent = Owner->FindComponentByClass<URTSOrderComponent>();
+    OrderComponent = Owner->FindComponentByClass<URTSOrderComponent>();
     if (OrderComponent == nullptr)
     {
         return;
@@ -109,6 +155,7 @@ void URTSAutoOrderComponent::BeginPlay()
     }
 
     HumanPlayerAutoOrders.AddDefaulted(Orders.Num());
+    CachedTargets.SetNum(Orders.Num());
 
     // Only certain abilities are auto cast abilities for human players.
     for (int32 i = 0; i < Orders.Num(); ++i)
@@ -150,6 +197,14 @@ void URTSAutoOrderComponent::BeginPlay()
     // Listen for the appropriate order to enable auto orders.
     OrderComponent->OnOrderChanged.AddDynamic(this, &URTSAutoOrderComponent::OnOrderChanged);
 
+    // Tag changes might enable auto orders, e.g. when their cooldown expires.
+    AbilitySystem = Owner->FindComponentByClass<UAbilitySystemComponent>();
+    if (AbilitySystem.IsValid())
+    {
+        GameplayTagChangedHandle = AbilitySystem->RegisterGenericGameplayTagEvent().AddUObject(
+            this, &URTSAutoOrderComponent::OnGameplayTagChanged);
+    }
+
     // NOTE(np): In A Year Of Rain, units can change their owner at runtime (e.g. rescued units in story campaign).
     //URTSOwnerComponent* OwnerComponent = Owner->FindComponentByClass<URTSOwnerComponent>();
     //if (OwnerComponent != nullptr)
@@ -163,50 +218,183 @@ void URTSAutoOrderComponent::BeginPlay()
         bCheckAutoOrders = true;
     }
 
-    // NOTE(np): A Year Of Rain registers the actor with a manager for bucketed updates here, to improve performance.
-    //// Register actor with game.
-    //ARTSGameMode* GameMode = Cast<ARTSGameMode>(UGameplayStatics::GetGameMode(this));
-
-    //if (IsValid(GameMode))
-    //{
-    //    GameMode->AddAutoOrderActor(Owner);
-    //}
+    // Register with the scheduler of the world, which checks the auto orders of all units spread across frames.
+    FRTSAutoOrderScheduler* Scheduler = FRTSAutoOrderScheduler::Get(GetWorld());
+    if (Scheduler != nullptr)
+    {
+        Scheduler->AddAutoOrderComponent(this);
+    }
 }
 
-void URTSAutoOrderComponent::CheckAutoOrders()
+void URTSAutoOrderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    if (!bCheckAutoOrders)
+    if (AbilitySystem.IsValid())
     {
-        return;
+        AbilitySystem->RegisterGenericGameplayTagEvent().Remove(GameplayTagChangedHandle);
     }
 
-    AActor* Owner = GetOwner();
+    FRTSAutoOrderScheduler* Scheduler = FRTSAutoOrderScheduler::Find(GetWorld());
+    if (Scheduler != nullptr)
+    {
+        Scheduler->RemoveAutoOrderComponent(this);
+    }
 
-    // NOTE(np): A Year Of Rain distingushes between auto orders for human and AI.
-    //bool bIsAIUnit = URTSUtilities::IsAIUnit(Owner);
-    bool bIsAIUnit = false;
+    Super::EndPlay(EndPlayReason);
+}
+
+bool URTSAutoOrderComponent::CheckAutoOrders()
+{
+    bIssuedAutoOrderOnLastCheck = false;
+
+    if (!bCheckAutoOrders)
+    {
+        // Changing the order will wake up the unit again.
+        bIsAsleep = true;
+        return false;
+    }
 
     {
         SCOPE_CYCLE_COUNTER(STAT_RTSAutoOrderTargetAcquisition);
 
         for (int32 i = 0; i < Orders.Num(); ++i)
         {
-            if ((bIsAIUnit && AIPlayerAutoOrders[i]) ||
-                (!bIsAIUnit && HumanPlayerAutoOrders[i] && HumanPlayerAutoOrderStates[i]))
+            if (IsAutoOrderEnabled(i))
             {
                 FRTSOrderTypeWithIndex Order = Orders[i];
-                if (IssueAutoOrder(Order))
+                if (IssueAutoOrder(Order, CachedTargets[i]))
                 {
+                    bIssuedAutoOrderOnLastCheck = true;
                     break;
                 }
             }
         }
     }
+
+    // Nothing to do until something relevant changes around the unit.
+    bIsAsleep = !IsInCombat();
+
+    return bIssuedAutoOrderOnLastCheck;
+}
+
+bool URTSAutoOrderComponent::IsInCombat() const
+{
+    return bIssuedAutoOrderOnLastCheck ||
+           (OrderComponent != nullptr && OrderComponent->GetCurrentOrderTargetActor() != nullptr);
+}
+
+bool URTSAutoOrderComponent::IsAsleep() const
+{
+    return bIsAsleep;
+}
+
+void URTSAutoOrderComponent::WakeUp()
+{
+    if (!bIsAsleep)
+    {
+        return;
+    }
+
+    bIsAsleep = false;
+
+    // Asleep units aren't checked by the scheduler until they are woken up.
+    FRTSAutoOrderScheduler* Scheduler = FRTSAutoOrderScheduler::Find(GetWorld());
+    if (Scheduler != nullptr)
+    {
+        Scheduler->WakeUpAutoOrderComponent(this);
+    }
+}
+
+float URTSAutoOrderComponent::GetMaxAcquisitionRadius()
+{
+    float MaxAcquisitionRadius = 0.0f;
+
+    for (const FRTSOrderTypeWithIndex& Order : Orders)
+    {
+        MaxAcquisitionRadius = FMath::Max(MaxAcquisitionRadius, GetAcquisitionRadius(Order));
+    }
+
+    return MaxAcquisitionRadius;
+}
+
+uint64 URTSAutoOrderComponent::GetTargetRelationshipMask()
+{
+    static_assert((int32)ERTSRelationshipFlags::NUM_COMBINATIONS <= 64,
+                  "Relationship flag combinations don't fit into the target relationship mask.");
+
+    if (!bCheckAutoOrders || OrderComponent == nullptr)
+    {
+        return 0;
+    }
+
+    AActor* Owner = GetOwner();
+    FRTSRelationshipMatrix& RelationshipMatrix = FRTSRelationshipMatrix::Get();
+
+    uint64 Mask = 0;
+
+    for (int32 i = 0; i < Orders.Num(); ++i)
+    {
+        if (!IsAutoOrderEnabled(i))
+        {
+            continue;
+        }
+
+        const FRTSOrderTypeWithIndex& Order = Orders[i];
+
+        ERTSRelationshipFlags RequiredRelationship = ERTSRelationshipFlags::NONE;
+        ERTSRelationshipFlags BlockedRelationship = ERTSRelationshipFlags::NONE;
+
+        switch (URTSOrderHelper::GetTargetType(Order.OrderType, Owner, Order.Index))
+        {
+            case ERTSTargetType::NONE:
+                // Orders without target are issued when an enemy is nearby.
+                RequiredRelationship = ERTSRelationshipFlags::HOSTILE;
+                break;
+            case ERTSTargetType::ACTOR:
+            case ERTSTargetType::LOCATION:
+            case ERTSTargetType::DIRECTION:
+            {
+                const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order.OrderType);
+                if (OrderObject == nullptr)
+                {
+                    continue;
+                }
+
+                const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements =
+                    OrderComponent->GetTagRequirements(OrderObject, Order.Index);
+                RequiredRelationship = RelationshipMatrix.GetRelationshipFlags(TagRequirements->TargetRequiredTags);
+                BlockedRelationship = RelationshipMatrix.GetRelationshipFlags(TagRequirements->TargetBlockedTags);
+            }
+            break;
+            default:
+                continue;
+        }
+
+        RequiredRelationship &= ~ERTSRelationshipFlags::VISIBLE;
+        BlockedRelationship &= ~ERTSRelationshipFlags::VISIBLE;
+
+        for (int32 Combination = 0; Combination < (int32)ERTSRelationshipFlags::NUM_COMBINATIONS; ++Combination)
+        {
+            const ERTSRelationshipFlags Relationship = (ERTSRelationshipFlags)Combination;
+            if (EnumHasAllFlags(Relationship, RequiredRelationship) &&
+                !EnumHasAnyFlags(Relationship, BlockedRelationship))
+            {
+                Mask |= 1ull << Combination;
+            }
+        }
+    }
+
+    return Mask;
 }
 
 void URTSAutoOrderComponent::OnOrderChanged(const FRTSOrderData& NewOrder)
 {
     bCheckAutoOrders = URTSOrderHelper::AreAutoOrdersAllowedDuringOrder(NewOrder.OrderType);
+    WakeUp();
+}
+
+void URTSAutoOrderComponent::OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+    WakeUp();
 }
 
 void URTSAutoOrderComponent::OnOwnerChanged(APlayerState* PreviousOwner, APlayerState* NewOwner)
@@ -216,7 +404,6 @@ void URTSAutoOrderComponent::OnOwnerChanged(APlayerState* PreviousOwner, APlayer
         return;
     }
 
-    URTSOrderComponent* OrderComponent = GetOwner()->FindComponentByClass<URTSOrderComponent>();
     if (OrderComponent == nullptr)
     {
         return;
@@ -248,10 +435,21 @@ void URTSAutoOrderComponent::OnOwnerChanged(APlayerState* PreviousOwner, APlayer
     if (bHasAutoCastOrders)
     {
         bCheckAutoOrders = URTSOrderHelper::AreAutoOrdersAllowedDuringOrder(OrderComponent->GetCurrentOrderType());
+        WakeUp();
     }
 }
 
-bool URTSAutoOrderComponent::IssueAutoOrder(const FRTSOrderTypeWithIndex& Order)
+bool URTSAutoOrderComponent::IsAutoOrderEnabled(int32 OrderIndex) const
+{
+    // NOTE(np): A Year Of Rain distingushes between auto orders for human and AI.
+    //bool bIsAIUnit = URTSUtilities::IsAIUnit(GetOwner());
+    bool bIsAIUnit = false;
+
+    return (bIsAIUnit && AIPlayerAutoOrders[OrderIndex]) ||
+           (!bIsAIUnit && HumanPlayerAutoOrders[OrderIndex] && HumanPlayerAutoOrderStates[OrderIndex]);
+}
+
+bool URTSAutoOrderComponent::IssueAutoOrder(const FRTSOrderTypeWithIndex& Order, FCachedTarget& CachedTarget)
 {
     float AcquisitionRadius = GetAcquisitionRadius(Order);
 
@@ -261,7 +459,6 @@ bool URTSAutoOrderComponent::IssueAutoOrder(const FRTSOrderTypeWithIndex& Order)
         return false;
     }
 
-    URTSOrderComponent* OrderComponent = Owner->FindComponentByClass<URTSOrderComponent>();
     if (OrderComponent == nullptr)
     {
         return false;
@@ -285,9 +482,7 @@ bool URTSAutoOrderComponent::IssueAutoOrder(const FRTSOrderTypeWithIndex& Order)
         case ERTSTargetType::LOCATION:
         case ERTSTargetType::DIRECTION:
         {
-            float Score;
-            AActor* Target =
-                URTSOrderHelper::FindTargetForOrder(Order.OrderType, Owner, Order.Index, AcquisitionRadius, Score);
+            AActor* Target = FindTarget(Order, AcquisitionRadius, CachedTarget);
             if (Target != nullptr)
             {
                 OrderComponent->InsertOrderBeforeCurrentOrder(
@@ -326,3 +521,98 @@ float URTSAutoOrderComponent::GetAcquisitionRadius(const FRTSOrderTypeWithIndex&
     return AttackComponent->GetAcquisitionRadius();*/
     return 0.0f;
 }
+
+AActor* URTSAutoOrderComponent::FindTarget(const FRTSOrderTypeWithIndex& Order, float AcquisitionRadius,
+                                           FCachedTarget& CachedTarget)
+{
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order.OrderType);
+    if (OrderObject == nullptr)
+    {
+        return nullptr;
+    }
+
+    AActor* Owner = GetOwner();
+    const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements =
+        OrderComponent->GetTagRequirements(OrderObject, Order.Index);
+
+    const float Now = GetWorld()->GetTimeSeconds();
+    const bool bIsSearchDue =
+        Now - CachedTarget.SearchTime >= CVarRTSAutoOrderTargetSearchInterval.GetValueOnGameThread();
+
+    // Check whether the previous target is still valid and in range.
+    AActor* PreviousTarget = CachedTarget.Target.Get();
+    float PreviousTargetScore = 0.0f;
+    bool bIsPreviousTargetValid =
+        PreviousTarget != nullptr &&
+        URTSOrderHelper::RevalidateTargetForOrder(OrderObject, Owner, Order.Index, PreviousTarget, AcquisitionRadius,
+                                                  *TagRequirements, PreviousTargetScore);
+
+    if (bIsPreviousTargetValid && !bIsSearchDue)
+    {
+        INC_DWORD_STAT(STAT_RTSAutoOrderTargetCacheHits);
+        CachedTarget.Score = PreviousTargetScore;
+        return PreviousTarget;
+    }
+
+    if (PreviousTarget != nullptr && !bIsPreviousTargetValid)
+    {
+        INC_DWORD_STAT(STAT_RTSAutoOrderTargetCacheInvalidations);
+        CachedTarget.Target = nullptr;
+
+        // Fall back to the runner-ups of the last search before searching again.
+        while (!bIsSearchDue && CachedTarget.FallbackTargets.Num() > 0)
+        {
+            AActor* FallbackTarget = CachedTarget.FallbackTargets[0].Get();
+            CachedTarget.FallbackTargets.RemoveAt(0);
+
+            float FallbackTargetScore = 0.0f;
+            if (FallbackTarget != nullptr &&
+                URTSOrderHelper::RevalidateTargetForOrder(OrderObject, Owner, Order.Index, FallbackTarget,
+                                                          AcquisitionRadius, *TagRequirements, FallbackTargetScore))
+            {
+                INC_DWORD_STAT(STAT_RTSAutoOrderTargetCacheFallbacks);
+                CachedTarget.Target = FallbackTarget;
+                CachedTarget.Score = FallbackTargetScore;
+                return FallbackTarget;
+            }
+        }
+    }
+
+    INC_DWORD_STAT(STAT_RTSAutoOrderTargetSearches);
+
+    // Units close to each other share the targets gathered for this order in this frame.
+    TArray<FRTSScoredTarget> BestTargets;
+    FRTSTargetAcquisition* TargetAcquisition = FRTSTargetAcquisition::Get(GetWorld());
+
+    if (TargetAcquisition != nullptr)
+    {
+        TargetAcquisition->FindBestTargets(
+            FRTSTargetAcquisitionRequest(Owner, Order.OrderType, Order.Index, AcquisitionRadius),
+            1 + FMath::Max(CVarRTSAutoOrderFallbackTargets.GetValueOnGameThread(), 0), BestTargets);
+    }
+
+    AActor* Target = BestTargets.Num() > 0 ? BestTargets[0].Actor : nullptr;
+    float Score = BestTargets.Num() > 0 ? BestTargets[0].Score : 0.0f;
+
+    CachedTarget.SearchTime = Now;
+    CachedTarget.FallbackTargets.Reset();
+
+    for (int32 TargetIndex = 1; TargetIndex < BestTargets.Num(); ++TargetIndex)
+    {
+        CachedTarget.FallbackTargets.Add(BestTargets[TargetIndex].Actor);
+    }
+
+    // Don't switch back and forth between targets with similar scores.
+    if (bIsPreviousTargetValid && Target != PreviousTarget &&
+        Score <= PreviousTargetScore + FMath::Abs(PreviousTargetScore) *
+                                           CVarRTSAutoOrderTargetSwitchMargin.GetValueOnGameThread())
+    {
+        INC_DWORD_STAT(STAT_RTSAutoOrderTargetSwitchesSuppressed);
+        CachedTarget.Score = PreviousTargetScore;
+        return PreviousTarget;
+    }
+
+    CachedTarget.Target = Target;
+    CachedTarget.Score = Score;
+    return Target;
+}
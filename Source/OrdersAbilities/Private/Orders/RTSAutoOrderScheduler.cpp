@@ -0,0 +1,445 @@
+#include "Orders/RTSAutoOrderScheduler.h"
+
+#include "OrdersAbilities.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+#include "AbilitySystem/RTSRelationshipMatrix.h"
+#include "Orders/RTSAutoOrderComponent.h"
+#include "Orders/RTSSpatialHashGrid.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Auto Order Scheduler"), STAT_RTSAutoOrderScheduler, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Units Checked"), STAT_RTSAutoOrderUnitsChecked, STATGROUP_RTS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("RTS - Auto Order Max Staleness (ms)"), STAT_RTSAutoOrderMaxStaleness,
+                           STATGROUP_RTS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("RTS - Auto Order Units"), STAT_RTSAutoOrderUnits, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Units Awake"), STAT_RTSAutoOrderUnitsAwake, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Units Asleep"), STAT_RTSAutoOrderUnitsAsleep, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Auto Order Wakeups"), STAT_RTSAutoOrderWakeups, STATGROUP_RTS);
+
+static TAutoConsoleVariable<float> CVarRTSAutoOrderFrameBudget(
+    TEXT("RTS.AutoOrders.FrameBudgetMs"), 1.0f,
+    TEXT("Time that may be spent per frame for checking the auto orders of units, in milliseconds."), ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRTSAutoOrderMinIdleChecks(
+    TEXT("RTS.AutoOrders.MinIdleChecksPerFrame"), 1,
+    TEXT("Number of units out of combat whose auto orders are checked per frame, even if units in combat have used up "
+         "the whole time budget."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSAutoOrderMaxSleepTime(
+    TEXT("RTS.AutoOrders.MaxSleepSeconds"), 5.0f,
+    TEXT("Time after which asleep units check their auto orders again, even if nothing relevant has happened, in "
+         "seconds. Catches changes that don't wake up units, e.g. tag changes of potential targets. 0 to disable."),
+    ECVF_Default);
+
+
+FRTSAutoOrderScheduler::FRTSAutoOrderScheduler()
+    : NextCombatIndex(0)
+    , NextIdleIndex(0)
+{
+}
+
+FRTSAutoOrderScheduler::~FRTSAutoOrderScheduler()
+{
+    // Grids are destroyed along with their world, so there's nothing to unregister from if the world is gone.
+    FRTSSpatialHashGrid* Grid = GridWorld.IsValid() ? FRTSSpatialHashGrid::Find(GridWorld.Get()) : nullptr;
+    if (Grid != nullptr)
+    {
+        Grid->OnActorEnteredCell.Remove(ActorEnteredCellHandle);
+    }
+}
+
+FRTSAutoOrderScheduler* FRTSAutoOrderScheduler::Get(UWorld* World)
+{
+    // Check auto orders once per frame.
+    static FDelegateHandle WorldPreActorTickHandle;
+    if (!WorldPreActorTickHandle.IsValid())
+    {
+        WorldPreActorTickHandle =
+            FWorldDelegates::OnWorldPreActorTick.AddStatic(&FRTSAutoOrderScheduler::OnWorldPreActorTick);
+    }
+
+    return GetWorldSchedulers().FindOrAdd(World);
+}
+
+FRTSAutoOrderScheduler* FRTSAutoOrderScheduler::Find(const UWorld* World)
+{
+    return GetWorldSchedulers().Find(World);
+}
+
+void FRTSAutoOrderScheduler::AddAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent)
+{
+    if (AutoOrderComponent == nullptr)
+    {
+        return;
+    }
+
+    FScheduledComponent ScheduledComponent;
+    ScheduledComponent.AutoOrderComponent = AutoOrderComponent;
+    ScheduledComponent.LastCheckTime = FPlatformTime::Seconds();
+    ScheduledComponent.LastCheckFrame = 0;
+
+    IdleComponents.Add(ScheduledComponent);
+
+    INC_DWORD_STAT(STAT_RTSAutoOrderUnits);
+}
+
+void FRTSAutoOrderScheduler::RemoveAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent)
+{
+    if (RemoveAwakeComponent(CombatComponents, NextCombatIndex, AutoOrderComponent) ||
+        RemoveAwakeComponent(IdleComponents, NextIdleIndex, AutoOrderComponent))
+    {
+        DEC_DWORD_STAT(STAT_RTSAutoOrderUnits);
+        return;
+    }
+
+    TWeakObjectPtr<URTSAutoOrderComponent> WeakAutoOrderComponent(AutoOrderComponent);
+    FSleepingComponent SleepingComponent;
+
+    if (SleepingComponents.RemoveAndCopyValue(WeakAutoOrderComponent, SleepingComponent))
+    {
+        StopWatchingCells(WeakAutoOrderComponent, SleepingComponent);
+        DEC_DWORD_STAT(STAT_RTSAutoOrderUnits);
+    }
+}
+
+void FRTSAutoOrderScheduler::WakeUpAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent)
+{
+    TWeakObjectPtr<URTSAutoOrderComponent> WeakAutoOrderComponent(AutoOrderComponent);
+    FSleepingComponent SleepingComponent;
+
+    if (!SleepingComponents.RemoveAndCopyValue(WeakAutoOrderComponent, SleepingComponent))
+    {
+        return;
+    }
+
+    INC_DWORD_STAT(STAT_RTSAutoOrderWakeups);
+
+    StopWatchingCells(WeakAutoOrderComponent, SleepingComponent);
+    IdleComponents.Add(SleepingComponent.ScheduledComponent);
+
+    // Units notify the scheduler when they wake up themselves, which does nothing now that the unit is awake.
+    AutoOrderComponent->WakeUp();
+}
+
+void FRTSAutoOrderScheduler::Tick()
+{
+    SCOPE_CYCLE_COUNTER(STAT_RTSAutoOrderScheduler);
+
+    WakeUpOversleptComponents(FPlatformTime::Seconds());
+
+    SET_DWORD_STAT(STAT_RTSAutoOrderUnitsAsleep, SleepingComponents.Num());
+    SET_DWORD_STAT(STAT_RTSAutoOrderUnitsAwake, CombatComponents.Num() + IdleComponents.Num());
+
+    if (CombatComponents.Num() == 0 && IdleComponents.Num() == 0)
+    {
+        return;
+    }
+
+    const double EndTime = FPlatformTime::Seconds() + CVarRTSAutoOrderFrameBudget.GetValueOnGameThread() / 1000.0;
+
+    int32 NumChecked = 0;
+    float MaxStalenessMs = 0.0f;
+
+    // Units in combat are most likely to find new targets, so check them first.
+    CheckComponents(true, EndTime, 0, NumChecked, MaxStalenessMs);
+    CheckComponents(false, EndTime, CVarRTSAutoOrderMinIdleChecks.GetValueOnGameThread(), NumChecked, MaxStalenessMs);
+
+    INC_DWORD_STAT_BY(STAT_RTSAutoOrderUnitsChecked, NumChecked);
+    SET_FLOAT_STAT(STAT_RTSAutoOrderMaxStaleness, MaxStalenessMs);
+}
+
+void FRTSAutoOrderScheduler::CheckComponents(bool bInCombat, double EndTime, int32 MinChecks, int32& InOutNumChecked,
+                                             float& InOutMaxStalenessMs)
+{
+    TArray<FScheduledComponent>& Components = bInCombat ? CombatComponents : IdleComponents;
+    TArray<FScheduledComponent>& OtherComponents = bInCombat ? IdleComponents : CombatComponents;
+    int32& NextIndex = bInCombat ? NextCombatIndex : NextIdleIndex;
+
+    const int32 NumCheckedBefore = InOutNumChecked;
+
+    // Visit every unit at most once per frame. Units that leave the list are replaced by the next one at their index.
+    const int32 NumToVisit = Components.Num();
+
+    for (int32 NumVisited = 0; NumVisited < NumToVisit && Components.Num() > 0; ++NumVisited)
+    {
+        if (NextIndex >= Components.Num())
+        {
+            NextIndex = 0;
+        }
+
+        FScheduledComponent& ScheduledComponent = Components[NextIndex];
+
+        URTSAutoOrderComponent* AutoOrderComponent = ScheduledComponent.AutoOrderComponent.Get();
+        if (AutoOrderComponent == nullptr)
+        {
+            // Unit has been destroyed without being removed.
+            Components.RemoveAt(NextIndex);
+            DEC_DWORD_STAT(STAT_RTSAutoOrderUnits);
+            continue;
+        }
+
+        // Units that have changed lists in this frame have been checked already.
+        if (ScheduledComponent.LastCheckFrame == GFrameCounter)
+        {
+            ++NextIndex;
+            continue;
+        }
+
+        const double Now = FPlatformTime::Seconds();
+        if (Now >= EndTime && InOutNumChecked - NumCheckedBefore >= MinChecks)
+        {
+            // Continue with this unit next frame.
+            return;
+        }
+
+        InOutMaxStalenessMs =
+            FMath::Max(InOutMaxStalenessMs, (float)((Now - ScheduledComponent.LastCheckTime) * 1000.0));
+
+        ScheduledComponent.LastCheckTime = Now;
+        ScheduledComponent.LastCheckFrame = GFrameCounter;
+
+        AutoOrderComponent->CheckAutoOrders();
+        ++InOutNumChecked;
+
+        // Issuing auto orders might have destroyed the unit, which removes it and adjusts 'NextIndex'.
+        if (!Components.IsValidIndex(NextIndex) || Components[NextIndex].AutoOrderComponent != AutoOrderComponent)
+        {
+            continue;
+        }
+
+        if (AutoOrderComponent->IsAsleep() && PutToSleep(Components[NextIndex], AutoOrderComponent))
+        {
+            Components.RemoveAt(NextIndex);
+        }
+        else if (AutoOrderComponent->IsInCombat() != bInCombat)
+        {
+            // Keep the order of the remaining units, so none of them is skipped in this round.
+            OtherComponents.Add(Components[NextIndex]);
+            Components.RemoveAt(NextIndex);
+        }
+        else
+        {
+            ++NextIndex;
+        }
+    }
+}
+
+bool FRTSAutoOrderScheduler::RemoveAwakeComponent(TArray<FScheduledComponent>& Components, int32& NextIndex,
+                                                  const URTSAutoOrderComponent* AutoOrderComponent)
+{
+    for (int32 Index = 0; Index < Components.Num(); ++Index)
+    {
+        if (Components[Index].AutoOrderComponent == AutoOrderComponent)
+        {
+            // Keep the order of the remaining units, so none of them is skipped in this round.
+            Components.RemoveAt(Index);
+            NextIndex -= NextIndex > Index ? 1 : 0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FRTSAutoOrderScheduler::WakeUpOversleptComponents(double Now)
+{
+    const float MaxSleepTime = CVarRTSAutoOrderMaxSleepTime.GetValueOnGameThread();
+
+    // Units fall asleep in chronological order, so only the ones at the front of the queue can have overslept.
+    FSleepStart SleepStart;
+
+    while (SleepStarts.Peek(SleepStart))
+    {
+        const TWeakObjectPtr<URTSAutoOrderComponent>& WeakAutoOrderComponent = SleepStart.AutoOrderComponent;
+        const FSleepingComponent* SleepingComponent = SleepingComponents.Find(WeakAutoOrderComponent);
+
+        // Units might have woken up, and fallen asleep again, in the meantime.
+        const bool bIsOutdated = SleepingComponent == nullptr ||
+                                 SleepingComponent->ScheduledComponent.LastCheckTime != SleepStart.SleepTime;
+
+        if (!bIsOutdated && MaxSleepTime > 0.0f && Now - SleepStart.SleepTime < MaxSleepTime)
+        {
+            return;
+        }
+
+        SleepStarts.Pop();
+
+        if (bIsOutdated || MaxSleepTime <= 0.0f)
+        {
+            continue;
+        }
+
+        URTSAutoOrderComponent* AutoOrderComponent = WeakAutoOrderComponent.Get();
+        if (AutoOrderComponent == nullptr)
+        {
+            // Unit has been destroyed without being removed.
+            FSleepingComponent DestroyedComponent;
+            SleepingComponents.RemoveAndCopyValue(WeakAutoOrderComponent, DestroyedComponent);
+            StopWatchingCells(WeakAutoOrderComponent, DestroyedComponent);
+            DEC_DWORD_STAT(STAT_RTSAutoOrderUnits);
+            continue;
+        }
+
+        // Wake up units that have been asleep for too long, in case they have missed anything relevant.
+        WakeUpAutoOrderComponent(AutoOrderComponent);
+    }
+}
+
+bool FRTSAutoOrderScheduler::PutToSleep(const FScheduledComponent& ScheduledComponent,
+                                        URTSAutoOrderComponent* AutoOrderComponent)
+{
+    FSleepingComponent SleepingComponent;
+    SleepingComponent.ScheduledComponent = ScheduledComponent;
+    SleepingComponent.Owner = AutoOrderComponent->GetOwner();
+    SleepingComponent.TargetRelationshipMask = AutoOrderComponent->GetTargetRelationshipMask();
+
+    UWorld* World = SleepingComponent.Owner != nullptr ? SleepingComponent.Owner->GetWorld() : nullptr;
+    FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(World);
+
+    if (Grid != nullptr)
+    {
+        Grid->GetCellsInRadius(SleepingComponent.Owner->GetActorLocation(),
+                               AutoOrderComponent->GetMaxAcquisitionRadius(), SleepingComponent.WatchedCells);
+
+        // Potential targets might come in range without entering another cell, so stay awake while there are any.
+        TArray<AActor*> CellActors;
+        Grid->GetActorsInCells(SleepingComponent.WatchedCells, CellActors);
+
+        for (const AActor* Actor : CellActors)
+        {
+            if (Actor != SleepingComponent.Owner && IsPotentialTarget(SleepingComponent, Actor))
+            {
+                // Units notify the scheduler when they wake up themselves, which does nothing as the unit is awake.
+                AutoOrderComponent->WakeUp();
+                return false;
+            }
+        }
+
+        // Get notified about actors entering cells.
+        if (GridWorld != World)
+        {
+            GridWorld = World;
+            ActorEnteredCellHandle =
+                Grid->OnActorEnteredCell.AddRaw(this, &FRTSAutoOrderScheduler::OnActorEnteredCell);
+        }
+    }
+
+    StartWatchingCells(ScheduledComponent.AutoOrderComponent, SleepingComponent);
+    SleepingComponents.Add(ScheduledComponent.AutoOrderComponent, SleepingComponent);
+
+    FSleepStart SleepStart;
+    SleepStart.AutoOrderComponent = ScheduledComponent.AutoOrderComponent;
+    SleepStart.SleepTime = ScheduledComponent.LastCheckTime;
+    SleepStarts.Enqueue(SleepStart);
+
+    return true;
+}
+
+void FRTSAutoOrderScheduler::StartWatchingCells(const TWeakObjectPtr<URTSAutoOrderComponent>& AutoOrderComponent,
+                                                const FSleepingComponent& SleepingComponent)
+{
+    for (const FIntPoint& Cell : SleepingComponent.WatchedCells)
+    {
+        SleepingComponentsByCell.FindOrAdd(Cell).Add(AutoOrderComponent);
+    }
+
+    if (SleepingComponent.Owner != nullptr)
+    {
+        SleepingComponentsByOwner.Add(SleepingComponent.Owner, AutoOrderComponent);
+    }
+}
+
+void FRTSAutoOrderScheduler::StopWatchingCells(const TWeakObjectPtr<URTSAutoOrderComponent>& AutoOrderComponent,
+                                               const FSleepingComponent& SleepingComponent)
+{
+    for (const FIntPoint& Cell : SleepingComponent.WatchedCells)
+    {
+        TArray<TWeakObjectPtr<URTSAutoOrderComponent>>* CellComponents = SleepingComponentsByCell.Find(Cell);
+        if (CellComponents == nullptr)
+        {
+            continue;
+        }
+
+        CellComponents->RemoveSingleSwap(AutoOrderComponent, false);
+
+        if (CellComponents->Num() == 0)
+        {
+            SleepingComponentsByCell.Remove(Cell);
+        }
+    }
+
+    if (SleepingComponent.Owner != nullptr)
+    {
+        SleepingComponentsByOwner.Remove(SleepingComponent.Owner);
+    }
+}
+
+bool FRTSAutoOrderScheduler::IsPotentialTarget(const FSleepingComponent& SleepingComponent, const AActor* Actor) const
+{
+    const ERTSRelationshipFlags Relationship =
+        FRTSRelationshipMatrix::Get().GetRelationship(SleepingComponent.Owner, Actor);
+    return (SleepingComponent.TargetRelationshipMask & (1ull << (int32)Relationship)) != 0;
+}
+
+void FRTSAutoOrderScheduler::OnActorEnteredCell(AActor* Actor, const FIntPoint& Cell)
+{
+    // Units that move have new surroundings.
+    URTSAutoOrderComponent* MovedComponent = SleepingComponentsByOwner.FindRef(Actor).Get();
+    if (MovedComponent != nullptr)
+    {
+        WakeUpAutoOrderComponent(MovedComponent);
+    }
+
+    const TArray<TWeakObjectPtr<URTSAutoOrderComponent>>* CellComponents = SleepingComponentsByCell.Find(Cell);
+    if (CellComponents == nullptr)
+    {
+        return;
+    }
+
+    TArray<URTSAutoOrderComponent*> ComponentsToWakeUp;
+
+    for (const TWeakObjectPtr<URTSAutoOrderComponent>& WeakAutoOrderComponent : *CellComponents)
+    {
+        URTSAutoOrderComponent* AutoOrderComponent = WeakAutoOrderComponent.Get();
+        const FSleepingComponent* SleepingComponent = SleepingComponents.Find(WeakAutoOrderComponent);
+
+        if (AutoOrderComponent != nullptr && SleepingComponent != nullptr &&
+            IsPotentialTarget(*SleepingComponent, Actor))
+        {
+            ComponentsToWakeUp.Add(AutoOrderComponent);
+        }
+    }
+
+    // Waking up units modifies the watched cells.
+    for (URTSAutoOrderComponent* AutoOrderComponent : ComponentsToWakeUp)
+    {
+        WakeUpAutoOrderComponent(AutoOrderComponent);
+    }
+}
+
+TRTSPerWorld<FRTSAutoOrderScheduler>& FRTSAutoOrderScheduler::GetWorldSchedulers()
+{
+    static TRTSPerWorld<FRTSAutoOrderScheduler> WorldSchedulers;
+    return WorldSchedulers;
+}
+
+void FRTSAutoOrderScheduler::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    // Units used to be checked in the tick of the game mode, which doesn't happen while paused.
+    if (World == nullptr || World->IsPaused())
+    {
+        return;
+    }
+
+    FRTSAutoOrderScheduler* Scheduler = Find(World);
+    if (Scheduler != nullptr)
+    {
+        Scheduler->Tick();
+    }
+}
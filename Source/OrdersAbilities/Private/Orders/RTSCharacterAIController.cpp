@@ -2,13 +2,18 @@
 
 #include "OrdersAbilities.h"
 
+#include "AITypes.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "GameFramework/Controller.h"
 
+#include "AbilitySystem/RTSAbilitySystemHelper.h"
 #include "Orders/RTSBlackboardHelper.h"
 #include "Orders/RTSOrder.h"
+#include "Orders/RTSOrderComponent.h"
 #include "Orders/RTSOrderHelper.h"
+#include "Orders/RTSOrderResultDispatcher.h"
+#include "Orders/RTSOrderTypeRegistry.h"
 #include "Orders/RTSOrderWithBehavior.h"
 #include "Orders/RTSStopOrder.h"
 
@@ -16,28 +21,102 @@
 ARTSCharacterAIController::ARTSCharacterAIController(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
 {
+    // Results of behavior trees are reported by FRTSOrderResultDispatcher, so the controller only needs to tick for
+    // rotating towards its focus. The tick is enabled while a focus is set.
     PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
+
+    BehaviorTreeResult = EBTNodeResult::InProgress;
+    bHasPendingOrder = false;
 }
 
 void ARTSCharacterAIController::Possess(APawn* InPawn)
 {
     Super::Possess(InPawn);
 
-    // Load assets.
-    StopOrder.LoadSynchronous();
+    // Units get their team from the controller possessing them.
+    URTSAbilitySystemHelper::NotifyOnTeamChanged(InPawn);
+
+    // Load assets without blocking the game thread.
+    TArray<FSoftObjectPath> OrderTypePaths;
+    OrderTypePaths.Add(StopOrder.ToSoftObjectPath());
+
+    FRTSOrderTypeRegistry::Get().LoadAsync(
+        OrderTypePaths, FStreamableDelegate::CreateUObject(this, &ARTSCharacterAIController::InitializeOrderBehavior));
+}
+
+void ARTSCharacterAIController::UnPossess()
+{
+    APawn* PreviousPawn = GetPawn();
+
+    Super::UnPossess();
+
+    URTSAbilitySystemHelper::NotifyOnTeamChanged(PreviousPawn);
+}
+
+void ARTSCharacterAIController::InitializeOrderBehavior()
+{
+    APawn* ControlledPawn = GetPawn();
+    if (ControlledPawn == nullptr)
+    {
+        return;
+    }
 
     // Make AI use assigned blackboard.
     UBlackboardComponent* BlackboardComponent;
 
+    // Orders issued before the stop order has been loaded have been held back. Start with the latest of them, so its
+    // callback receives the result of the right behavior tree.
+    const bool bApplyPendingOrder = bHasPendingOrder;
+    FRTSOrderData Order = bApplyPendingOrder ? PendingOrder : FRTSOrderData(StopOrder.Get());
+    FVector HomeLocation = bApplyPendingOrder ? PendingOrderHomeLocation : ControlledPawn->GetActorLocation();
+
+    bHasPendingOrder = false;
+    PendingOrder = FRTSOrderData();
+
     if (UseBlackboard(CharacterBlackboardAsset, BlackboardComponent))
     {
         // Setup blackboard.
-        SetBlackboardValues(FRTSOrderData(StopOrder.Get()), InPawn->GetActorLocation());
+        SetBlackboardValues(Order, HomeLocation);
     }
 
     // Call RunBehaviorTree. This will setup the behavior tree component.
-    UBehaviorTree* BehaviorTree = URTSOrderHelper::GetBehaviorTree(StopOrder.Get());
+    UBehaviorTree* BehaviorTree = URTSOrderHelper::GetBehaviorTree(Order.OrderType.Get());
     RunBehaviorTree(BehaviorTree);
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+    URTSOrderComponent* OrderComponent = ControlledPawn->FindComponentByClass<URTSOrderComponent>();
+    if (bApplyPendingOrder && OrderComponent != nullptr)
+    {
+        OrderComponent->TraceOrderLifecycleStage(ERTSOrderLifecycleStage::APPLIED);
+    }
+#endif
+}
+
+void ARTSCharacterAIController::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    // Stop ticking if the focus actor has been destroyed.
+    UpdateTickEnabled();
+}
+
+void ARTSCharacterAIController::SetFocalPoint(FVector NewFocus, EAIFocusPriority::Type InPriority)
+{
+    Super::SetFocalPoint(NewFocus, InPriority);
+    UpdateTickEnabled();
+}
+
+void ARTSCharacterAIController::SetFocus(AActor* NewFocus, EAIFocusPriority::Type InPriority)
+{
+    Super::SetFocus(NewFocus, InPriority);
+    UpdateTickEnabled();
+}
+
+void ARTSCharacterAIController::ClearFocus(EAIFocusPriority::Type InPriority)
+{
+    Super::ClearFocus(InPriority);
+    UpdateTickEnabled();
 }
 
 TSubclassOf<AActor> ARTSCharacterAIController::GetBuildingClass() const
@@ -87,6 +166,15 @@ void ARTSCharacterAIController::IssueOrder(const FRTSOrderData& Order, FRTSOrder
     CurrentOrderResultCallback = Callback;
     BehaviorTreeResult = EBTNodeResult::InProgress;
 
+    if (BrainComponent == nullptr)
+    {
+        // Behavior tree not set up yet, apply the order as soon as the stop order has been loaded.
+        bHasPendingOrder = true;
+        PendingOrder = Order;
+        PendingOrderHomeLocation = HomeLocation;
+        return;
+    }
+
     SetBlackboardValues(Order, HomeLocation);
 
     // Stop any current orders and start over.
@@ -105,18 +193,23 @@ void ARTSCharacterAIController::BehaviorTreeEnded(EBTNodeResult::Type Result)
         return;
     }
 
-    switch (Result)
+    if (Result != EBTNodeResult::Failed && Result != EBTNodeResult::Succeeded)
     {
-        case EBTNodeResult::InProgress:
-            return;
-        case EBTNodeResult::Failed:
-            BehaviorTreeResult = EBTNodeResult::Failed;
-            return;
-        case EBTNodeResult::Aborted:
-            return;
-        case EBTNodeResult::Succeeded:
-            BehaviorTreeResult = EBTNodeResult::Succeeded;
-            return;
+        return;
+    }
+
+    // Report the result in the next frame, outside of the behavior tree. The result is dropped if another order is
+    // issued in the meantime. Only schedule once, even if the tree ends again before.
+    const bool bIsScheduled = BehaviorTreeResult != EBTNodeResult::InProgress;
+    BehaviorTreeResult = Result;
+
+    if (!bIsScheduled)
+    {
+        FRTSOrderResultDispatcher* Dispatcher = FRTSOrderResultDispatcher::Get(GetWorld());
+        if (Dispatcher != nullptr)
+        {
+            Dispatcher->ScheduleOrderResult(this);
+        }
     }
 }
 
@@ -130,6 +223,15 @@ FVector ARTSCharacterAIController::GetHomeLocation()
     return Blackboard->GetValueAsVector(URTSBlackboardHelper::BLACKBOARD_KEY_HOME_LOCATION);
 }
 
+void ARTSCharacterAIController::UpdateTickEnabled()
+{
+    const bool bHasFocus = FAISystem::IsValidLocation(GetFocalPoint());
+    if (IsActorTickEnabled() != bHasFocus)
+    {
+        SetActorTickEnabled(bHasFocus);
+    }
+}
+
 void ARTSCharacterAIController::SetBlackboardValues(const FRTSOrderData& Order, const FVector& HomeLocation)
 {
     if (!VerifyBlackboard())
@@ -177,6 +279,15 @@ void ARTSCharacterAIController::ApplyOrder(const FRTSOrderData& Order, UBehavior
             BehaviorTreeComponent->StartTree(*BehaviorTree, EBTExecutionMode::SingleRun);
         }
     }
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+    URTSOrderComponent* OrderComponent =
+        GetPawn() != nullptr ? GetPawn()->FindComponentByClass<URTSOrderComponent>() : nullptr;
+    if (OrderComponent != nullptr)
+    {
+        OrderComponent->TraceOrderLifecycleStage(ERTSOrderLifecycleStage::APPLIED);
+    }
+#endif
 }
 
 bool ARTSCharacterAIController::VerifyBlackboard() const
@@ -193,16 +304,19 @@ bool ARTSCharacterAIController::VerifyBlackboard() const
     return true;
 }
 
-void ARTSCharacterAIController::Tick(float DeltaTime)
+void ARTSCharacterAIController::DispatchOrderResult()
 {
-    Super::Tick(DeltaTime);
+    // Reset the result first, as the callback usually issues the next order. Also allows scheduling later results, if
+    // this one can't be reported.
+    EBTNodeResult::Type Result = BehaviorTreeResult;
+    BehaviorTreeResult = EBTNodeResult::InProgress;
 
     if (Blackboard == nullptr)
     {
         return;
     }
 
-    switch (BehaviorTreeResult)
+    switch (Result)
     {
         case EBTNodeResult::InProgress:
             break;
@@ -215,6 +329,4 @@ void ARTSCharacterAIController::Tick(float DeltaTime)
             CurrentOrderResultCallback.Broadcast(ERTSOrderResult::SUCCEEDED);
             break;
     }
-
-    BehaviorTreeResult = EBTNodeResult::InProgress;
 }
@@ -0,0 +1,41 @@
+#include "Orders/RTSCompiledOrderTagRequirements.h"
+
+
+const FRTSCompiledOrderTagRequirements FRTSCompiledOrderTagRequirements::EMPTY_COMPILED_TAG_REQUIREMENTS;
+
+
+FRTSCompiledOrderTagRequirements::FRTSCompiledOrderTagRequirements()
+{
+}
+
+FRTSCompiledOrderTagRequirements::FRTSCompiledOrderTagRequirements(
+    const FRTSOrderTagRequirements& InTagRequirements)
+    : FRTSOrderTagRequirements(InTagRequirements)
+{
+    Compile();
+}
+
+void FRTSCompiledOrderTagRequirements::Compile()
+{
+    SourceRequiredTagBits.Reset();
+    SourceRequiredTagBits.AddTags(SourceRequiredTags);
+
+    SourceBlockedTagBits.Reset();
+    SourceBlockedTagBits.AddTags(SourceBlockedTags);
+
+    TargetRequiredTagBits.Reset();
+    TargetRequiredTagBits.AddTags(TargetRequiredTags);
+
+    TargetBlockedTagBits.Reset();
+    TargetBlockedTagBits.AddTags(TargetBlockedTags);
+}
+
+bool FRTSCompiledOrderTagRequirements::DoesSatisfySourceRequirements(const FRTSTagBitset& SourceTags) const
+{
+    return !SourceTags.HasAny(SourceBlockedTagBits) && SourceTags.HasAll(SourceRequiredTagBits);
+}
+
+bool FRTSCompiledOrderTagRequirements::DoesSatisfyTargetRequirements(const FRTSTagBitset& TargetTags) const
+{
+    return !TargetTags.HasAny(TargetBlockedTagBits) && TargetTags.HasAll(TargetRequiredTagBits);
+}
@@ -0,0 +1,345 @@
+#include "Orders/RTSFlowField.h"
+
+#include "OrdersAbilities.h"
+
+#include "NavigationData.h"
+#include "HAL/PlatformTime.h"
+
+
+const float FRTSFlowField::PROJECTION_HEIGHT = 5000.0f;
+
+
+FRTSFlowField::FRTSFlowField(const FVector& InDestination, float InCellSize, int32 InHalfExtentInCells)
+    : Destination(InDestination)
+    , CellSize(FMath::Max(InCellSize, 1.0f))
+    , HalfExtentInCells(FMath::Max(InHalfExtentInCells, 0))
+    , bIsValid(false)
+    , BuildTime(0.0)
+    , BuildStep(EBuildStep::PROJECT_CELLS)
+    , NextBuildCell(0)
+{
+    NumCellsPerAxis = HalfExtentInCells * 2 + 1;
+
+    // Center the destination in its cell.
+    Origin = Destination - FVector((HalfExtentInCells + 0.5f) * CellSize, (HalfExtentInCells + 0.5f) * CellSize, 0.0f);
+}
+
+bool FRTSFlowField::Build(const ANavigationData* NavData, double EndTime)
+{
+    check(IsInGameThread());
+
+    if (BuildStep == EBuildStep::DONE)
+    {
+        return true;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 NumCells = NumCellsPerAxis * NumCellsPerAxis;
+
+    if (BuildStep == EBuildStep::PROJECT_CELLS && NextBuildCell == 0)
+    {
+        CellFlags.SetNumZeroed(NumCells);
+        CellLocations.SetNumZeroed(NumCells);
+        NextCells.Init(INDEX_NONE, NumCells);
+    }
+
+    // The navigation data might have been removed while building.
+    bool bIsStepDone = NavData == nullptr;
+
+    if (bIsStepDone)
+    {
+        BuildStep = EBuildStep::DONE;
+    }
+
+    while (BuildStep != EBuildStep::DONE)
+    {
+        switch (BuildStep)
+        {
+            case EBuildStep::PROJECT_CELLS:
+                bIsStepDone = ProjectCells(NavData, EndTime);
+                break;
+            case EBuildStep::CONNECT_CELLS:
+                bIsStepDone = ConnectCells(NavData, EndTime);
+                break;
+            case EBuildStep::FIND_PATHS:
+                bIsStepDone = FindPaths(EndTime);
+                break;
+            default:
+                check(0);
+                break;
+        }
+
+        if (!bIsStepDone)
+        {
+            break;
+        }
+
+        BuildStep = (EBuildStep)((uint8)BuildStep + 1);
+        NextBuildCell = 0;
+    }
+
+    BuildTime += FPlatformTime::Seconds() - StartTime;
+
+    if (BuildStep == EBuildStep::DONE)
+    {
+        Costs.Empty();
+        OpenCells.Empty();
+        return true;
+    }
+
+    return false;
+}
+
+bool FRTSFlowField::IsBuilt() const
+{
+    return BuildStep == EBuildStep::DONE;
+}
+
+bool FRTSFlowField::ProjectCells(const ANavigationData* NavData, double EndTime)
+{
+    FSharedConstNavQueryFilter QueryFilter = NavData->GetDefaultQueryFilter();
+    const FVector ProjectionExtent(CellSize / 2, CellSize / 2, PROJECTION_HEIGHT);
+    const int32 NumCells = NumCellsPerAxis * NumCellsPerAxis;
+
+    // Find all walkable cells.
+    for (; NextBuildCell < NumCells; ++NextBuildCell)
+    {
+        if (NextBuildCell % CELLS_PER_TIME_CHECK == 0 && FPlatformTime::Seconds() >= EndTime)
+        {
+            return false;
+        }
+
+        const int32 X = NextBuildCell % NumCellsPerAxis;
+        const int32 Y = NextBuildCell / NumCellsPerAxis;
+        const FVector CellCenter = Origin + FVector((X + 0.5f) * CellSize, (Y + 0.5f) * CellSize, 0.0f);
+
+        FNavLocation ProjectedLocation;
+        if (NavData->ProjectPoint(CellCenter, ProjectedLocation, ProjectionExtent, QueryFilter))
+        {
+            CellFlags[NextBuildCell] |= CELL_WALKABLE;
+            CellLocations[NextBuildCell] = ProjectedLocation.Location;
+        }
+    }
+
+    return true;
+}
+
+bool FRTSFlowField::ConnectCells(const ANavigationData* NavData, double EndTime)
+{
+    FSharedConstNavQueryFilter QueryFilter = NavData->GetDefaultQueryFilter();
+    const int32 NumCells = NumCellsPerAxis * NumCellsPerAxis;
+
+    // Connect walkable neighbors without obstacles in between.
+    for (; NextBuildCell < NumCells; ++NextBuildCell)
+    {
+        if (NextBuildCell % CELLS_PER_TIME_CHECK == 0 && FPlatformTime::Seconds() >= EndTime)
+        {
+            return false;
+        }
+
+        const int32 CellIndex = NextBuildCell;
+        if ((CellFlags[CellIndex] & CELL_WALKABLE) == 0)
+        {
+            continue;
+        }
+
+        const int32 X = CellIndex % NumCellsPerAxis;
+        const int32 Y = CellIndex / NumCellsPerAxis;
+
+        FVector HitLocation;
+
+        const int32 NeighborX = GetCellIndex(X + 1, Y);
+        if (NeighborX != INDEX_NONE && (CellFlags[NeighborX] & CELL_WALKABLE) != 0 &&
+            !NavData->Raycast(CellLocations[CellIndex], CellLocations[NeighborX], HitLocation, QueryFilter))
+        {
+            CellFlags[CellIndex] |= CELL_OPEN_POSITIVE_X;
+        }
+
+        const int32 NeighborY = GetCellIndex(X, Y + 1);
+        if (NeighborY != INDEX_NONE && (CellFlags[NeighborY] & CELL_WALKABLE) != 0 &&
+            !NavData->Raycast(CellLocations[CellIndex], CellLocations[NeighborY], HitLocation, QueryFilter))
+        {
+            CellFlags[CellIndex] |= CELL_OPEN_POSITIVE_Y;
+        }
+    }
+
+    return true;
+}
+
+bool FRTSFlowField::FindPaths(double EndTime)
+{
+    const int32 DestinationIndex = GetCellIndex(HalfExtentInCells, HalfExtentInCells);
+
+    // Find the shortest paths of all cells to the destination, starting at the destination (Dijkstra).
+    if (NextBuildCell == 0)
+    {
+        if ((CellFlags[DestinationIndex] & CELL_WALKABLE) == 0)
+        {
+            return true;
+        }
+
+        Costs.Init(MAX_FLT, NumCellsPerAxis * NumCellsPerAxis);
+        Costs[DestinationIndex] = 0.0f;
+
+        OpenCells.Reset();
+        OpenCells.Add(FOpenCell(0.0f, DestinationIndex));
+    }
+
+    const int32 NEIGHBOR_OFFSETS_X[] = {1, 0, -1, 0, 1, -1, -1, 1};
+    const int32 NEIGHBOR_OFFSETS_Y[] = {0, 1, 0, -1, 1, 1, -1, -1};
+    const float DiagonalCost = FMath::Sqrt(2.0f);
+    const float NEIGHBOR_COSTS[] = {1.0f, 1.0f, 1.0f, 1.0f, DiagonalCost, DiagonalCost, DiagonalCost, DiagonalCost};
+
+    auto CompareOpenCells = [](const FOpenCell& First, const FOpenCell& Second) { return First.Key < Second.Key; };
+
+    // Counts the visited cells for checking the time.
+    for (; OpenCells.Num() > 0; ++NextBuildCell)
+    {
+        if (NextBuildCell % CELLS_PER_TIME_CHECK == 0 && NextBuildCell > 0 && FPlatformTime::Seconds() >= EndTime)
+        {
+            return false;
+        }
+
+        FOpenCell OpenCell;
+        OpenCells.HeapPop(OpenCell, CompareOpenCells, false);
+
+        const int32 CellIndex = OpenCell.Value;
+        if (OpenCell.Key > Costs[CellIndex])
+        {
+            // Cell has been reached on a shorter path already.
+            continue;
+        }
+
+        const int32 X = CellIndex % NumCellsPerAxis;
+        const int32 Y = CellIndex / NumCellsPerAxis;
+
+        for (int32 Neighbor = 0; Neighbor < ARRAY_COUNT(NEIGHBOR_OFFSETS_X); ++Neighbor)
+        {
+            const int32 OffsetX = NEIGHBOR_OFFSETS_X[Neighbor];
+            const int32 OffsetY = NEIGHBOR_OFFSETS_Y[Neighbor];
+
+            if (!IsConnected(X, Y, OffsetX, OffsetY))
+            {
+                continue;
+            }
+
+            const int32 NeighborIndex = GetCellIndex(X + OffsetX, Y + OffsetY);
+            const float NeighborCost = OpenCell.Key + NEIGHBOR_COSTS[Neighbor];
+
+            if (NeighborCost < Costs[NeighborIndex])
+            {
+                Costs[NeighborIndex] = NeighborCost;
+                NextCells[NeighborIndex] = CellIndex;
+                OpenCells.HeapPush(FOpenCell(NeighborCost, NeighborIndex), CompareOpenCells);
+            }
+        }
+    }
+
+    bIsValid = true;
+    return true;
+}
+
+bool FRTSFlowField::IsValid() const
+{
+    return bIsValid;
+}
+
+const FVector& FRTSFlowField::GetDestination() const
+{
+    return Destination;
+}
+
+float FRTSFlowField::GetCellSize() const
+{
+    return CellSize;
+}
+
+int32 FRTSFlowField::GetHalfExtentInCells() const
+{
+    return HalfExtentInCells;
+}
+
+double FRTSFlowField::GetBuildTime() const
+{
+    return BuildTime;
+}
+
+bool FRTSFlowField::GetWaypoint(const FVector& Location, int32 MaxCells, FVector& OutWaypoint) const
+{
+    if (!bIsValid || !IsBuilt())
+    {
+        return false;
+    }
+
+    const int32 DestinationIndex = GetCellIndex(HalfExtentInCells, HalfExtentInCells);
+    const int32 CellIndex = GetCellIndex(FMath::FloorToInt((Location.X - Origin.X) / CellSize),
+                                         FMath::FloorToInt((Location.Y - Origin.Y) / CellSize));
+
+    if (CellIndex == DestinationIndex)
+    {
+        OutWaypoint = CellLocations[DestinationIndex];
+        return true;
+    }
+
+    if (CellIndex == INDEX_NONE || NextCells[CellIndex] == INDEX_NONE)
+    {
+        // Outside of the field, or destination not reachable.
+        return false;
+    }
+
+    // Follow the field as long as it goes straight.
+    int32 WaypointIndex = NextCells[CellIndex];
+    const int32 Step = WaypointIndex - CellIndex;
+
+    for (int32 Cells = 1; Cells < MaxCells; ++Cells)
+    {
+        const int32 NextIndex = NextCells[WaypointIndex];
+        if (NextIndex == INDEX_NONE || NextIndex - WaypointIndex != Step)
+        {
+            break;
+        }
+
+        WaypointIndex = NextIndex;
+    }
+
+    OutWaypoint = CellLocations[WaypointIndex];
+    return true;
+}
+
+int32 FRTSFlowField::GetCellIndex(int32 X, int32 Y) const
+{
+    if (X < 0 || Y < 0 || X >= NumCellsPerAxis || Y >= NumCellsPerAxis)
+    {
+        return INDEX_NONE;
+    }
+
+    return Y * NumCellsPerAxis + X;
+}
+
+bool FRTSFlowField::IsConnected(int32 X, int32 Y, int32 OffsetX, int32 OffsetY) const
+{
+    if (OffsetX == 0 || OffsetY == 0)
+    {
+        return IsConnectedOrthogonally(X, Y, OffsetX, OffsetY);
+    }
+
+    // Don't cut corners: Both ways around the diagonal must be free.
+    return IsConnectedOrthogonally(X, Y, OffsetX, 0) && IsConnectedOrthogonally(X + OffsetX, Y, 0, OffsetY) &&
+           IsConnectedOrthogonally(X, Y, 0, OffsetY) && IsConnectedOrthogonally(X, Y + OffsetY, OffsetX, 0);
+}
+
+bool FRTSFlowField::IsConnectedOrthogonally(int32 X, int32 Y, int32 OffsetX, int32 OffsetY) const
+{
+    // Connections are stored at the cell with the lower coordinates.
+    const int32 LowerX = OffsetX < 0 ? X + OffsetX : X;
+    const int32 LowerY = OffsetY < 0 ? Y + OffsetY : Y;
+
+    const int32 LowerIndex = GetCellIndex(LowerX, LowerY);
+    if (LowerIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    const uint8 Flag = OffsetX != 0 ? CELL_OPEN_POSITIVE_X : CELL_OPEN_POSITIVE_Y;
+    return (CellFlags[LowerIndex] & Flag) != 0;
+}
@@ -0,0 +1,291 @@
+#include "Orders/RTSFlowFieldService.h"
+
+#include "OrdersAbilities.h"
+
+#include "NavigationSystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+#include "Orders/RTSFlowField.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Flow Fields Requested"), STAT_RTSFlowFieldsRequested, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Flow Fields Shared"), STAT_RTSFlowFieldsShared, STATGROUP_RTS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("RTS - Flow Fields"), STAT_RTSFlowFields, STATGROUP_RTS);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("RTS - Flow Field Build Time (ms)"), STAT_RTSFlowFieldBuildTime, STATGROUP_RTS);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldCellSize(
+    TEXT("RTS.FlowFields.CellSize"), 200.0f,
+    TEXT("Width and height of the cells of flow fields, in world units. Applied to flow fields built afterwards."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldRegionSize(
+    TEXT("RTS.FlowFields.RegionSize"), 1000.0f,
+    TEXT("Width and height of the destination regions sharing the same flow field, in world units."), ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldMargin(
+    TEXT("RTS.FlowFields.Margin"), 2000.0f,
+    TEXT("Distance a flow field extends beyond the units it has been built for, for leading them around obstacles, "
+         "in world units."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldMaxExtent(
+    TEXT("RTS.FlowFields.MaxExtent"), 25000.0f,
+    TEXT("Maximum distance a flow field extends from its destination, in world units. Units farther away find paths "
+         "on their own."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldLifetime(
+    TEXT("RTS.FlowFields.Lifetime"), 30.0f,
+    TEXT("Time after which flow fields that haven't been used are discarded, in seconds."), ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldBuildBudget(
+    TEXT("RTS.FlowFields.BuildBudgetMs"), 2.0f,
+    TEXT("Time that may be spent per frame for building flow fields, in milliseconds."), ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRTSFlowFieldMaxWaitTime(
+    TEXT("RTS.FlowFields.MaxWaitSeconds"), 1.0f,
+    TEXT("Time units wait for their flow field to be built, before finding paths on their own, in seconds."),
+    ECVF_Default);
+
+
+FRTSFlowFieldService::FFlowFieldEntry::FFlowFieldEntry()
+    : RequestTime(0.0f)
+    , LastUsedTime(0.0f)
+{
+}
+
+FRTSFlowFieldService::FRTSFlowFieldService(UWorld* InWorld)
+    : World(InWorld)
+    , BuildFrame(0)
+    , BuildTimeInFrame(0.0)
+{
+}
+
+FRTSFlowFieldService::~FRTSFlowFieldService()
+{
+    DEC_DWORD_STAT_BY(STAT_RTSFlowFields, FlowFields.Num());
+}
+
+FRTSFlowFieldService* FRTSFlowFieldService::Get(UWorld* World)
+{
+    return GetWorldServices().FindOrAdd(World, World);
+}
+
+FRTSFlowFieldService* FRTSFlowFieldService::Find(const UWorld* World)
+{
+    return GetWorldServices().Find(World);
+}
+
+void FRTSFlowFieldService::RequestFlowField(const FVector& Destination, const TArray<AActor*>& Actors,
+                                            const TArray<FVector2D>& TargetLocations)
+{
+    check(IsInGameThread());
+
+    if (Actors.Num() != TargetLocations.Num())
+    {
+        return;
+    }
+
+    RemoveUnusedFlowFields();
+
+    INC_DWORD_STAT(STAT_RTSFlowFieldsRequested);
+
+    const FIntPoint Region = GetRegion(Destination);
+    FFlowFieldEntry* Entry = FlowFields.Find(Region);
+
+    // Make the field cover all actors, with some room for moving around obstacles.
+    const FVector FieldDestination = Entry != nullptr ? Entry->FlowField->GetDestination() : Destination;
+    float RequiredHalfExtent = 0.0f;
+
+    for (const AActor* Actor : Actors)
+    {
+        if (IsValid(Actor))
+        {
+            const FVector Location = Actor->GetActorLocation();
+            RequiredHalfExtent = FMath::Max3(RequiredHalfExtent, FMath::Abs(Location.X - FieldDestination.X),
+                                             FMath::Abs(Location.Y - FieldDestination.Y));
+        }
+    }
+
+    RequiredHalfExtent = FMath::Min(RequiredHalfExtent + CVarRTSFlowFieldMargin.GetValueOnGameThread(),
+                                    CVarRTSFlowFieldMaxExtent.GetValueOnGameThread());
+
+    // Replace fields that turned out to be too small or unusable. Fields still being built are used as they are.
+    const bool bIsFieldUsable =
+        Entry != nullptr &&
+        (!Entry->FlowField->IsBuilt() ||
+         (Entry->FlowField->IsValid() &&
+          Entry->FlowField->GetHalfExtentInCells() * Entry->FlowField->GetCellSize() >= RequiredHalfExtent));
+
+    if (bIsFieldUsable)
+    {
+        INC_DWORD_STAT(STAT_RTSFlowFieldsShared);
+    }
+    else
+    {
+        if (Entry == nullptr)
+        {
+            INC_DWORD_STAT(STAT_RTSFlowFields);
+        }
+
+        const float CellSize = FMath::Max(CVarRTSFlowFieldCellSize.GetValueOnGameThread(), 1.0f);
+        const int32 HalfExtentInCells = FMath::CeilToInt(RequiredHalfExtent / CellSize);
+
+        Entry = &FlowFields.Add(Region);
+        Entry->FlowField = MakeShared<FRTSFlowField>(Destination, CellSize, HalfExtentInCells);
+        Entry->RequestTime = World->GetTimeSeconds();
+    }
+
+    Entry->LastUsedTime = World->GetTimeSeconds();
+
+    for (int32 Index = 0; Index < Actors.Num(); ++Index)
+    {
+        if (IsValid(Actors[Index]))
+        {
+            FAssignment& Assignment = Assignments.FindOrAdd(Actors[Index]);
+            Assignment.Region = Region;
+            Assignment.TargetLocation = TargetLocations[Index];
+        }
+    }
+
+    // Start building right away, as the units are about to ask for their waypoints.
+    BuildFlowFields();
+}
+
+const FRTSFlowField* FRTSFlowFieldService::FindFlowField(const AActor* Actor, const FVector& TargetLocation,
+                                                         bool& bOutIsBuilding)
+{
+    check(IsInGameThread());
+
+    bOutIsBuilding = false;
+
+    // Actors might have been ordered to move somewhere else in the meantime.
+    const FAssignment* Assignment = Assignments.Find(Actor);
+    if (Assignment == nullptr || FVector2D::DistSquared(Assignment->TargetLocation, FVector2D(TargetLocation)) > 1.0f)
+    {
+        return nullptr;
+    }
+
+    FFlowFieldEntry* Entry = FlowFields.Find(Assignment->Region);
+    if (Entry == nullptr)
+    {
+        return nullptr;
+    }
+
+    Entry->LastUsedTime = World->GetTimeSeconds();
+
+    if (!Entry->FlowField->IsBuilt())
+    {
+        BuildFlowFields();
+    }
+
+    if (!Entry->FlowField->IsBuilt())
+    {
+        bOutIsBuilding =
+            World->GetTimeSeconds() - Entry->RequestTime < CVarRTSFlowFieldMaxWaitTime.GetValueOnGameThread();
+        return nullptr;
+    }
+
+    return Entry->FlowField->IsValid() ? Entry->FlowField.Get() : nullptr;
+}
+
+void FRTSFlowFieldService::ReleaseActor(const AActor* Actor)
+{
+    Assignments.Remove(Actor);
+}
+
+FIntPoint FRTSFlowFieldService::GetRegion(const FVector& Location) const
+{
+    const float RegionSize = FMath::Max(CVarRTSFlowFieldRegionSize.GetValueOnGameThread(), 1.0f);
+    return FIntPoint(FMath::FloorToInt(Location.X / RegionSize), FMath::FloorToInt(Location.Y / RegionSize));
+}
+
+const ANavigationData* FRTSFlowFieldService::GetNavData() const
+{
+    UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+    return NavigationSystem != nullptr ? NavigationSystem->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)
+                                       : nullptr;
+}
+
+void FRTSFlowFieldService::BuildFlowFields()
+{
+    if (BuildFrame != GFrameCounter)
+    {
+        BuildFrame = GFrameCounter;
+        BuildTimeInFrame = 0.0;
+    }
+
+    const double Budget = CVarRTSFlowFieldBuildBudget.GetValueOnGameThread() / 1000.0;
+    if (BuildTimeInFrame >= Budget)
+    {
+        return;
+    }
+
+    // Build on the game thread, so the navigation data can't be updated while it's queried. The navigation data is
+    // looked up again each frame, as it might have been replaced in the meantime.
+    const double StartTime = FPlatformTime::Seconds();
+    const double EndTime = StartTime + Budget - BuildTimeInFrame;
+    const ANavigationData* NavData = GetNavData();
+
+    for (TPair<FIntPoint, FFlowFieldEntry>& Pair : FlowFields)
+    {
+        FRTSFlowField& FlowField = *Pair.Value.FlowField;
+        if (FlowField.IsBuilt())
+        {
+            continue;
+        }
+
+        if (!FlowField.Build(NavData, EndTime))
+        {
+            break;
+        }
+
+        if (NavData == nullptr)
+        {
+            UE_LOG(LogRTS, Warning, TEXT("No navigation data found for building flow field to %s."),
+                   *FlowField.GetDestination().ToString());
+        }
+
+        const double FieldBuildTime = FlowField.GetBuildTime();
+        INC_FLOAT_STAT_BY(STAT_RTSFlowFieldBuildTime, FieldBuildTime * 1000.0);
+
+        UE_LOG(LogRTS, Verbose, TEXT("Built flow field to %s with %d cells per axis in %.2f ms."),
+               *FlowField.GetDestination().ToString(), FlowField.GetHalfExtentInCells() * 2 + 1,
+               FieldBuildTime * 1000.0);
+    }
+
+    BuildTimeInFrame += FPlatformTime::Seconds() - StartTime;
+}
+
+void FRTSFlowFieldService::RemoveUnusedFlowFields()
+{
+    const float Now = World->GetTimeSeconds();
+    const float Lifetime = CVarRTSFlowFieldLifetime.GetValueOnGameThread();
+
+    for (auto It = FlowFields.CreateIterator(); It; ++It)
+    {
+        FFlowFieldEntry& Entry = It.Value();
+        if (Entry.FlowField->IsBuilt() && Now - Entry.LastUsedTime > Lifetime)
+        {
+            It.RemoveCurrent();
+            DEC_DWORD_STAT(STAT_RTSFlowFields);
+        }
+    }
+
+    for (auto It = Assignments.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().IsValid() || !FlowFields.Contains(It.Value().Region))
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+TRTSPerWorld<FRTSFlowFieldService>& FRTSFlowFieldService::GetWorldServices()
+{
+    static TRTSPerWorld<FRTSFlowFieldService> WorldServices;
+    return WorldServices;
+}
@@ -0,0 +1,223 @@
+#include "Orders/RTSFormationLayoutCache.h"
+
+#include "OrdersAbilities.h"
+
+#include "Math/VectorRegister.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Formation Layout Cache Hits"), STAT_RTSFormationLayoutCacheHits, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Formation Layout Cache Misses"), STAT_RTSFormationLayoutCacheMisses,
+                           STATGROUP_RTS);
+
+
+FRTSFormationLayoutCache::FRTSFormationLayoutCache()
+{
+}
+
+FRTSFormationLayoutCache& FRTSFormationLayoutCache::Get()
+{
+    static FRTSFormationLayoutCache LayoutCache;
+    return LayoutCache;
+}
+
+TSharedRef<const TArray<FVector2D>> FRTSFormationLayoutCache::GetLocalSlots(const FRTSFormationTemplate& Template,
+                                                                            int32 UnitCount)
+{
+    check(IsInGameThread());
+
+    const TTuple<uint8, int32, float, float> Key =
+        MakeTuple((uint8)Template.Shape, UnitCount, Template.UnitSpacing.X, Template.UnitSpacing.Y);
+
+    const TSharedPtr<const TArray<FVector2D>>* CachedSlots = Layouts.Find(Key);
+    if (CachedSlots != nullptr)
+    {
+        INC_DWORD_STAT(STAT_RTSFormationLayoutCacheHits);
+        return CachedSlots->ToSharedRef();
+    }
+
+    INC_DWORD_STAT(STAT_RTSFormationLayoutCacheMisses);
+
+    // Formations of all kinds of sizes might be requested over time, so don't let the cache grow without bounds.
+    if (Layouts.Num() >= MAX_CACHED_LAYOUTS)
+    {
+        Layouts.Reset();
+    }
+
+    TSharedRef<TArray<FVector2D>> Slots = MakeShared<TArray<FVector2D>>();
+    BuildLayout(Template, UnitCount, *Slots);
+
+    Layouts.Add(Key, Slots);
+    return Slots;
+}
+
+void FRTSFormationLayoutCache::TransformSlots(const TArray<FVector2D>& LocalSlots, float Angle,
+                                              const FVector2D& Location, TArray<FVector2D>& OutSlots)
+{
+    const int32 NumSlots = LocalSlots.Num();
+    OutSlots.SetNumUninitialized(NumSlots);
+
+    float Sin;
+    float Cos;
+    FMath::SinCos(&Sin, &Cos, Angle);
+
+    // Each register holds two slots (X0, Y0, X1, Y1), as FQuat2D::TransformPoint would rotate them:
+    // (X * Cos - Y * Sin, X * Sin + Y * Cos) + Location
+    const VectorRegister CosCos = VectorSetFloat1(Cos);
+    const VectorRegister SinSigns = MakeVectorRegister(-Sin, Sin, -Sin, Sin);
+    const VectorRegister Offset = MakeVectorRegister(Location.X, Location.Y, Location.X, Location.Y);
+
+    const float* Source = &LocalSlots.GetData()->X;
+    float* Destination = &OutSlots.GetData()->X;
+
+    int32 Index = 0;
+    for (; Index + 2 <= NumSlots; Index += 2)
+    {
+        const VectorRegister Slots = VectorLoad(Source + Index * 2);
+        const VectorRegister SwappedSlots = VectorSwizzle(Slots, 1, 0, 3, 2);
+
+        VectorRegister Result = VectorMultiplyAdd(Slots, CosCos, Offset);
+        Result = VectorMultiplyAdd(SwappedSlots, SinSigns, Result);
+
+        VectorStore(Result, Destination + Index * 2);
+    }
+
+    // Transform the last slot, if any.
+    for (; Index < NumSlots; ++Index)
+    {
+        const FVector2D& LocalSlot = LocalSlots[Index];
+        OutSlots[Index] = FVector2D(LocalSlot.X * Cos - LocalSlot.Y * Sin, LocalSlot.X * Sin + LocalSlot.Y * Cos) +
+                          Location;
+    }
+}
+
+void FRTSFormationLayoutCache::Reset()
+{
+    Layouts.Reset();
+}
+
+void FRTSFormationLayoutCache::BuildLayout(const FRTSFormationTemplate& Template, int32 UnitCount,
+                                           TArray<FVector2D>& OutSlots) const
+{
+    if (UnitCount <= 1)
+    {
+        OutSlots.Add(FVector2D::ZeroVector);
+        return;
+    }
+
+    switch (Template.Shape)
+    {
+        case ERTSFormationShape::LINE:
+            BuildBoxLayout(UnitCount, UnitCount, Template.UnitSpacing, OutSlots);
+            break;
+
+        case ERTSFormationShape::WEDGE:
+            BuildWedgeLayout(UnitCount, Template.UnitSpacing, OutSlots);
+            break;
+
+        case ERTSFormationShape::COLUMN:
+            BuildColumnLayout(UnitCount, Template.UnitSpacing, OutSlots);
+            break;
+
+        case ERTSFormationShape::RING:
+            BuildRingLayout(UnitCount, Template.UnitSpacing, OutSlots);
+            break;
+
+        default:
+            // The formation is a square.
+            BuildBoxLayout(UnitCount, FMath::CeilToInt(FMath::Sqrt(UnitCount)), Template.UnitSpacing, OutSlots);
+            break;
+    }
+}
+
+void FRTSFormationLayoutCache::BuildBoxLayout(int32 UnitCount, int32 EdgeLengthX, const FVector2D& UnitSpacing,
+                                              TArray<FVector2D>& OutSlots) const
+{
+    const int32 EdgeLengthY = FMath::CeilToInt(UnitCount / static_cast<float>(EdgeLengthX));
+
+    float FormationOffsetX = (EdgeLengthX / 2) * UnitSpacing.X;
+    if (EdgeLengthX % 2 == 0)
+    {
+        // Patch the offset if the edge length is even.
+        FormationOffsetX -= UnitSpacing.X / 2.0f;
+    }
+
+    float FormationOffsetY = (EdgeLengthY / 2) * UnitSpacing.Y;
+    if (EdgeLengthY % 2 == 0)
+    {
+        // Patch the offset if the edge length is even.
+        FormationOffsetY -= UnitSpacing.Y / 2.0f;
+    }
+
+    for (int32 i = 0; i < UnitCount; ++i)
+    {
+        const int32 X = i % EdgeLengthX;
+        const int32 Y = i / EdgeLengthX;
+
+        OutSlots.Add(FVector2D(X * UnitSpacing.X - FormationOffsetX, Y * UnitSpacing.Y - FormationOffsetY));
+    }
+
+    // Patch up the last row. If it is not full the units must be centered.
+    const int32 UnitsInLastRow = UnitCount % EdgeLengthX;
+    if (UnitsInLastRow != 0)
+    {
+        const float LastRowUnitLocationOffset = (UnitSpacing.X * (EdgeLengthX - UnitsInLastRow)) / 2.0f;
+        for (int32 i = UnitCount - 1; i >= UnitCount - UnitsInLastRow; --i)
+        {
+            OutSlots[i].X += LastRowUnitLocationOffset;
+        }
+    }
+}
+
+void FRTSFormationLayoutCache::BuildWedgeLayout(int32 UnitCount, const FVector2D& UnitSpacing,
+                                                TArray<FVector2D>& OutSlots) const
+{
+    // Row N holds N + 1 units, except for the last one.
+    int32 NumRows = 0;
+    for (int32 PlacedUnits = 0; PlacedUnits < UnitCount; PlacedUnits += NumRows)
+    {
+        ++NumRows;
+    }
+
+    const float FormationOffsetY = (NumRows - 1) * UnitSpacing.Y / 2.0f;
+
+    int32 PlacedUnits = 0;
+    for (int32 Row = 0; Row < NumRows; ++Row)
+    {
+        const int32 UnitsInRow = FMath::Min(Row + 1, UnitCount - PlacedUnits);
+        const float RowOffsetX = (UnitsInRow - 1) * UnitSpacing.X / 2.0f;
+
+        for (int32 X = 0; X < UnitsInRow; ++X)
+        {
+            OutSlots.Add(FVector2D(X * UnitSpacing.X - RowOffsetX, Row * UnitSpacing.Y - FormationOffsetY));
+        }
+
+        PlacedUnits += UnitsInRow;
+    }
+}
+
+void FRTSFormationLayoutCache::BuildColumnLayout(int32 UnitCount, const FVector2D& UnitSpacing,
+                                                 TArray<FVector2D>& OutSlots) const
+{
+    const float FormationOffsetY = (UnitCount - 1) * UnitSpacing.Y / 2.0f;
+
+    for (int32 Y = 0; Y < UnitCount; ++Y)
+    {
+        OutSlots.Add(FVector2D(0.0f, Y * UnitSpacing.Y - FormationOffsetY));
+    }
+}
+
+void FRTSFormationLayoutCache::BuildRingLayout(int32 UnitCount, const FVector2D& UnitSpacing,
+                                               TArray<FVector2D>& OutSlots) const
+{
+    // Units stand side by side along the ring, which must not be smaller than the space between rows.
+    const float Radius = FMath::Max(UnitCount * UnitSpacing.X / (2.0f * PI), UnitSpacing.Y);
+
+    for (int32 i = 0; i < UnitCount; ++i)
+    {
+        const float Angle = 2.0f * PI * i / UnitCount;
+        OutSlots.Add(FVector2D(Radius * FMath::Sin(Angle), -Radius * FMath::Cos(Angle)));
+    }
+
+    // Start from the front line.
+    OutSlots.StableSort([](const FVector2D& First, const FVector2D& Second) { return First.Y < Second.Y; });
+}
@@ -0,0 +1,299 @@
+#include "Orders/RTSFormationSlotAssignment.h"
+
+#include "OrdersAbilities.h"
+
+#include "NumericLimits.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Formation Slot Assignment"), STAT_RTSFormationSlotAssignment, STATGROUP_RTS);
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand CmdRTSBenchmarkSlotAssignment(
+    TEXT("RTS.Formations.BenchmarkSlotAssignment"),
+    TEXT("Logs the time and total squared distance of assigning formation slots to 50, 200 and 1000 randomly placed "
+         "units, for all slot assignment modes."),
+    FConsoleCommandDelegate::CreateStatic(&FRTSFormationSlotAssignment::LogBenchmark));
+#endif
+
+
+void FRTSFormationSlotAssignment::AssignSlots(const TArray<FVector2D>& UnitOffsets,
+                                              const TArray<FVector2D>& SlotOffsets, const FVector2D& Direction,
+                                              ERTSFormationSlotAssignmentMode Mode, int32 MaxUnitsForOptimalAssignment,
+                                              TArray<int32>& OutSlotIndices)
+{
+    check(UnitOffsets.Num() == SlotOffsets.Num());
+
+    SCOPE_CYCLE_COUNTER(STAT_RTSFormationSlotAssignment);
+
+    if (Mode == ERTSFormationSlotAssignmentMode::OPTIMAL && UnitOffsets.Num() <= MaxUnitsForOptimalAssignment)
+    {
+        AssignSlotsOptimally(UnitOffsets, SlotOffsets, OutSlotIndices);
+    }
+    else
+    {
+        AssignSlotsBySweep(UnitOffsets, SlotOffsets, Direction, OutSlotIndices);
+    }
+}
+
+void FRTSFormationSlotAssignment::AssignSlotsBySweep(const TArray<FVector2D>& UnitOffsets,
+                                                     const TArray<FVector2D>& SlotOffsets, const FVector2D& Direction,
+                                                     TArray<int32>& OutSlotIndices)
+{
+    // Slots of the same row might differ slightly in depth after rotating the formation.
+    const float ROW_TOLERANCE = 1.0f;
+
+    const int32 Num = UnitOffsets.Num();
+    OutSlotIndices.SetNumUninitialized(Num);
+
+    if (Num == 0)
+    {
+        return;
+    }
+
+    // Rotate units and slots into the frame of the formation. Formations without direction face the x-axis, as with
+    // URTSMoveOrder::CalculateFormation.
+    const FVector2D Forward = Direction.IsNearlyZero() ? FVector2D(1.0f, 0.0f) : Direction.GetSafeNormal();
+    const FVector2D Right(-Forward.Y, Forward.X);
+
+    TArray<float> UnitDepths;
+    TArray<float> UnitLaterals;
+    TArray<float> SlotDepths;
+    TArray<float> SlotLaterals;
+    UnitDepths.SetNumUninitialized(Num);
+    UnitLaterals.SetNumUninitialized(Num);
+    SlotDepths.SetNumUninitialized(Num);
+    SlotLaterals.SetNumUninitialized(Num);
+
+    TArray<int32> Units;
+    TArray<int32> Slots;
+    Units.SetNumUninitialized(Num);
+    Slots.SetNumUninitialized(Num);
+
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        UnitDepths[Index] = FVector2D::DotProduct(UnitOffsets[Index], Forward);
+        UnitLaterals[Index] = FVector2D::DotProduct(UnitOffsets[Index], Right);
+        SlotDepths[Index] = FVector2D::DotProduct(SlotOffsets[Index], Forward);
+        SlotLaterals[Index] = FVector2D::DotProduct(SlotOffsets[Index], Right);
+
+        Units[Index] = Index;
+        Slots[Index] = Index;
+    }
+
+    // Sort units and slots front to back.
+    Units.Sort([&](int32 First, int32 Second) { return UnitDepths[First] > UnitDepths[Second]; });
+    Slots.Sort([&](int32 First, int32 Second) { return SlotDepths[First] > SlotDepths[Second]; });
+
+    // The frontmost units fill the front row, and so on. Pair units and slots of each row from left to right.
+    int32 RowStart = 0;
+    while (RowStart < Num)
+    {
+        int32 RowEnd = RowStart + 1;
+        while (RowEnd < Num && SlotDepths[Slots[RowStart]] - SlotDepths[Slots[RowEnd]] <= ROW_TOLERANCE)
+        {
+            ++RowEnd;
+        }
+
+        const int32 RowLength = RowEnd - RowStart;
+        Sort(Units.GetData() + RowStart, RowLength,
+             [&](int32 First, int32 Second) { return UnitLaterals[First] < UnitLaterals[Second]; });
+        Sort(Slots.GetData() + RowStart, RowLength,
+             [&](int32 First, int32 Second) { return SlotLaterals[First] < SlotLaterals[Second]; });
+
+        for (int32 Index = RowStart; Index < RowEnd; ++Index)
+        {
+            OutSlotIndices[Units[Index]] = Slots[Index];
+        }
+
+        RowStart = RowEnd;
+    }
+}
+
+void FRTSFormationSlotAssignment::AssignSlotsOptimally(const TArray<FVector2D>& UnitOffsets,
+                                                       const TArray<FVector2D>& SlotOffsets,
+                                                       TArray<int32>& OutSlotIndices)
+{
+    const int32 Num = UnitOffsets.Num();
+    OutSlotIndices.SetNumUninitialized(Num);
+
+    if (Num == 0)
+    {
+        return;
+    }
+
+    // Costs of all pairs of units and slots, by unit and slot.
+    TArray<double> Costs;
+    Costs.SetNumUninitialized(Num * Num);
+
+    for (int32 UnitIndex = 0; UnitIndex < Num; ++UnitIndex)
+    {
+        for (int32 SlotIndex = 0; SlotIndex < Num; ++SlotIndex)
+        {
+            Costs[UnitIndex * Num + SlotIndex] = FVector2D::DistSquared(UnitOffsets[UnitIndex], SlotOffsets[SlotIndex]);
+        }
+    }
+
+    // Hungarian algorithm with potentials, adding one unit after another along a shortest augmenting path.
+    // Units and slots are one-based here, with slot 0 as a virtual start for the unit being added.
+    TArray<double> UnitPotentials;
+    TArray<double> SlotPotentials;
+    TArray<int32> SlotUnits;
+    TArray<int32> PreviousSlots;
+    TArray<double> MinSlack;
+    TArray<bool> VisitedSlots;
+    UnitPotentials.SetNumZeroed(Num + 1);
+    SlotPotentials.SetNumZeroed(Num + 1);
+    SlotUnits.SetNumZeroed(Num + 1);
+    PreviousSlots.SetNumZeroed(Num + 1);
+    MinSlack.SetNumUninitialized(Num + 1);
+    VisitedSlots.SetNumUninitialized(Num + 1);
+
+    for (int32 Unit = 1; Unit <= Num; ++Unit)
+    {
+        SlotUnits[0] = Unit;
+        int32 CurrentSlot = 0;
+
+        for (int32 Slot = 0; Slot <= Num; ++Slot)
+        {
+            MinSlack[Slot] = TNumericLimits<double>::Max();
+            VisitedSlots[Slot] = false;
+        }
+
+        // Grow the tree of tight edges until a free slot is reached.
+        do
+        {
+            VisitedSlots[CurrentSlot] = true;
+
+            const int32 CurrentUnit = SlotUnits[CurrentSlot];
+            double Delta = TNumericLimits<double>::Max();
+            int32 NextSlot = 0;
+
+            for (int32 Slot = 1; Slot <= Num; ++Slot)
+            {
+                if (VisitedSlots[Slot])
+                {
+                    continue;
+                }
+
+                const double Slack = Costs[(CurrentUnit - 1) * Num + Slot - 1] - UnitPotentials[CurrentUnit] -
+                                     SlotPotentials[Slot];
+                if (Slack < MinSlack[Slot])
+                {
+                    MinSlack[Slot] = Slack;
+                    PreviousSlots[Slot] = CurrentSlot;
+                }
+
+                if (MinSlack[Slot] < Delta)
+                {
+                    Delta = MinSlack[Slot];
+                    NextSlot = Slot;
+                }
+            }
+
+            for (int32 Slot = 0; Slot <= Num; ++Slot)
+            {
+                if (VisitedSlots[Slot])
+                {
+                    UnitPotentials[SlotUnits[Slot]] += Delta;
+                    SlotPotentials[Slot] -= Delta;
+                }
+                else
+                {
+                    MinSlack[Slot] -= Delta;
+                }
+            }
+
+            CurrentSlot = NextSlot;
+        } while (SlotUnits[CurrentSlot] != 0);
+
+        // Flip the augmenting path.
+        do
+        {
+            const int32 PreviousSlot = PreviousSlots[CurrentSlot];
+            SlotUnits[CurrentSlot] = SlotUnits[PreviousSlot];
+            CurrentSlot = PreviousSlot;
+        } while (CurrentSlot != 0);
+    }
+
+    for (int32 Slot = 1; Slot <= Num; ++Slot)
+    {
+        OutSlotIndices[SlotUnits[Slot] - 1] = Slot - 1;
+    }
+}
+
+float FRTSFormationSlotAssignment::GetTotalCost(const TArray<FVector2D>& UnitOffsets,
+                                                const TArray<FVector2D>& SlotOffsets, const TArray<int32>& SlotIndices)
+{
+    float TotalCost = 0.0f;
+
+    for (int32 UnitIndex = 0; UnitIndex < SlotIndices.Num(); ++UnitIndex)
+    {
+        TotalCost += FVector2D::DistSquared(UnitOffsets[UnitIndex], SlotOffsets[SlotIndices[UnitIndex]]);
+    }
+
+    return TotalCost;
+}
+
+#if !UE_BUILD_SHIPPING
+void FRTSFormationSlotAssignment::LogBenchmark()
+{
+    const int32 UNIT_COUNTS[] = {50, 200, 1000};
+    const int32 ITERATIONS = 10;
+    const int32 MAX_UNITS_FOR_OPTIMAL_ASSIGNMENT = 200;
+    const float UNIT_SPACING = 300.0f;
+
+    FRandomStream RandomStream(0);
+    const FVector2D Direction(1.0f, 1.0f);
+
+    for (int32 UnitCount : UNIT_COUNTS)
+    {
+        // Scatter the units over roughly the same area as their square formation.
+        const int32 EdgeLength = FMath::CeilToInt(FMath::Sqrt(UnitCount));
+        const float FormationSize = EdgeLength * UNIT_SPACING;
+
+        TArray<FVector2D> UnitOffsets;
+        TArray<FVector2D> SlotOffsets;
+
+        for (int32 Index = 0; Index < UnitCount; ++Index)
+        {
+            UnitOffsets.Add(FVector2D(RandomStream.FRandRange(-0.5f, 0.5f) * FormationSize,
+                                      RandomStream.FRandRange(-0.5f, 0.5f) * FormationSize));
+            SlotOffsets.Add(FVector2D((Index % EdgeLength) * UNIT_SPACING - FormationSize / 2,
+                                      (Index / EdgeLength) * UNIT_SPACING - FormationSize / 2));
+        }
+
+        TArray<int32> SlotIndices;
+
+        // Sweep.
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < ITERATIONS; ++Iteration)
+        {
+            AssignSlotsBySweep(UnitOffsets, SlotOffsets, Direction, SlotIndices);
+        }
+        double Milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0 / ITERATIONS;
+
+        UE_LOG(LogRTS, Log, TEXT("Slot assignment of %d units by sweep: %.3f ms, total squared distance %.0f."),
+               UnitCount, Milliseconds, GetTotalCost(UnitOffsets, SlotOffsets, SlotIndices));
+
+        // Optimal.
+        if (UnitCount > MAX_UNITS_FOR_OPTIMAL_ASSIGNMENT)
+        {
+            UE_LOG(LogRTS, Log, TEXT("Slot assignment of %d units optimally: Skipped, too many units."), UnitCount);
+            continue;
+        }
+
+        StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < ITERATIONS; ++Iteration)
+        {
+            AssignSlotsOptimally(UnitOffsets, SlotOffsets, SlotIndices);
+        }
+        Milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0 / ITERATIONS;
+
+        UE_LOG(LogRTS, Log, TEXT("Slot assignment of %d units optimally: %.3f ms, total squared distance %.0f."),
+               UnitCount, Milliseconds, GetTotalCost(UnitOffsets, SlotOffsets, SlotIndices));
+    }
+}
+#endif
@@ -0,0 +1,8 @@
+#include "Orders/RTSFormationTemplate.h"
+
+
+FRTSFormationTemplate::FRTSFormationTemplate()
+    : Shape(ERTSFormationShape::BOX)
+    , UnitSpacing(300.0f, 300.0f)
+{
+}
@@ -1,11 +1,12 @@
 #include "Orders/RTSMoveOrder.h"
 
-#include "NumericLimits.h"
-#include "TransformCalculus2D.h"
 #include "UnrealMathUtility.h"
 #include "GameFramework/Actor.h"
 
 #include "AbilitySystem/RTSGlobalTags.h"
+#include "Orders/RTSFlowFieldService.h"
+#include "Orders/RTSFormationLayoutCache.h"
+#include "Orders/RTSFormationSlotAssignment.h"
 #include "Orders/RTSOrderTargetData.h"
 
 
@@ -14,6 +15,10 @@ URTSMoveOrder::URTSMoveOrder()
     TargetType = ERTSTargetType::LOCATION;
     bIsCreatingIndividualTargetLocations = true;
 
+    SlotAssignmentMode = ERTSFormationSlotAssignmentMode::OPTIMAL;
+    MaxUnitsForOptimalSlotAssignment = 32;
+    MinUnitsForFlowField = 20;
+
     TagRequirements.SourceBlockedTags.AddTag(URTSGlobalTags::Status_Changing_Immobilized());
     TagRequirements.SourceBlockedTags.AddTag(URTSGlobalTags::Status_Changing_Constructing());
 }
@@ -27,141 +32,106 @@ void URTSMoveOrder::CreateIndividualTargetLocations(const TArray<AActor*>& Order
     // Resize the output array upfront.
     OutTargetLocations.AddUninitialized(OrderedActors.Num());
 
-    TArray<AActor*> ActorsToMove = OrderedActors;
+    // Look up the formation rank and location of each actor only once.
+    TArray<int32> FormationRanks;
+    TArray<FVector2D> ActorLocations;
+    TArray<int32> ActorIndices;
+
+    for (int32 ActorIndex = 0; ActorIndex < OrderedActors.Num(); ++ActorIndex)
+    {
+        const AActor* Actor = OrderedActors[ActorIndex];
+
+        FormationRanks.Add(GetFormationRank(Actor));
+        ActorLocations.Add(IsValid(Actor) ? FVector2D(Actor->GetActorLocation()) : FVector2D::ZeroVector);
+        ActorIndices.Add(ActorIndex);
+    }
 
     // Sort all actors by their formation rank.
-    ActorsToMove.Sort([&](const AActor& First, const AActor& Second) {
-        return GetFormationRank(&First) > GetFormationRank(&Second);
-    });
+    ActorIndices.StableSort(
+        [&](int32 First, int32 Second) { return FormationRanks[First] > FormationRanks[Second]; });
 
-    const FVector2D StartingCenterOfFormation = GetCenterOfGroup(ActorsToMove);
+    const FVector2D StartingCenterOfFormation = GetCenterOfGroup(OrderedActors);
     const FVector2D TargetCenterOfFormation(TargetLocation.X, TargetLocation.Y);
+    const FVector2D Direction = TargetCenterOfFormation - StartingCenterOfFormation;
 
     TArray<FVector2D> TargetLocations;
-    CalculateFormation(ActorsToMove.Num(), TargetCenterOfFormation - StartingCenterOfFormation, TargetCenterOfFormation,
-                       TargetLocations);
+    CalculateFormation(OrderedActors.Num(), Direction, TargetCenterOfFormation, TargetLocations);
 
-    int32 MovedUnits = 0;
-    while (ActorsToMove.Num() > 0)
+    // Assign the next slots of the formation, starting from the front line, to the actors of each rank.
+    TArray<FVector2D> UnitOffsets;
+    TArray<FVector2D> SlotOffsets;
+    TArray<int32> SlotIndices;
+
+    int32 RankStart = 0;
+    while (RankStart < ActorIndices.Num())
     {
-        int32 FormationRank = GetFormationRank(ActorsToMove[0]);
-        int32 UnitsWithCurrentRank = 0;
-        for (int32 i = 0; i < ActorsToMove.Num(); ++i)
+        const int32 FormationRank = FormationRanks[ActorIndices[RankStart]];
+
+        int32 RankEnd = RankStart + 1;
+        while (RankEnd < ActorIndices.Num() && FormationRanks[ActorIndices[RankEnd]] == FormationRank)
         {
-            if (FormationRank != GetFormationRank(ActorsToMove[i]))
-            {
-                break;
-            }
+            ++RankEnd;
+        }
+
+        UnitOffsets.Reset();
+        SlotOffsets.Reset();
 
-            UnitsWithCurrentRank++;
+        for (int32 i = RankStart; i < RankEnd; ++i)
+        {
+            UnitOffsets.Add(ActorLocations[ActorIndices[i]] - StartingCenterOfFormation);
+            SlotOffsets.Add(TargetLocations[i] - TargetCenterOfFormation);
         }
 
-        int32 MovedActors = 0;
-        for (int32 i = MovedUnits; i < MovedUnits + UnitsWithCurrentRank; ++i)
+        FRTSFormationSlotAssignment::AssignSlots(UnitOffsets, SlotOffsets, Direction, SlotAssignmentMode,
+                                                 MaxUnitsForOptimalSlotAssignment, SlotIndices);
+
+        // Store the locations in the output array.
+        for (int32 i = 0; i < SlotIndices.Num(); ++i)
         {
-            const FVector2D CurrentFormationLocation = TargetLocations[i];
-            AActor* ActorToMove = nullptr;
-
-            // The lower the better.
-            float Quality = TNumericLimits<float>::Max();
-
-            for (int32 j = 0; j < UnitsWithCurrentRank - MovedActors; ++j)
-            {
-                FVector2D UnitStartLocation(ActorsToMove[j]->GetActorLocation().X,
-                                            ActorsToMove[j]->GetActorLocation().Y);
-
-                const FVector2D Delta = (UnitStartLocation - StartingCenterOfFormation) -
-                                        (CurrentFormationLocation - TargetCenterOfFormation);
-
-                const float NewQuality = FVector2D::DotProduct(Delta, Delta);
-                if (NewQuality < Quality)
-                {
-                    ActorToMove = ActorsToMove[j];
-                    Quality = NewQuality;
-                }
-            }
-
-            // Remove the chosen actor so that it cannot choose another location.
-            ActorsToMove.Remove(ActorToMove);
-            MovedActors++;
-
-            // Store the location in the output array.
-            OutTargetLocations[OrderedActors.IndexOfByKey(ActorToMove)] = CurrentFormationLocation;
+            OutTargetLocations[ActorIndices[RankStart + i]] = TargetLocations[RankStart + SlotIndices[i]];
         }
 
-        MovedUnits += UnitsWithCurrentRank;
+        RankStart = RankEnd;
     }
 }
 
-void URTSMoveOrder::CalculateFormation(int32 UnitCount, const FVector2D Direction, const FVector2D TargetLocation,
-                                       TArray<FVector2D>& OutLocations) const
+void URTSMoveOrder::RequestFlowField(const TArray<AActor*>& OrderedActors, const FRTSOrderTargetData& TargetData,
+                                     const TArray<FVector2D>& TargetLocations) const
 {
-    if (UnitCount <= 1)
+    if (MinUnitsForFlowField <= 0 || OrderedActors.Num() < MinUnitsForFlowField ||
+        OrderedActors.Num() != TargetLocations.Num())
     {
-        OutLocations.Add(TargetLocation);
         return;
     }
 
-    // Create a formation grid of an appropriate size.
-    //
-
-    // The formation is a square and this is its edge length in units.
-    const int32 EdgeLengthX = FMath::CeilToInt(FMath::Sqrt(UnitCount));
-    const int32 EdgeLengthY = FMath::CeilToInt(UnitCount / static_cast<float>(EdgeLengthX));
-
-    // TODO: Remove this magic numbers.
-    // The space between two units in cm.
-    const float UnitSpacingX = 300;
-    const float UnitSpacingY = 300;
-
-    float FormationOffsetX = (EdgeLengthX / 2) * UnitSpacingX;
-    if (EdgeLengthX % 2 == 0)
+    // Only the server moves units.
+    const AActor* FirstActor = OrderedActors[0];
+    if (!IsValid(FirstActor) || !FirstActor->HasAuthority())
     {
-        // Patch the offset if the edge length is even.
-        FormationOffsetX -= UnitSpacingX / 2.0f;
-    }
-
-    float FormationOffsetY = (EdgeLengthY / 2) * UnitSpacingY;
-    if (EdgeLengthY % 2 == 0)
-    {
-        // Patch the offset if the edge length is even.
-        FormationOffsetY -= UnitSpacingY / 2.0f;
+        return;
     }
 
-    for (int32 i = 0; i < UnitCount; ++i)
+    FRTSFlowFieldService* FlowFieldService = FRTSFlowFieldService::Get(FirstActor->GetWorld());
+    if (FlowFieldService != nullptr)
     {
-        const int32 X = i % EdgeLengthX;
-        const int32 Y = i / EdgeLengthX;
-
-        const FVector2D GridLocation(X * UnitSpacingX - FormationOffsetX, Y * UnitSpacingY - FormationOffsetY);
-        OutLocations.Add(GridLocation);
+        const FVector Destination(TargetData.Location, FirstActor->GetActorLocation().Z);
+        FlowFieldService->RequestFlowField(Destination, OrderedActors, TargetLocations);
     }
+}
 
-    // Patch up the last row. If it is not full the units must be centered.
-    const int32 UnitsInLastRow = UnitCount % EdgeLengthX;
-    if (UnitsInLastRow != 0)
-    {
-        const float LastRowUnitLocationOffset = (UnitSpacingX * (EdgeLengthX - UnitsInLastRow)) / 2.0f;
-        for (int32 i = UnitCount - 1; i >= UnitCount - UnitsInLastRow; --i)
-        {
-            OutLocations[i].X += LastRowUnitLocationOffset;
-        }
-    }
+void URTSMoveOrder::CalculateFormation(int32 UnitCount, const FVector2D Direction, const FVector2D TargetLocation,
+                                       TArray<FVector2D>& OutLocations) const
+{
+    const TSharedRef<const TArray<FVector2D>> LocalLocations =
+        FRTSFormationLayoutCache::Get().GetLocalSlots(Formation, UnitCount);
 
-    // Rotate and translate the local grid location to the target locations.
+    // Rotate and translate the local slots to the target locations.
     //
 
     // Calculate the polar angle of delta (in radians).
     const float Angle = FMath::Atan2(Direction.Y, Direction.X) + HALF_PI;
 
-    // Create a complex number to rotate the grid position.
-    const FQuat2D Rotator(Angle);
-
-    for (int32 i = 0; i < UnitCount; ++i)
-    {
-        // Rotate the grid positions around (0,0) and than add the target location.
-        OutLocations[i] = Rotator.TransformPoint(OutLocations[i]) + TargetLocation;
-    }
+    FRTSFormationLayoutCache::TransformSlots(*LocalLocations, Angle, TargetLocation, OutLocations);
 }
 
 FVector2D URTSMoveOrder::GetCenterOfGroup(const TArray<AActor*>& Actors) const
@@ -171,6 +171,11 @@ float URTSOrder::GetTargetScore(const AActor* OrderedActor, const FRTSOrderTarge
     return 1.0f - Distance / AcquisitionRadius;
 }
 
+bool URTSOrder::SupportsParallelTargetScoring(const AActor* OrderedActor, int32 Index) const
+{
+    return false;
+}
+
 ERTSOrderGroupExecutionType URTSOrder::GetGroupExecutionType(const AActor* OrderedActor, int32 Index) const
 {
     return ERTSOrderGroupExecutionType::ALL;
@@ -6,17 +6,42 @@
 
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "AI/Navigation/NavAgentInterface.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 
+#include "AbilitySystem/RTSAbilitySystemComponent.h"
 #include "AbilitySystem/RTSAbilitySystemHelper.h"
 #include "AbilitySystem/RTSGlobalTags.h"
+#include "Orders/RTSAutoOrderProvider.h"
 #include "Orders/RTSCharacterAIController.h"
+#include "Orders/RTSMoveOrder.h"
 #include "Orders/RTSOrder.h"
 #include "Orders/RTSOrderErrorTags.h"
 #include "Orders/RTSOrderHelper.h"
+#include "Orders/RTSOrderTypeRegistry.h"
+#include "Orders/RTSSpatialHashGrid.h"
 #include "Orders/RTSStopOrder.h"
 
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Tag Requirements Cache Hits"), STAT_RTSOrderTagRequirementsCacheHits,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Tag Requirements Cache Misses"), STAT_RTSOrderTagRequirementsCacheMisses,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Tag Listeners Added"), STAT_RTSOrderTagListenersAdded, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Tag Listeners Removed"), STAT_RTSOrderTagListenersRemoved, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Paths Prefetched"), STAT_RTSOrderPathsPrefetched, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Prefetched Paths Used"), STAT_RTSOrderPrefetchedPathsUsed, STATGROUP_RTS);
+
+static TAutoConsoleVariable<float> CVarRTSPathPrefetchMaxStartDistance(
+    TEXT("RTS.Orders.PathPrefetchMaxStartDistance"), 500.0f,
+    TEXT("Maximum distance of units from the start of the path found for their next queued order, for using that path "
+         "instead of finding a new one, in world units."),
+    ECVF_Default);
+
+
 URTSOrderComponent::URTSOrderComponent(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
 {
@@ -24,12 +49,23 @@ URTSOrderComponent::URTSOrderComponent(const FObjectInitializer& ObjectInitializ
 
     LastOrderHomeLocation = FVector::ZeroVector;
     bIsHomeLocationSet = false;
+    bIsIssuingPendingOrders = false;
+    PathPrefetchQueryId = INVALID_NAVQUERYID;
+    PathPrefetchLocation = FVector2D::ZeroVector;
+    CachedTagRequirementsGeneration = 0;
 }
 
 void URTSOrderComponent::BeginPlay()
 {
     Super::BeginPlay();
 
+    // Make the owner a potential target for the orders of other units.
+    FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Get(GetWorld());
+    if (Grid != nullptr)
+    {
+        Grid->RegisterActor(GetOwner());
+    }
+
     APawn* Pawn = Cast<APawn>(GetOwner());
     if (Pawn == nullptr)
     {
@@ -49,16 +85,34 @@ void URTSOrderComponent::BeginPlay()
     // Reset current order.
     CurrentOrder = FRTSOrderData();
 
+    // Tag requirements of ability orders depend on the abilities of the unit.
+    URTSAbilitySystemComponent* AbilitySystem = Pawn->FindComponentByClass<URTSAbilitySystemComponent>();
+    if (AbilitySystem != nullptr)
+    {
+        AbilitySystem->OnAbilitiesChanged.AddUObject(this, &URTSOrderComponent::InvalidateTagRequirements);
+    }
+
     // Try to set the stop order if possible.
     ARTSCharacterAIController* Controller = Cast<ARTSCharacterAIController>(Pawn->GetController());
+    if (Controller != nullptr)
+    {
+        StopOrder = Controller->GetStopOrder();
+    }
+
+    // Stream in the order types now, instead of causing a hitch when they are issued for the first time.
+    PreloadOrderTypes();
+
     if (Controller == nullptr)
     {
         return;
     }
 
-    StopOrder = Controller->GetStopOrder();
+    // Don't replicate the stop order before its type has been loaded. It's set as current order when issued, then.
+    if (FRTSOrderTypeRegistry::Get().IsLoaded(StopOrder.ToSoftObjectPath()))
+    {
+        CurrentOrder = StopOrder;
+    }
 
-    CurrentOrder = StopOrder;
     IssueOrder(StopOrder);
 }
 
@@ -67,7 +121,31 @@ void URTSOrderComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& O
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
     DOREPLIFETIME(URTSOrderComponent, CurrentOrder);
-    DOREPLIFETIME(URTSOrderComponent, OrderQueue);
+    DOREPLIFETIME(URTSOrderComponent, QueuedOrders);
+}
+
+void URTSOrderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    AbortPathPrefetch();
+
+    FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(GetWorld());
+    if (Grid != nullptr)
+    {
+        Grid->UnregisterActor(GetOwner());
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void URTSOrderComponent::PostNetReceive()
+{
+    Super::PostNetReceive();
+
+    // Rebuild the queue once for all orders received with this update.
+    if (QueuedOrders.ApplyReceivedChanges())
+    {
+        UpdateOrderPreviews();
+    }
 }
 
 void URTSOrderComponent::SetCurrentOrder(FRTSOrderData NewOrder)
@@ -91,12 +169,17 @@ void URTSOrderComponent::ReceivedCurrentOrder()
     NotifyOnOrderChanged(CurrentOrder);
 }
 
-void URTSOrderComponent::ReceivedOrderQueue()
+void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order)
 {
-    UpdateOrderPreviews();
+    IssueOrder(Order, false);
 }
 
-void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order)
+void URTSOrderComponent::IssueCheckedOrder(const FRTSOrderData& Order)
+{
+    IssueOrder(Order, true);
+}
+
+void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order, bool bIsOrderChecked)
 {
     AActor* Owner = GetOwner();
 
@@ -110,9 +193,21 @@ void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order)
         return;
     }
 
+    // A new order replaces all orders that are still waiting for their order types.
+    if (!bIsIssuingPendingOrders)
+    {
+        PendingOrders.Reset();
+    }
+
+    if (!bIsOrderChecked && DeferOrderUntilLoaded(Order, ERTSOrderIssueMode::ISSUE))
+    {
+        return;
+    }
+
     // Clear the order cue when another order is issued.
-    OrderQueue.Empty();
+    QueuedOrders.Reset();
     OnOrderQueueCleared.Broadcast();
+    AbortPathPrefetch();
 
     // Do nothing if we are obeying exact the same order already (and I mean exact: Not only the same order type)
     if (CurrentOrder == Order)
@@ -120,24 +215,23 @@ void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order)
         return;
     }
 
-    if (!Order.OrderType.IsValid())
-    {
-        Order.OrderType.LoadSynchronous();
-    }
+#if RTS_ORDER_LIFECYCLE_TRACE
+    LifecycleTrace.BeginOrder(Order.OrderType.ToSoftObjectPath().GetAssetPathName(), ERTSOrderLifecycleStage::ISSUED);
+#endif
 
     bIsHomeLocationSet = false;
 
     // Abort current order.
-    if (CurrentOrder.OrderType != StopOrder &&
-        URTSOrderHelper::GetOrderProcessPolicy(Order.OrderType, Owner, Order.Index) != ERTSOrderProcessPolicy::INSTANT)
+    if (CurrentOrder.OrderType != StopOrder && GetOrderProcessPolicy(Order) != ERTSOrderProcessPolicy::INSTANT)
     {
-        switch (URTSOrderHelper::GetOrderProcessPolicy(CurrentOrder.OrderType, Owner, CurrentOrder.Index))
+        switch (GetOrderProcessPolicy(CurrentOrder))
         {
             case ERTSOrderProcessPolicy::CAN_BE_CANCELED:
                 OrderCanceled();
 
-                if (CheckOrder(Order))
+                if (bIsOrderChecked || CheckOrder(Order))
                 {
+                    TraceOrderLifecycleStage(ERTSOrderLifecycleStage::CHECKED);
                     ObeyOrder(Order);
                 }
                 else
@@ -147,7 +241,8 @@ void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order)
                 break;
             case ERTSOrderProcessPolicy::CAN_NOT_BE_CANCELED:
                 // We cannot cancel our current order so we need to queue it up as next.
-                OrderQueue.Add(Order);
+                QueuedOrders.PushBack(Order);
+                PrefetchNextPath();
                 break;
             case ERTSOrderProcessPolicy::INSTANT:
                 // This should not be possible. Instant orders should not be set as current orders in the first place.
@@ -161,8 +256,9 @@ void URTSOrderComponent::IssueOrder(const FRTSOrderData& Order)
 
     else
     {
-        if (CheckOrder(Order))
+        if (bIsOrderChecked || CheckOrder(Order))
         {
+            TraceOrderLifecycleStage(ERTSOrderLifecycleStage::CHECKED);
             ObeyOrder(Order);
         }
         else
@@ -186,8 +282,15 @@ void URTSOrderComponent::ClearOrderQueue()
     }
 
     // Clear the order cue when another order is issued.
-    OrderQueue.Empty();
+    QueuedOrders.Reset();
     OnOrderQueueCleared.Broadcast();
+    AbortPathPrefetch();
+
+    // Drop pending orders that would have been added to the queue.
+    PendingOrders.RemoveAll([](const FRTSPendingOrder& PendingOrder) {
+        return PendingOrder.IssueMode == ERTSOrderIssueMode::ENQUEUE ||
+               PendingOrder.IssueMode == ERTSOrderIssueMode::INSERT_AFTER_CURRENT_ORDER;
+    });
 }
 
 void URTSOrderComponent::EnqueueOrder(const FRTSOrderData& Order)
@@ -202,12 +305,17 @@ void URTSOrderComponent::EnqueueOrder(const FRTSOrderData& Order)
         return;
     }
 
+    if (DeferOrderUntilLoaded(Order, ERTSOrderIssueMode::ENQUEUE))
+    {
+        return;
+    }
+
     if (!CheckOrder(Order))
     {
         return;
     }
 
-    if (OrderQueue.Num() == 0 && CurrentOrder.OrderType == StopOrder)
+    if (QueuedOrders.IsEmpty() && CurrentOrder.OrderType == StopOrder)
     {
         ObeyOrder(Order);
     }
@@ -215,15 +323,16 @@ void URTSOrderComponent::EnqueueOrder(const FRTSOrderData& Order)
     else
     {
         // Do nothing if we are obeying exact the same order already (and I mean exact: Not only the same order type)
-        if (OrderQueue.Num() > 0 && OrderQueue.Last() == Order)
+        if (!QueuedOrders.IsEmpty() && QueuedOrders.Last() == Order)
         {
             return;
         }
 
-        OrderQueue.Add(Order);
+        QueuedOrders.PushBack(Order);
         OnOrderEnqueued.Broadcast(Order);
 
         UpdateOrderPreviews();
+        PrefetchNextPath();
     }
 }
 
@@ -239,19 +348,26 @@ void URTSOrderComponent::InsertOrderAfterCurrentOrder(const FRTSOrderData& Order
         return;
     }
 
+    if (DeferOrderUntilLoaded(Order, ERTSOrderIssueMode::INSERT_AFTER_CURRENT_ORDER))
+    {
+        return;
+    }
+
     if (!CheckOrder(Order))
     {
         return;
     }
 
-    if (OrderQueue.Num() == 0 && CurrentOrder.OrderType == StopOrder)
+    if (QueuedOrders.IsEmpty() && CurrentOrder.OrderType == StopOrder)
     {
         ObeyOrder(Order);
     }
 
     bIsHomeLocationSet = false;
 
-    OrderQueue.Insert(Order, 0);
+    QueuedOrders.PushFront(Order);
+
+    PrefetchNextPath();
 }
 
 void URTSOrderComponent::InsertOrderBeforeCurrentOrder(const FRTSOrderData& Order)
@@ -266,13 +382,18 @@ void URTSOrderComponent::InsertOrderBeforeCurrentOrder(const FRTSOrderData& Orde
         return;
     }
 
+    if (DeferOrderUntilLoaded(Order, ERTSOrderIssueMode::INSERT_BEFORE_CURRENT_ORDER))
+    {
+        return;
+    }
+
     if (!CheckOrder(Order))
     {
         return;
     }
 
     // Queue the current order.
-    OrderQueue.Insert(CurrentOrder, 0);
+    QueuedOrders.PushFront(CurrentOrder);
 
     // Save home location of the current order.
     ARTSCharacterAIController* Controller = Cast<ARTSCharacterAIController>(Cast<APawn>(GetOwner())->GetController());
@@ -305,7 +426,9 @@ FRTSOrderData URTSOrderComponent::GetCurrentOrderData() const
 
 TArray<FRTSOrderData> URTSOrderComponent::GetCurrentOrderDataQueue() const
 {
-    return OrderQueue;
+    TArray<FRTSOrderData> Orders;
+    QueuedOrders.ToArray(Orders);
+    return Orders;
 }
 
 AActor* URTSOrderComponent::GetCurrentOrderTargetActor() const
@@ -326,6 +449,20 @@ int32 URTSOrderComponent::GetCurrentOrderTargetIndex() const
 void URTSOrderComponent::ObeyOrder(const FRTSOrderData& Order)
 {
     AActor* Owner = GetOwner();
+
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject == nullptr)
+    {
+        UE_LOG(LogRTS, Error, TEXT("URTSOrderComponent::ObeyOrder: The order %s for the actor '%s' is invalid."),
+               *Order.ToString(), *Owner->GetName());
+        return;
+    }
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+    // Queued orders haven't been recorded when they were issued.
+    LifecycleTrace.MarkStage(Order.OrderType.ToSoftObjectPath().GetAssetPathName(), ERTSOrderLifecycleStage::OBEYED);
+#endif
+
     FRTSOrderTargetData TargetData = URTSOrderHelper::CreateOrderTargetData(Owner, Order.Target, Order.Location);
 
     // Find the correct home location value for this order.
@@ -341,7 +478,7 @@ void URTSOrderComponent::ObeyOrder(const FRTSOrderData& Order)
         HomeLocation = Owner->GetActorLocation();
     }
 
-    switch (URTSOrderHelper::GetOrderProcessPolicy(Order.OrderType, Owner, Order.Index))
+    switch (OrderObject->GetOrderProcessPolicy(Owner, Order.Index))
     {
         case ERTSOrderProcessPolicy::INSTANT:
         {
@@ -350,36 +487,28 @@ void URTSOrderComponent::ObeyOrder(const FRTSOrderData& Order)
             // Some Abilities etc.).
             // Note: It is currently not possible to queue instant order because of the missing callback.
             // Maybe 'ObeyOrder' needs a return value that describes if the order is in progress or finished.
-            Order.OrderType->GetDefaultObject<URTSOrder>()->IssueOrder(Owner, TargetData, Order.Index,
-                                                                       FRTSOrderCallback(), HomeLocation);
+            OrderObject->IssueOrder(Owner, TargetData, Order.Index, FRTSOrderCallback(), HomeLocation);
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+            LifecycleTrace.EndOrder();
+#endif
         }
         break;
         case ERTSOrderProcessPolicy::CAN_BE_CANCELED:
         case ERTSOrderProcessPolicy::CAN_NOT_BE_CANCELED:
         {
-            if (CurrentOrder.OrderType != StopOrder)
-
-            {
-                UnregisterTagListeners(CurrentOrder);
-            }
-
             SetCurrentOrder(Order);
 
             FRTSOrderCallback Callback;
             Callback.AddDynamic(this, &URTSOrderComponent::OnOrderEndedCallback);
 
-            if (!Order.OrderType.IsValid())
-            {
-                Order.OrderType.LoadSynchronous();
-            }
+            // The stop order can't be canceled by tag changes.
+            UpdateTagListeners(Order.OrderType != StopOrder ? Order : FRTSOrderData());
 
-            if (Order.OrderType != StopOrder)
-            {
-                RegisterTagListeners(Order);
-            }
+            OrderObject->IssueOrder(Owner, TargetData, Order.Index, Callback, HomeLocation);
 
-            Order.OrderType->GetDefaultObject<URTSOrder>()->IssueOrder(Owner, TargetData, Order.Index, Callback,
-                                                                       HomeLocation);
+            // Find the path for the next waypoint while moving to this one.
+            PrefetchNextPath();
         }
         break;
         default:
@@ -393,13 +522,9 @@ bool URTSOrderComponent::CheckOrder(const FRTSOrderData& Order) const
     FRTSOrderErrorTags OrderErrorTags;
 
     AActor* OrderedActor = GetOwner();
-    if (!Order.OrderType.IsValid())
-    {
-        Order.OrderType.LoadSynchronous();
-    }
 
-    TSubclassOf<URTSOrder> OrderType = Order.OrderType.Get();
-    if (OrderType == nullptr)
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject == nullptr)
     {
         UE_LOG(LogRTS, Error,
                TEXT("URTSOrderComponent::CheckOrder: The specified order for the actor '%s' is invalid."),
@@ -407,23 +532,28 @@ bool URTSOrderComponent::CheckOrder(const FRTSOrderData& Order) const
         return false;
     }
 
-    if (!URTSOrderHelper::CanObeyOrder(OrderType.Get(), OrderedActor, Order.Index, &OrderErrorTags))
+    const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements =
+        GetTagRequirements(OrderObject, Order.Index);
+
+    if (!URTSOrderHelper::CanObeyOrder(OrderObject, OrderedActor, Order.Index, &OrderErrorTags,
+                                       &TagRequirements.Get()))
     {
         LogOrderErrorMessage(
             FString::Printf(TEXT("URTSOrderComponent::CheckOrder: The actor '%s' cannot obey the order '%s'."),
-                            *OrderedActor->GetName(), *OrderType->GetName()),
+                            *OrderedActor->GetName(), *OrderObject->GetClass()->GetName()),
             OrderErrorTags);
         return false;
     }
 
     FRTSOrderTargetData TargetData = URTSOrderHelper::CreateOrderTargetData(OrderedActor, Order.Target, Order.Location);
-    if (!URTSOrderHelper::IsValidTarget(OrderType.Get(), OrderedActor, TargetData, Order.Index, &OrderErrorTags))
+    if (!URTSOrderHelper::IsValidTarget(OrderObject, OrderedActor, TargetData, Order.Index, &OrderErrorTags,
+                                        &TagRequirements.Get()))
     {
         LogOrderErrorMessage(
             FString::Printf(
                 TEXT("URTSOrderComponent::CheckOrder: The actor '%s' was issued to obey the order '%s', but the "
                      "target data is invalid: %s"),
-                *OrderedActor->GetName(), *OrderType->GetName(), *TargetData.ToString()),
+                *OrderedActor->GetName(), *OrderObject->GetClass()->GetName(), *TargetData.ToString()),
             OrderErrorTags);
         return false;
     }
@@ -431,6 +561,13 @@ bool URTSOrderComponent::CheckOrder(const FRTSOrderData& Order) const
     return true;
 }
 
+void URTSOrderComponent::TraceOrderLifecycleStage(ERTSOrderLifecycleStage Stage)
+{
+#if RTS_ORDER_LIFECYCLE_TRACE
+    LifecycleTrace.MarkStage(Stage);
+#endif
+}
+
 void URTSOrderComponent::LogOrderErrorMessage(const FString& Message, const FRTSOrderErrorTags& OrderErrorTags) const
 {
     // TODO: Better formatting?
@@ -440,6 +577,10 @@ void URTSOrderComponent::LogOrderErrorMessage(const FString& Message, const FRTS
 
 void URTSOrderComponent::OnOrderEndedCallback(ERTSOrderResult OrderResult)
 {
+#if RTS_ORDER_LIFECYCLE_TRACE
+    LifecycleTrace.EndOrder();
+#endif
+
     OrderEnded(OrderResult);
 }
 
@@ -468,18 +609,18 @@ void URTSOrderComponent::OrderEnded(ERTSOrderResult OrderResult)
             }
             // Fall through if succeeded
         case ERTSOrderResult::SUCCEEDED:
-            if (OrderQueue.IsValidIndex(0))
+            if (!QueuedOrders.IsEmpty())
             {
-                const FRTSOrderData NewOrder = OrderQueue[0];
+                const FRTSOrderData NewOrder = QueuedOrders.First();
 
                 if (CheckOrder(NewOrder))
                 {
-                    OrderQueue.RemoveAt(0);
+                    QueuedOrders.PopFront();
                     ObeyOrder(NewOrder);
                     return;
                 }
 
-                OrderQueue.Empty();
+                QueuedOrders.Reset();
                 ObeyStopOrder();
             }
 
@@ -498,38 +639,216 @@ void URTSOrderComponent::OrderCanceled()
     FRTSOrderTargetData TargetData =
         URTSOrderHelper::CreateOrderTargetData(Owner, CurrentOrder.Target, CurrentOrder.Location);
 
-    UClass* OrderType = nullptr;
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(CurrentOrder);
+    if (OrderObject != nullptr)
+    {
+        OrderObject->OrderCanceled(Owner, TargetData, CurrentOrder.Index);
+    }
+}
+
+void URTSOrderComponent::PreloadOrderTypes()
+{
+    AActor* Owner = GetOwner();
+
+    TArray<FSoftObjectPath> OrderTypePaths;
+    OrderTypePaths.Add(StopOrder.ToSoftObjectPath());
+    OrderTypePaths.Add(BeginConstructionOrder.ToSoftObjectPath());
 
-    if (!CurrentOrder.OrderType.IsValid())
+    // Find all auto orders.
+    TArray<FRTSOrderTypeWithIndex> AutoOrders;
+
+    UClass* ProviderInterfaceClass = URTSAutoOrderProvider::StaticClass();
+    if (Owner->GetClass()->ImplementsInterface(ProviderInterfaceClass))
     {
-        OrderType = CurrentOrder.OrderType.LoadSynchronous();
+        IRTSAutoOrderProvider::Execute_GetAutoOrders(Owner, AutoOrders);
     }
-    else
+
+    for (UActorComponent* Component : Owner->GetComponents())
     {
-        OrderType = CurrentOrder.OrderType.Get();
+        if (Component->GetClass()->ImplementsInterface(ProviderInterfaceClass))
+        {
+            IRTSAutoOrderProvider::Execute_GetAutoOrders(Component, AutoOrders);
+        }
     }
 
-    if (OrderType != nullptr)
+    for (const FRTSOrderTypeWithIndex& AutoOrder : AutoOrders)
     {
-        OrderType->GetDefaultObject<URTSOrder>()->OrderCanceled(Owner, TargetData, CurrentOrder.Index);
+        OrderTypePaths.AddUnique(AutoOrder.OrderType.ToSoftObjectPath());
     }
+
+    // Find the order for using abilities.
+    URTSAbilitySystemComponent* AbilitySystem = Owner->FindComponentByClass<URTSAbilitySystemComponent>();
+    if (AbilitySystem != nullptr)
+    {
+        OrderTypePaths.AddUnique(AbilitySystem->GetUseAbilityOrder().ToSoftObjectPath());
+    }
+
+    FRTSOrderTypeRegistry::Get().LoadAsync(
+        OrderTypePaths, FStreamableDelegate::CreateUObject(this, &URTSOrderComponent::OnPendingOrderTypesLoaded));
 }
 
-void URTSOrderComponent::RegisterTagListeners(const FRTSOrderData& Order)
+bool URTSOrderComponent::DeferOrderUntilLoaded(const FRTSOrderData& Order, ERTSOrderIssueMode IssueMode)
 {
-    AActor* Owner = GetOwner();
-    FRTSOrderTagRequirements TagRequirements;
-    URTSOrderHelper::GetOrderTagRequirements(Order.OrderType, Owner, Order.Index, TagRequirements);
+    if (bIsIssuingPendingOrders)
+    {
+        return false;
+    }
 
-    UAbilitySystemComponent* OwnerAbilitySystem = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Owner);
+    FRTSOrderTypeRegistry& OrderTypeRegistry = FRTSOrderTypeRegistry::Get();
+    const FSoftObjectPath& OrderTypePath = Order.OrderType.ToSoftObjectPath();
+
+    // Orders must not overtake orders that are still waiting for their order types.
+    if (PendingOrders.Num() == 0 && OrderTypeRegistry.IsLoaded(OrderTypePath))
+    {
+        return false;
+    }
 
-    // Owner tags
-    //
+    PendingOrders.Add(FRTSPendingOrder(Order, IssueMode));
 
-    if (OwnerAbilitySystem != nullptr)
+    TArray<FSoftObjectPath> OrderTypePaths;
+    OrderTypePaths.Add(OrderTypePath);
+
+    OrderTypeRegistry.LoadAsync(OrderTypePaths,
+                                FStreamableDelegate::CreateUObject(
+                                    this, &URTSOrderComponent::OnPendingOrderTypeLoaded, OrderTypePath));
+    return true;
+}
+
+void URTSOrderComponent::OnPendingOrderTypeLoaded(FSoftObjectPath OrderTypePath)
+{
+    // Loading has finished, so the order type will never be available if it isn't loaded now.
+    if (!bIsIssuingPendingOrders && !FRTSOrderTypeRegistry::Get().IsLoaded(OrderTypePath))
     {
-        FGameplayTagContainer OwnerTags;
-        for (FGameplayTag Tag : TagRequirements.SourceRequiredTags)
+        const int32 NumDropped = PendingOrders.RemoveAll([&OrderTypePath](const FRTSPendingOrder& PendingOrder) {
+            return PendingOrder.Order.OrderType.ToSoftObjectPath() == OrderTypePath;
+        });
+
+        if (NumDropped > 0)
+        {
+            UE_LOG(LogRTS, Error, TEXT("%s dropped %d pending orders, because order type %s could not be loaded."),
+                   *GetOwner()->GetName(), NumDropped, *OrderTypePath.ToString());
+        }
+    }
+
+    OnPendingOrderTypesLoaded();
+}
+
+void URTSOrderComponent::OnPendingOrderTypesLoaded()
+{
+    if (bIsIssuingPendingOrders)
+    {
+        return;
+    }
+
+    TGuardValue<bool> IssuingPendingOrdersGuard(bIsIssuingPendingOrders, true);
+    FRTSOrderTypeRegistry& OrderTypeRegistry = FRTSOrderTypeRegistry::Get();
+
+    while (PendingOrders.Num() > 0 &&
+           OrderTypeRegistry.IsLoaded(PendingOrders[0].Order.OrderType.ToSoftObjectPath()))
+    {
+        FRTSPendingOrder PendingOrder = PendingOrders[0];
+        PendingOrders.RemoveAt(0);
+
+        switch (PendingOrder.IssueMode)
+        {
+            case ERTSOrderIssueMode::ISSUE:
+                IssueOrder(PendingOrder.Order);
+                break;
+            case ERTSOrderIssueMode::ENQUEUE:
+                EnqueueOrder(PendingOrder.Order);
+                break;
+            case ERTSOrderIssueMode::INSERT_AFTER_CURRENT_ORDER:
+                InsertOrderAfterCurrentOrder(PendingOrder.Order);
+                break;
+            case ERTSOrderIssueMode::INSERT_BEFORE_CURRENT_ORDER:
+                InsertOrderBeforeCurrentOrder(PendingOrder.Order);
+                break;
+            default:
+                check(0);
+                break;
+        }
+    }
+}
+
+ERTSOrderProcessPolicy URTSOrderComponent::GetOrderProcessPolicy(const FRTSOrderData& Order) const
+{
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject == nullptr)
+    {
+        return ERTSOrderProcessPolicy::CAN_BE_CANCELED;
+    }
+
+    return OrderObject->GetOrderProcessPolicy(GetOwner(), Order.Index);
+}
+
+TSharedRef<const FRTSCompiledOrderTagRequirements>
+URTSOrderComponent::GetTagRequirements(const FRTSOrderData& Order) const
+{
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject == nullptr)
+    {
+        static const TSharedRef<const FRTSCompiledOrderTagRequirements> EmptyTagRequirements =
+            MakeShared<FRTSCompiledOrderTagRequirements>();
+        return EmptyTagRequirements;
+    }
+
+    return GetTagRequirements(OrderObject, Order.Index);
+}
+
+TSharedRef<const FRTSCompiledOrderTagRequirements> URTSOrderComponent::GetTagRequirements(const URTSOrder* OrderObject,
+                                                                                          int32 Index) const
+{
+    // Recompile all requirements with the new network indices of their tags if the tag dictionary has changed.
+    const uint32 DictionaryGeneration = FRTSTagBitset::GetDictionaryGeneration();
+    if (CachedTagRequirementsGeneration != DictionaryGeneration)
+    {
+        CachedTagRequirements.Reset();
+        CachedTagRequirementsGeneration = DictionaryGeneration;
+    }
+
+    TPair<const URTSOrder*, int32> Key(OrderObject, Index);
+
+    const TSharedPtr<const FRTSCompiledOrderTagRequirements>* CachedRequirements = CachedTagRequirements.Find(Key);
+    if (CachedRequirements != nullptr)
+    {
+        INC_DWORD_STAT(STAT_RTSOrderTagRequirementsCacheHits);
+        return CachedRequirements->ToSharedRef();
+    }
+
+    INC_DWORD_STAT(STAT_RTSOrderTagRequirementsCacheMisses);
+
+    // Shared, so callers can keep using the requirements while the cache is changed.
+    TSharedRef<FRTSCompiledOrderTagRequirements> TagRequirements = MakeShared<FRTSCompiledOrderTagRequirements>();
+    OrderObject->GetTagRequirements(GetOwner(), Index, *TagRequirements);
+    TagRequirements->Compile();
+
+    CachedTagRequirements.Add(Key, TagRequirements);
+    return TagRequirements;
+}
+
+void URTSOrderComponent::InvalidateTagRequirements()
+{
+    CachedTagRequirements.Reset();
+}
+
+void URTSOrderComponent::UpdateTagListeners(const FRTSOrderData& Order)
+{
+    AActor* Owner = GetOwner();
+
+    FGameplayTagContainer OwnerTags;
+    FGameplayTagContainer TargetTags;
+    UAbilitySystemComponent* TargetAbilitySystem = nullptr;
+
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject != nullptr)
+    {
+        const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements =
+            GetTagRequirements(OrderObject, Order.Index);
+
+        // Owner tags
+        //
+
+        for (FGameplayTag Tag : TagRequirements->SourceRequiredTags)
         {
             // Don't register a delegate for permanent status tags.
             if (!Tag.MatchesTag(URTSGlobalTags::Status_Permanent()))
@@ -538,7 +857,7 @@ void URTSOrderComponent::RegisterTagListeners(const FRTSOrderData& Order)
             }
         }
 
-        for (FGameplayTag Tag : TagRequirements.SourceBlockedTags)
+        for (FGameplayTag Tag : TagRequirements->SourceBlockedTags)
         {
             // Don't register a delegate for permanent status tags.
             if (!Tag.MatchesTag(URTSGlobalTags::Status_Permanent()))
@@ -548,35 +867,22 @@ void URTSOrderComponent::RegisterTagListeners(const FRTSOrderData& Order)
         }
 
         // TODO: Hard coded check for visibility change. Is their a more generic way todo this?
-        if (TagRequirements.TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
+        if (TagRequirements->TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
         {
             OwnerTags.AddTag(URTSGlobalTags::Status_Changing_Detector());
         }
 
-        // Register a callback for each of the tags to check if it was added to or removed.
-        for (FGameplayTag Tag : OwnerTags)
-        {
-            FOnGameplayEffectTagCountChanged& Delegate =
-                OwnerAbilitySystem->RegisterGameplayTagEvent(Tag, EGameplayTagEventType::NewOrRemoved);
+        // Target tags
+        //
 
-            FDelegateHandle DelegateHandle = Delegate.AddUObject(this, &URTSOrderComponent::OnOwnerTagsChanged);
-            RegisteredOwnerTagEventHandles.Add(Tag, DelegateHandle);
+        if (OrderObject->GetTargetType(Owner, Order.Index) == ERTSTargetType::ACTOR)
+        {
+            TargetAbilitySystem = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Order.Target);
         }
-    }
-
-    // Target tags
-    //
-
-    ERTSTargetType TargetType = URTSOrderHelper::GetTargetType(Order.OrderType, Owner, Order.Index);
-    if (TargetType == ERTSTargetType::ACTOR)
-    {
-        UAbilitySystemComponent* TargetAbilitySystem =
-            UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Order.Target);
 
         if (TargetAbilitySystem != nullptr)
         {
-            FGameplayTagContainer TargetTags;
-            for (FGameplayTag Tag : TagRequirements.TargetRequiredTags)
+            for (FGameplayTag Tag : TagRequirements->TargetRequiredTags)
             {
                 // Don't register a delegate for permanent status tags.
                 if (!Tag.MatchesTag(URTSGlobalTags::Status_Permanent()))
@@ -585,7 +891,7 @@ void URTSOrderComponent::RegisterTagListeners(const FRTSOrderData& Order)
                 }
             }
 
-            for (FGameplayTag Tag : TagRequirements.TargetBlockedTags)
+            for (FGameplayTag Tag : TagRequirements->TargetBlockedTags)
             {
                 // Don't register a delegate for permanent status tags.
                 if (!Tag.MatchesTag(URTSGlobalTags::Status_Permanent()))
@@ -595,86 +901,102 @@ void URTSOrderComponent::RegisterTagListeners(const FRTSOrderData& Order)
             }
 
             // TODO: Hard coded check for visibility change. Is their a more generic way todo this?
-            if (TagRequirements.TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
+            if (TagRequirements->TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
             {
                 TargetTags.AddTag(URTSGlobalTags::Status_Changing_Stealthed());
             }
+        }
+    }
 
-            // Register a callback for each of the tags to check if it was added to or removed.
-            for (FGameplayTag Tag : TargetTags)
-            {
-                FOnGameplayEffectTagCountChanged& Delegate =
-                    TargetAbilitySystem->RegisterGameplayTagEvent(Tag, EGameplayTagEventType::NewOrRemoved);
+    // The owner ability system never changes, so only listeners for tags that have changed need to be updated.
+    UAbilitySystemComponent* OwnerAbilitySystem = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Owner);
+    if (OwnerAbilitySystem != nullptr)
+    {
+        UpdateTagEventHandles(OwnerAbilitySystem, OwnerTags, RegisteredOwnerTagEventHandles,
+                              &URTSOrderComponent::OnOwnerTagsChanged);
+    }
 
-                FDelegateHandle DelegateHandle = Delegate.AddUObject(this, &URTSOrderComponent::OnTargetTagsChanged);
-                RegisteredTargetTagEventHandles.Add(Tag, DelegateHandle);
-            }
+    // Listeners on a previous target have to be removed entirely.
+    UAbilitySystemComponent* PreviousTargetAbilitySystem = RegisteredTargetAbilitySystem.Get();
+    if (PreviousTargetAbilitySystem != TargetAbilitySystem)
+    {
+        if (PreviousTargetAbilitySystem != nullptr)
+        {
+            UpdateTagEventHandles(PreviousTargetAbilitySystem, FGameplayTagContainer::EmptyContainer,
+                                  RegisteredTargetTagEventHandles, &URTSOrderComponent::OnTargetTagsChanged);
         }
+
+        // The previous target might have been destroyed, taking its delegates with it.
+        RegisteredTargetTagEventHandles.Reset();
+        RegisteredTargetAbilitySystem = TargetAbilitySystem;
+    }
+
+    if (TargetAbilitySystem != nullptr)
+    {
+        UpdateTagEventHandles(TargetAbilitySystem, TargetTags, RegisteredTargetTagEventHandles,
+                              &URTSOrderComponent::OnTargetTagsChanged);
     }
 }
 
-void URTSOrderComponent::UnregisterTagListeners(const FRTSOrderData& Order)
+void URTSOrderComponent::UpdateTagEventHandles(UAbilitySystemComponent* AbilitySystem,
+                                               const FGameplayTagContainer& Tags,
+                                               TMap<FGameplayTag, FDelegateHandle>& TagEventHandles,
+                                               void (URTSOrderComponent::*Callback)(const FGameplayTag, int32))
 {
-    AActor* Owner = GetOwner();
-    FRTSOrderTagRequirements TagRequirements;
-    URTSOrderHelper::GetOrderTagRequirements(Order.OrderType, Owner, Order.Index, TagRequirements);
-
-    UAbilitySystemComponent* OwnerAbilitySystem = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Owner);
+    int32 NumAdded = 0;
+    int32 NumRemoved = 0;
 
-    // Owner tags
-    //
-
-    if (OwnerAbilitySystem != nullptr)
+    // Remove callbacks for tags that are no longer relevant.
+    for (auto It = TagEventHandles.CreateIterator(); It; ++It)
     {
-        for (TPair<FGameplayTag, FDelegateHandle> Pair : RegisteredOwnerTagEventHandles)
+        if (Tags.HasTagExact(It.Key()))
         {
-            FOnGameplayEffectTagCountChanged& Delegate =
-                OwnerAbilitySystem->RegisterGameplayTagEvent(Pair.Key, EGameplayTagEventType::NewOrRemoved);
-
-            Delegate.Remove(Pair.Value);
+            continue;
         }
 
-        RegisteredOwnerTagEventHandles.Empty();
-    }
+        FOnGameplayEffectTagCountChanged& Delegate =
+            AbilitySystem->RegisterGameplayTagEvent(It.Key(), EGameplayTagEventType::NewOrRemoved);
 
-    // Target tags
-    //
+        Delegate.Remove(It.Value());
+        It.RemoveCurrent();
 
-    ERTSTargetType TargetType = URTSOrderHelper::GetTargetType(Order.OrderType, Owner, Order.Index);
-    if (TargetType == ERTSTargetType::ACTOR)
-    {
-        UAbilitySystemComponent* TargetAbilitySystem =
-            UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Order.Target);
+        ++NumRemoved;
+    }
 
-        if (TargetAbilitySystem != nullptr)
+    // Register a callback for each of the new tags to check if it was added to or removed.
+    for (FGameplayTag Tag : Tags)
+    {
+        if (TagEventHandles.Contains(Tag))
         {
-            for (TPair<FGameplayTag, FDelegateHandle> Pair : RegisteredTargetTagEventHandles)
-            {
-                FOnGameplayEffectTagCountChanged& Delegate =
-                    TargetAbilitySystem->RegisterGameplayTagEvent(Pair.Key, EGameplayTagEventType::NewOrRemoved);
+            continue;
+        }
 
-                Delegate.Remove(Pair.Value);
-            }
+        FOnGameplayEffectTagCountChanged& Delegate =
+            AbilitySystem->RegisterGameplayTagEvent(Tag, EGameplayTagEventType::NewOrRemoved);
 
-            RegisteredTargetTagEventHandles.Empty();
-        }
+        FDelegateHandle DelegateHandle = Delegate.AddUObject(this, Callback);
+        TagEventHandles.Add(Tag, DelegateHandle);
+
+        ++NumAdded;
     }
+
+    INC_DWORD_STAT_BY(STAT_RTSOrderTagListenersAdded, NumAdded);
+    INC_DWORD_STAT_BY(STAT_RTSOrderTagListenersRemoved, NumRemoved);
 }
 
 void URTSOrderComponent::OnTargetTagsChanged(const FGameplayTag Tag, int32 NewCount)
 {
-    FRTSOrderTagRequirements TagRequirements;
-    URTSOrderHelper::GetOrderTagRequirements(CurrentOrder.OrderType, GetOwner(), CurrentOrder.Index, TagRequirements);
+    const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements = GetTagRequirements(CurrentOrder);
 
-    if ((NewCount && TagRequirements.TargetBlockedTags.HasTag(Tag)) ||
-        (!NewCount && TagRequirements.TargetRequiredTags.HasTag(Tag)))
+    if ((NewCount && TagRequirements->TargetBlockedTags.HasTag(Tag)) ||
+        (!NewCount && TagRequirements->TargetRequiredTags.HasTag(Tag)))
     {
         OrderEnded(ERTSOrderResult::CANCELED);
     }
 
     // TODO: Hard coded check for visibility change. Is their a more generic way todo this?
     else if (NewCount && Tag == URTSGlobalTags::Status_Changing_Stealthed() &&
-             TagRequirements.TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
+             TagRequirements->TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
     {
         if (!URTSAbilitySystemHelper::IsVisibleForActor(GetOwner(), CurrentOrder.Target))
         {
@@ -685,18 +1007,17 @@ void URTSOrderComponent::OnTargetTagsChanged(const FGameplayTag Tag, int32 NewCo
 
 void URTSOrderComponent::OnOwnerTagsChanged(const FGameplayTag Tag, int32 NewCount)
 {
-    FRTSOrderTagRequirements TagRequirements;
-    URTSOrderHelper::GetOrderTagRequirements(CurrentOrder.OrderType, GetOwner(), CurrentOrder.Index, TagRequirements);
+    const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements = GetTagRequirements(CurrentOrder);
 
-    if ((NewCount && TagRequirements.SourceBlockedTags.HasTag(Tag)) ||
-        !NewCount && TagRequirements.SourceRequiredTags.HasTag(Tag))
+    if ((NewCount && TagRequirements->SourceBlockedTags.HasTag(Tag)) ||
+        !NewCount && TagRequirements->SourceRequiredTags.HasTag(Tag))
     {
         OrderEnded(ERTSOrderResult::CANCELED);
     }
 
     // TODO: Hard coded check for visibility change. Is their a more generic way todo this?
     else if (!NewCount && Tag == URTSGlobalTags::Status_Changing_Detector() &&
-             TagRequirements.TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
+             TagRequirements->TargetRequiredTags.HasTag(URTSGlobalTags::Relationship_Visible()))
     {
         if (!URTSAbilitySystemHelper::IsVisibleForActor(GetOwner(), CurrentOrder.Target))
         {
@@ -713,12 +1034,130 @@ void URTSOrderComponent::ObeyStopOrder()
         return;
     }
 
-    if (!StopOrder.IsValid())
+    ObeyOrder(FRTSOrderData(StopOrder));
+}
+
+void URTSOrderComponent::PrefetchNextPath()
+{
+    AActor* Owner = GetOwner();
+    if (QueuedOrders.IsEmpty() || !Owner->HasAuthority())
     {
-        StopOrder.LoadSynchronous();
+        AbortPathPrefetch();
+        return;
     }
 
-    ObeyOrder(FRTSOrderData(StopOrder));
+    // Keep the path that has been found, or is being found, for the next order.
+    const FRTSOrderData& NextOrder = QueuedOrders.First();
+    if (NextOrder.PrefetchedPath.IsValid() ||
+        (PathPrefetchQueryId != INVALID_NAVQUERYID && PathPrefetchLocation == NextOrder.Location))
+    {
+        return;
+    }
+
+    AbortPathPrefetch();
+
+    if (!NextOrder.bUseLocation)
+    {
+        return;
+    }
+
+    const URTSOrder* NextOrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(NextOrder);
+    if (NextOrderObject == nullptr || !NextOrderObject->IsA<URTSMoveOrder>())
+    {
+        return;
+    }
+
+    const INavAgentInterface* NavAgent = Cast<INavAgentInterface>(Owner);
+    UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    if (NavAgent == nullptr || NavigationSystem == nullptr)
+    {
+        return;
+    }
+
+    const FNavAgentProperties& AgentProperties = NavAgent->GetNavAgentPropertiesRef();
+    const ANavigationData* NavData = NavigationSystem->GetNavDataForProps(AgentProperties);
+    if (NavData == nullptr)
+    {
+        return;
+    }
+
+    // The next order starts where the current one ends.
+    const FVector OwnerLocation = Owner->GetActorLocation();
+    const FVector Start =
+        CurrentOrder.bUseLocation ? FVector(CurrentOrder.Location, OwnerLocation.Z) : OwnerLocation;
+    const FVector End(NextOrder.Location, OwnerLocation.Z);
+
+    FPathFindingQuery Query(Owner, *NavData, Start, End, NavData->GetDefaultQueryFilter());
+
+    PathPrefetchLocation = NextOrder.Location;
+    PathPrefetchQueryId = NavigationSystem->FindPathAsync(
+        AgentProperties, Query, FNavPathQueryDelegate::CreateUObject(this, &URTSOrderComponent::OnPathPrefetched));
+
+    INC_DWORD_STAT(STAT_RTSOrderPathsPrefetched);
+}
+
+void URTSOrderComponent::AbortPathPrefetch()
+{
+    if (PathPrefetchQueryId == INVALID_NAVQUERYID)
+    {
+        return;
+    }
+
+    UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    if (NavigationSystem != nullptr)
+    {
+        NavigationSystem->AbortAsyncFindPathRequest(PathPrefetchQueryId);
+    }
+
+    PathPrefetchQueryId = INVALID_NAVQUERYID;
+}
+
+void URTSOrderComponent::OnPathPrefetched(uint32 QueryId, ENavigationQueryResult::Type Result,
+                                          FNavPathSharedPtr Path)
+{
+    if (QueryId != PathPrefetchQueryId)
+    {
+        return;
+    }
+
+    PathPrefetchQueryId = INVALID_NAVQUERYID;
+
+    if (Result != ENavigationQueryResult::Success || !Path.IsValid())
+    {
+        return;
+    }
+
+    // The queue might have changed without a new path being requested.
+    if (QueuedOrders.IsEmpty() || !QueuedOrders.First().bUseLocation ||
+        QueuedOrders.First().Location != PathPrefetchLocation)
+    {
+        return;
+    }
+
+    QueuedOrders.First().PrefetchedPath = Path;
+}
+
+FNavPathSharedPtr URTSOrderComponent::ConsumePrefetchedPath(const FVector& TargetLocation)
+{
+    FNavPathSharedPtr Path = CurrentOrder.PrefetchedPath;
+    CurrentOrder.PrefetchedPath.Reset();
+
+    if (!Path.IsValid() || !Path->IsValid() || !CurrentOrder.bUseLocation ||
+        FVector2D::DistSquared(CurrentOrder.Location, FVector2D(TargetLocation)) > 1.0f)
+    {
+        return nullptr;
+    }
+
+    // The previous order might have ended before reaching its target location, e.g. because it has been canceled.
+    const float MaxStartDistance = CVarRTSPathPrefetchMaxStartDistance.GetValueOnGameThread();
+    if (FVector::DistSquared2D(Path->GetPathPoints()[0].Location, GetOwner()->GetActorLocation()) >
+        FMath::Square(MaxStartDistance))
+    {
+        return nullptr;
+    }
+
+    INC_DWORD_STAT(STAT_RTSOrderPrefetchedPathsUsed);
+    return Path;
 }
 
 AActor* URTSOrderComponent::CreateOrderPreviewActor(const FRTSOrderData& Order)
@@ -780,8 +1219,8 @@ void URTSOrderComponent::OnDeselected()
     // Destroy previews except for construction previews.
     for (int32 Index = OrderPreviewActors.Num() - 1; Index > 0; --Index)
     {
-        if (OrderPreviewActors.IsValidIndex(Index) && OrderQueue.IsValidIndex(Index - 1) &&
-            OrderQueue[Index - 1].OrderType != BeginConstructionOrder)
+        if (OrderPreviewActors.IsValidIndex(Index) && QueuedOrders.IsValidIndex(Index - 1) &&
+            QueuedOrders[Index - 1].OrderType != BeginConstructionOrder)
         {
             OrderPreviewActors[Index]->Destroy();
             OrderPreviewActors.RemoveAt(Index);
@@ -832,12 +1271,12 @@ void URTSOrderComponent::UpdateOrderPreviews()
     // Spawn new previews.
     bool bSelected = SelectableComponent != nullptr && SelectableComponent->IsSelected();
 
-    if ((bSelected && OrderQueue.Num() > 0) || CurrentOrder.OrderType == BeginConstructionOrder)
+    if ((bSelected && QueuedOrders.Num() > 0) || CurrentOrder.OrderType == BeginConstructionOrder)
     {
         CreateOrderPreviewActor(CurrentOrder);
     }
 
-    for (const FRTSOrderData& OrderData : OrderQueue)
+    for (const FRTSOrderData& OrderData : GetCurrentOrderDataQueue())
     {
         if (bSelected || OrderData.OrderType == BeginConstructionOrder)
         {
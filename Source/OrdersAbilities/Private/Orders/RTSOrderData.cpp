@@ -1,8 +1,23 @@
 #include "Orders/RTSOrderData.h"
 
+#include "OrdersAbilities.h"
+
+#include "HAL/IConsoleManager.h"
 #include "GameFramework/Actor.h"
+#include "UObject/CoreNet.h"
 
 #include "Orders/RTSOrder.h"
+#include "Orders/RTSOrderTypeRegistry.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Data Serialized"), STAT_RTSOrderDataSerialized, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Data Payload Bits"), STAT_RTSOrderDataPayloadBits, STATGROUP_RTS);
+
+static TAutoConsoleVariable<float> CVarRTSOrderLocationPrecision(
+    TEXT("RTS.Net.OrderLocationPrecision"), 1.0f,
+    TEXT("Precision of replicated order target locations, in world units. Must be the same on server and clients. "
+         "Clamped to at least 0.01. Locations too far away to be quantized with this precision are sent unquantized."),
+    ECVF_Default);
 
 
 FRTSOrderData::FRTSOrderData()
@@ -12,6 +27,7 @@ FRTSOrderData::FRTSOrderData()
     Location = FVector2D::ZeroVector;
     Target = nullptr;
     Index = -1;
+    ResolvedOrderType = nullptr;
 }
 
 FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType)
@@ -20,6 +36,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType)
     , Location(FVector2D::ZeroVector)
     , Target(nullptr)
     , Index(-1)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -29,6 +46,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, AActor* InTar
     , Location(FVector2D::ZeroVector)
     , Target(InTarget)
     , Index(-1)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -38,6 +56,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, FVector2D InL
     , Location(InLocation)
     , Target(nullptr)
     , Index(-1)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -47,6 +66,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, AActor* InTar
     , Location(InLocation)
     , Target(InTarget)
     , Index(-1)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -56,6 +76,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, int32 InIndex
     , Location(FVector2D::ZeroVector)
     , Target(nullptr)
     , Index(InIndex)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -65,6 +86,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, int32 InIndex
     , Location(InLocation)
     , Target(nullptr)
     , Index(InIndex)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -74,6 +96,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, int32 InIndex
     , Location(FVector2D::ZeroVector)
     , Target(InTarget)
     , Index(InIndex)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -84,6 +107,7 @@ FRTSOrderData::FRTSOrderData(TSoftClassPtr<URTSOrder> InOrderType, int32 InIndex
     , Location(InLocation)
     , Target(InTarget)
     , Index(InIndex)
+    , ResolvedOrderType(nullptr)
 {
 }
 
@@ -91,14 +115,10 @@ FString FRTSOrderData::ToString() const
 {
     FString s;
 
-    if (OrderType != nullptr)
+    if (!OrderType.IsNull())
     {
-        if (!OrderType.IsValid())
-        {
-            OrderType.LoadSynchronous();
-        }
-
-        s += OrderType->GetName();
+        // Don't load the order type just for logging it.
+        s += OrderType.GetAssetName();
     }
     else
     {
@@ -148,6 +168,167 @@ FString FRTSOrderData::ToString() const
     return s;
 }
 
+bool FRTSOrderData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    enum ERTSOrderDataFlags
+    {
+        HasOrderType = 1 << 0,
+        HasLocation = 1 << 1,
+        HasTarget = 1 << 2,
+        HasIndex = 1 << 3,
+        HasUnquantizedLocation = 1 << 4,
+        NumFlags = 5
+    };
+
+    // Quantized coordinates have to fit into an int32, even for precisions close to zero.
+    const float MinLocationPrecision = 0.01f;
+    const float MaxQuantizedCoordinate = (float)(1 << 30);
+    const float Precision = FMath::Max(CVarRTSOrderLocationPrecision.GetValueOnAnyThread(), MinLocationPrecision);
+
+    // Zigzag encode signed values, so small negative values are packed as small as positive ones.
+    auto SerializeSignedPacked = [&Ar](int32& Value) {
+        uint32 EncodedValue = (uint32(Value) << 1) ^ uint32(Value >> 31);
+        Ar.SerializeIntPacked(EncodedValue);
+        Value = int32(EncodedValue >> 1) ^ -int32(EncodedValue & 1);
+        return EncodedValue;
+    };
+
+    // Packed integers take one byte per 7 bits.
+    auto GetPackedBits = [](uint32 EncodedValue) {
+        int32 NumBytes = 1;
+        while (EncodedValue >= 0x80)
+        {
+            EncodedValue >>= 7;
+            ++NumBytes;
+        }
+        return NumBytes * 8;
+    };
+
+    uint8 Flags = 0;
+    UObject* OrderClass = nullptr;
+
+    if (Ar.IsSaving())
+    {
+        // Never load order types in the middle of replication. Orders are held back by URTSOrderComponent until their
+        // types have been loaded, so this only fails if an order has been set on the server without being issued.
+        if (!OrderType.IsNull())
+        {
+            FRTSOrderTypeRegistry& OrderTypeRegistry = FRTSOrderTypeRegistry::Get();
+            const FSoftObjectPath OrderTypePath = OrderType.ToSoftObjectPath();
+
+            if (ResolvedOrderType == nullptr || ResolvedOrderType->Path != OrderTypePath)
+            {
+                ResolvedOrderType =
+                    OrderTypeRegistry.IsLoaded(OrderTypePath) ? OrderTypeRegistry.Resolve(OrderTypePath) : nullptr;
+            }
+
+            if (ResolvedOrderType != nullptr)
+            {
+                OrderClass = ResolvedOrderType->Class;
+            }
+            else
+            {
+                UE_LOG(LogRTS, Error,
+                       TEXT("FRTSOrderData::NetSerialize: Order type %s is not loaded and won't be replicated."),
+                       *OrderTypePath.ToString());
+            }
+        }
+
+        Flags |= OrderClass != nullptr ? HasOrderType : 0;
+        Flags |= bUseLocation ? HasLocation : 0;
+        Flags |= Target != nullptr ? HasTarget : 0;
+        Flags |= Index != -1 ? HasIndex : 0;
+
+        // Fails for NaN as well.
+        const bool bCanQuantizeLocation = FMath::Abs(Location.X / Precision) < MaxQuantizedCoordinate &&
+                                          FMath::Abs(Location.Y / Precision) < MaxQuantizedCoordinate;
+        Flags |= bUseLocation && !bCanQuantizeLocation ? HasUnquantizedLocation : 0;
+    }
+
+    Ar.SerializeBits(&Flags, NumFlags);
+    int32 NumPayloadBits = NumFlags;
+
+    // Order type.
+    if (Flags & HasOrderType)
+    {
+        Map->SerializeObject(Ar, UClass::StaticClass(), OrderClass);
+
+        if (Ar.IsLoading())
+        {
+            OrderType = Cast<UClass>(OrderClass);
+            ResolvedOrderType = nullptr;
+        }
+    }
+    else if (Ar.IsLoading())
+    {
+        OrderType = nullptr;
+        ResolvedOrderType = nullptr;
+    }
+
+    // Location.
+    bUseLocation = (Flags & HasLocation) != 0;
+
+    if (bUseLocation && (Flags & HasUnquantizedLocation))
+    {
+        Ar << Location.X;
+        Ar << Location.Y;
+
+        NumPayloadBits += 2 * sizeof(float) * 8;
+    }
+    else if (bUseLocation)
+    {
+        int32 QuantizedX = FMath::RoundToInt(Location.X / Precision);
+        int32 QuantizedY = FMath::RoundToInt(Location.Y / Precision);
+
+        NumPayloadBits += GetPackedBits(SerializeSignedPacked(QuantizedX));
+        NumPayloadBits += GetPackedBits(SerializeSignedPacked(QuantizedY));
+
+        if (Ar.IsLoading())
+        {
+            Location = FVector2D(QuantizedX * Precision, QuantizedY * Precision);
+        }
+    }
+    else if (Ar.IsLoading())
+    {
+        Location = FVector2D::ZeroVector;
+    }
+
+    // Target.
+    if (Flags & HasTarget)
+    {
+        UObject* TargetObject = Target;
+        Map->SerializeObject(Ar, AActor::StaticClass(), TargetObject);
+
+        if (Ar.IsLoading())
+        {
+            Target = Cast<AActor>(TargetObject);
+        }
+    }
+    else if (Ar.IsLoading())
+    {
+        Target = nullptr;
+    }
+
+    // Index.
+    if (Flags & HasIndex)
+    {
+        NumPayloadBits += GetPackedBits(SerializeSignedPacked(Index));
+    }
+    else if (Ar.IsLoading())
+    {
+        Index = -1;
+    }
+
+    if (Ar.IsSaving())
+    {
+        INC_DWORD_STAT(STAT_RTSOrderDataSerialized);
+        INC_DWORD_STAT_BY(STAT_RTSOrderDataPayloadBits, NumPayloadBits);
+    }
+
+    bOutSuccess = true;
+    return true;
+}
+
 bool FRTSOrderData::operator==(const FRTSOrderData& Other) const
 {
     bool bEqual =
@@ -3,17 +3,38 @@
 #include "OrdersAbilities.h"
 
 #include "AbilitySystemComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/Pawn.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "HAL/IConsoleManager.h"
 #include "Templates/Tuple.h"
 
 #include "AbilitySystem/RTSAbilitySystemHelper.h"
+#include "AbilitySystem/RTSActorTagSnapshot.h"
 #include "AbilitySystem/RTSGlobalTags.h"
+#include "AbilitySystem/RTSRelationshipMatrix.h"
 #include "Orders/RTSAutoOrderComponent.h"
+#include "Orders/RTSMoveOrder.h"
 #include "Orders/RTSOrderComponent.h"
 #include "Orders/RTSOrderTargetData.h"
+#include "Orders/RTSOrderTypeRegistry.h"
 #include "Orders/RTSOrderWithBehavior.h"
+#include "Orders/RTSSpatialHashGrid.h"
+#include "Orders/RTSTargetAcquisition.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Issue Order To Group"), STAT_RTSIssueOrderToGroup, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Group Ordered Actors"), STAT_RTSGroupOrderedActors, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Group Rejected Actors"), STAT_RTSGroupRejectedActors, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Parallel Scored Targets"), STAT_RTSParallelScoredTargets, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Serial Scored Targets"), STAT_RTSSerialScoredTargets, STATGROUP_RTS);
+
+static TAutoConsoleVariable<int32> CVarRTSParallelTargetScoringThreshold(
+    TEXT("RTS.Orders.ParallelTargetScoringThreshold"), 64,
+    TEXT("Minimum number of potential targets of an order to score them in parallel. 0 disables parallel scoring."),
+    ECVF_Default);
 
 
 bool URTSOrderHelper::CanObeyOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor, int32 Index)
@@ -41,36 +62,69 @@ bool URTSOrderHelper::CanObeyOrder(TSoftClassPtr<URTSOrder> OrderType, const AAc
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    return CanObeyOrder(Order, OrderedActor, Index, OutErrorTags);
+}
+
+bool URTSOrderHelper::CanObeyOrder(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                   FRTSOrderErrorTags* OutErrorTags,
+                                   const FRTSCompiledOrderTagRequirements* TagRequirements)
+{
+    if (Order == nullptr || !IsValid(OrderedActor))
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    const URTSOrder* Order = OrderType->GetDefaultObject<URTSOrder>();
     const UAbilitySystemComponent* AbilitySystem = OrderedActor->FindComponentByClass<UAbilitySystemComponent>();
     if (AbilitySystem != nullptr)
     {
-        FRTSOrderTagRequirements TagRequirements;
-        Order->GetTagRequirements(OrderedActor, Index, TagRequirements);
-
-        FGameplayTagContainer OrderedActorTags;
-        AbilitySystem->GetOwnedGameplayTags(OrderedActorTags);
+        bool bCheckTagContainers = true;
 
-        if (OutErrorTags != nullptr)
+        // Check compiled requirements first. Tag containers are only needed for finding missing and blocking tags.
+        if (TagRequirements != nullptr)
         {
-            if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirementsWithResult(
-                    OrderedActorTags, TagRequirements.SourceRequiredTags, TagRequirements.SourceBlockedTags,
-                    OutErrorTags->MissingTags, OutErrorTags->BlockingTags))
+            const FRTSTagBitset& OrderedActorTagBits = FRTSActorTagSnapshot::Get().GetOwnedTagBits(OrderedActor);
+
+            if (TagRequirements->DoesSatisfySourceRequirements(OrderedActorTagBits))
+            {
+                bCheckTagContainers = false;
+            }
+            else if (OutErrorTags == nullptr)
             {
                 return false;
             }
         }
-        else
+
+        if (bCheckTagContainers)
         {
-            if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirements(
-                    OrderedActorTags, TagRequirements.SourceRequiredTags, TagRequirements.SourceBlockedTags))
+            const FRTSOrderTagRequirements* SourceTagRequirements = TagRequirements;
+            FRTSOrderTagRequirements OrderTagRequirements;
+            if (SourceTagRequirements == nullptr)
             {
-                return false;
+                Order->GetTagRequirements(OrderedActor, Index, OrderTagRequirements);
+                SourceTagRequirements = &OrderTagRequirements;
+            }
+
+            const FGameplayTagContainer& OrderedActorTags = FRTSActorTagSnapshot::Get().GetOwnedTags(OrderedActor);
+
+            if (OutErrorTags != nullptr)
+            {
+                if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirementsWithResult(
+                        OrderedActorTags, SourceTagRequirements->SourceRequiredTags,
+                        SourceTagRequirements->SourceBlockedTags, OutErrorTags->MissingTags,
+                        OutErrorTags->BlockingTags))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirements(OrderedActorTags,
+                                                                         SourceTagRequirements->SourceRequiredTags,
+                                                                         SourceTagRequirements->SourceBlockedTags))
+                {
+                    return false;
+                }
             }
         }
     }
@@ -105,13 +159,20 @@ bool URTSOrderHelper::IsValidTarget(TSoftClassPtr<URTSOrder> OrderType, const AA
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    return IsValidTarget(Order, OrderedActor, TargetData, Index, OutErrorTags);
+}
+
+bool URTSOrderHelper::IsValidTarget(const URTSOrder* Order, const AActor* OrderedActor,
+                                    const FRTSOrderTargetData& TargetData, int32 Index,
+                                    FRTSOrderErrorTags* OutErrorTags,
+                                    const FRTSCompiledOrderTagRequirements* TagRequirements)
+{
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    const URTSOrder* Order = OrderType->GetDefaultObject<URTSOrder>();
-
     ERTSTargetType TargetType = Order->GetTargetType(OrderedActor, Index);
     if (TargetType == ERTSTargetType::ACTOR)
     {
@@ -124,14 +185,20 @@ bool URTSOrderHelper::IsValidTarget(TSoftClassPtr<URTSOrder> OrderType, const AA
             return false;
         }
 
-        FRTSOrderTagRequirements TagRequirements;
-        Order->GetTagRequirements(OrderedActor, Index, TagRequirements);
+        // The target tags are already stored in a tag container, so building a bitset wouldn't pay off here.
+        const FRTSOrderTagRequirements* TargetTagRequirements = TagRequirements;
+        FRTSOrderTagRequirements OrderTagRequirements;
+        if (TargetTagRequirements == nullptr)
+        {
+            Order->GetTagRequirements(OrderedActor, Index, OrderTagRequirements);
+            TargetTagRequirements = &OrderTagRequirements;
+        }
 
         if (OutErrorTags != nullptr)
         {
             if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirementsWithResult(
-                    TargetData.TargetTags, TagRequirements.TargetRequiredTags, TagRequirements.TargetBlockedTags,
-                    OutErrorTags->MissingTags, OutErrorTags->BlockingTags))
+                    TargetData.TargetTags, TargetTagRequirements->TargetRequiredTags,
+                    TargetTagRequirements->TargetBlockedTags, OutErrorTags->MissingTags, OutErrorTags->BlockingTags))
             {
                 return false;
             }
@@ -140,7 +207,8 @@ bool URTSOrderHelper::IsValidTarget(TSoftClassPtr<URTSOrder> OrderType, const AA
         else
         {
             if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirements(
-                    TargetData.TargetTags, TagRequirements.TargetRequiredTags, TagRequirements.TargetBlockedTags))
+                    TargetData.TargetTags, TargetTagRequirements->TargetRequiredTags,
+                    TargetTagRequirements->TargetBlockedTags))
             {
                 return false;
             }
@@ -160,13 +228,13 @@ void URTSOrderHelper::CreateIndividualTargetLocations(TSoftClassPtr<URTSOrder> O
         return;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return;
     }
 
-    OrderType->GetDefaultObject<URTSOrder>()->CreateIndividualTargetLocations(OrderedActors, TargetData,
-                                                                              OutTargetLocations);
+    Order->CreateIndividualTargetLocations(OrderedActors, TargetData, OutTargetLocations);
 
     if (OrderedActors.Num() != OutTargetLocations.Num())
     {
@@ -195,6 +263,202 @@ void URTSOrderHelper::IssueOrder(AActor* OrderedActor, const FRTSOrderData& Orde
     OrderComponent->IssueOrder(Order);
 }
 
+void URTSOrderHelper::IssueOrderToGroup(const TArray<AActor*>& OrderedActors, const FRTSOrderData& Order)
+{
+    SCOPE_CYCLE_COUNTER(STAT_RTSIssueOrderToGroup);
+
+    if (Order.OrderType == nullptr)
+    {
+        UE_LOG(LogRTS, Error, TEXT("URTSOrderHelper::IssueOrderToGroup: The specified order is invalid."));
+        return;
+    }
+
+    // Resolve the order type once for the whole group.
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject == nullptr)
+    {
+        UE_LOG(LogRTS, Error, TEXT("URTSOrderHelper::IssueOrderToGroup: The order type %s could not be loaded."),
+               *Order.OrderType.ToString());
+        return;
+    }
+
+    TSubclassOf<URTSOrder> OrderType = OrderObject->GetClass();
+
+    // The first valid actor is the main selected unit.
+    const AActor* MainActor = nullptr;
+    for (AActor* OrderedActor : OrderedActors)
+    {
+        if (IsValid(OrderedActor))
+        {
+            MainActor = OrderedActor;
+            break;
+        }
+    }
+
+    if (MainActor == nullptr)
+    {
+        return;
+    }
+
+    ERTSOrderGroupExecutionType GroupExecutionType = OrderObject->GetGroupExecutionType(MainActor, Order.Index);
+
+    // The tags of the target are the same for all ordered actors. Only the relationship tags differ per actor.
+    const FGameplayTagContainer& TargetOwnedTags = FRTSActorTagSnapshot::Get().GetOwnedTags(Order.Target);
+
+    // Validate all actors in a single pass.
+    TArray<AActor*> ValidActors;
+    TArray<URTSOrderComponent*> ValidOrderComponents;
+    TArray<FRTSOrderTargetData> ValidTargetData;
+
+    ValidActors.Reserve(OrderedActors.Num());
+    ValidOrderComponents.Reserve(OrderedActors.Num());
+    ValidTargetData.Reserve(OrderedActors.Num());
+
+    int32 RejectedActors = 0;
+
+    for (AActor* OrderedActor : OrderedActors)
+    {
+        if (!IsValid(OrderedActor))
+        {
+            continue;
+        }
+
+        // Only the main selected unit needs to be considered if the order is just issued to that one.
+        if (GroupExecutionType == ERTSOrderGroupExecutionType::SELECTED_UNIT && OrderedActor != MainActor)
+        {
+            continue;
+        }
+
+        URTSOrderComponent* OrderComponent = OrderedActor->FindComponentByClass<URTSOrderComponent>();
+        if (OrderComponent == nullptr)
+        {
+            ++RejectedActors;
+            continue;
+        }
+
+        FRTSOrderTargetData TargetData;
+        TargetData.Actor = Order.Target;
+        TargetData.Location = Order.Location;
+
+        if (Order.Target != nullptr)
+        {
+            TargetData.TargetTags = TargetOwnedTags;
+            TargetData.TargetTags.AppendTags(
+                FRTSRelationshipMatrix::Get().GetRelationshipTags(OrderedActor, Order.Target));
+        }
+
+        // Use the tag requirements compiled and cached by the order component, instead of building them again.
+        const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements =
+            OrderComponent->GetTagRequirements(OrderObject, Order.Index);
+
+        if (!CanObeyOrder(OrderObject, OrderedActor, Order.Index, nullptr, &TagRequirements.Get()) ||
+            !IsValidTarget(OrderObject, OrderedActor, TargetData, Order.Index, nullptr, &TagRequirements.Get()))
+        {
+            ++RejectedActors;
+            continue;
+        }
+
+        ValidActors.Add(OrderedActor);
+        ValidOrderComponents.Add(OrderComponent);
+        ValidTargetData.Add(TargetData);
+    }
+
+    INC_DWORD_STAT_BY(STAT_RTSGroupRejectedActors, RejectedActors);
+
+    if (RejectedActors > 0)
+    {
+        UE_LOG(LogRTS, Log, TEXT("URTSOrderHelper::IssueOrderToGroup: %d of %d actors cannot obey the order %s."),
+               RejectedActors, OrderedActors.Num(), *OrderType->GetName());
+    }
+
+    if (ValidActors.Num() == 0)
+    {
+        return;
+    }
+
+    // Issue the order to a single unit, if requested.
+    if (GroupExecutionType == ERTSOrderGroupExecutionType::SELECTED_UNIT ||
+        GroupExecutionType == ERTSOrderGroupExecutionType::MOST_SUITABLE_UNIT)
+    {
+        int32 BestIndex = 0;
+
+        if (GroupExecutionType == ERTSOrderGroupExecutionType::MOST_SUITABLE_UNIT)
+        {
+            float BestScore = OrderObject->GetTargetScore(ValidActors[0], ValidTargetData[0], Order.Index);
+
+            for (int32 Index = 1; Index < ValidActors.Num(); ++Index)
+            {
+                float Score = OrderObject->GetTargetScore(ValidActors[Index], ValidTargetData[Index], Order.Index);
+                if (BestScore < Score)
+                {
+                    BestScore = Score;
+                    BestIndex = Index;
+                }
+            }
+        }
+
+        INC_DWORD_STAT(STAT_RTSGroupOrderedActors);
+        ValidOrderComponents[BestIndex]->IssueCheckedOrder(Order);
+        return;
+    }
+
+    // Issue the order to the whole group, spreading the target locations if the order wants to.
+    TArray<FVector2D> TargetLocations;
+    if (ValidActors.Num() > 1 && OrderObject->IsCreatingIndividualTargetLocations(MainActor, Order.Index))
+    {
+        OrderObject->CreateIndividualTargetLocations(ValidActors, ValidTargetData[0], TargetLocations);
+
+        if (TargetLocations.Num() != ValidActors.Num())
+        {
+            UE_LOG(LogRTS, Error,
+                   TEXT("The implementation of 'CreateIndividualTargetLocations' of class '%s' does return an amount "
+                        "of locations that is different to the amount of actors."),
+                   *OrderType->GetName());
+            TargetLocations.Reset();
+        }
+
+        // Only the target location of the whole group has been checked so far. Actors whose individual target location
+        // isn't valid use the one of the group instead.
+        for (int32 Index = 0; Index < TargetLocations.Num(); ++Index)
+        {
+            FRTSOrderTargetData IndividualTargetData = ValidTargetData[Index];
+            IndividualTargetData.Location = TargetLocations[Index];
+
+            const TSharedRef<const FRTSCompiledOrderTagRequirements> TagRequirements =
+                ValidOrderComponents[Index]->GetTagRequirements(OrderObject, Order.Index);
+
+            if (!IsValidTarget(OrderObject, ValidActors[Index], IndividualTargetData, Order.Index, nullptr,
+                               &TagRequirements.Get()))
+            {
+                TargetLocations[Index] = Order.Location;
+            }
+        }
+    }
+
+    // Let large groups moving into formation share a flow field.
+    const URTSMoveOrder* MoveOrder = Cast<URTSMoveOrder>(OrderObject);
+    if (MoveOrder != nullptr && TargetLocations.Num() > 0)
+    {
+        MoveOrder->RequestFlowField(ValidActors, ValidTargetData[0], TargetLocations);
+    }
+
+    INC_DWORD_STAT_BY(STAT_RTSGroupOrderedActors, ValidActors.Num());
+
+    for (int32 Index = 0; Index < ValidActors.Num(); ++Index)
+    {
+        if (TargetLocations.Num() > 0)
+        {
+            FRTSOrderData IndividualOrder = Order;
+            IndividualOrder.Location = TargetLocations[Index];
+            ValidOrderComponents[Index]->IssueCheckedOrder(IndividualOrder);
+        }
+        else
+        {
+            ValidOrderComponents[Index]->IssueCheckedOrder(Order);
+        }
+    }
+}
+
 void URTSOrderHelper::ClearOrderQueue(AActor* OrderedActor)
 {
     if (!IsValid(OrderedActor))
@@ -258,12 +522,13 @@ ERTSTargetType URTSOrderHelper::GetTargetType(TSoftClassPtr<URTSOrder> OrderType
         return ERTSTargetType::NONE;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return ERTSTargetType::NONE;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetTargetType(OrderedActor, Index);
+    return Order->GetTargetType(OrderedActor, Index);
 }
 
 bool URTSOrderHelper::IsCreatingIndividualTargetLocations(TSoftClassPtr<URTSOrder> OrderType,
@@ -274,12 +539,13 @@ bool URTSOrderHelper::IsCreatingIndividualTargetLocations(TSoftClassPtr<URTSOrde
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->IsCreatingIndividualTargetLocations(OrderedActor, Index);
+    return Order->IsCreatingIndividualTargetLocations(OrderedActor, Index);
 }
 
 UBehaviorTree* URTSOrderHelper::GetBehaviorTree(TSoftClassPtr<URTSOrderWithBehavior> OrderType)
@@ -289,12 +555,13 @@ UBehaviorTree* URTSOrderHelper::GetBehaviorTree(TSoftClassPtr<URTSOrderWithBehav
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const FRTSResolvedOrderType* ResolvedOrderType = FRTSOrderTypeRegistry::Get().Resolve(OrderType.ToSoftObjectPath());
+    if (ResolvedOrderType == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    return OrderType->GetDefaultObject<URTSOrderWithBehavior>()->GetBehaviorTree();
+    return CastChecked<URTSOrderWithBehavior>(ResolvedOrderType->DefaultObject)->GetBehaviorTree();
 }
 
 bool URTSOrderHelper::ShouldRestartBehaviourTree(TSoftClassPtr<URTSOrderWithBehavior> OrderType)
@@ -304,12 +571,13 @@ bool URTSOrderHelper::ShouldRestartBehaviourTree(TSoftClassPtr<URTSOrderWithBeha
         return true;
     }
 
-    if (!OrderType.IsValid())
+    const FRTSResolvedOrderType* ResolvedOrderType = FRTSOrderTypeRegistry::Get().Resolve(OrderType.ToSoftObjectPath());
+    if (ResolvedOrderType == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return true;
     }
 
-    return OrderType->GetDefaultObject<URTSOrderWithBehavior>()->ShouldRestartBehaviourTree();
+    return CastChecked<URTSOrderWithBehavior>(ResolvedOrderType->DefaultObject)->ShouldRestartBehaviourTree();
 }
 
 FRTSOrderTargetData URTSOrderHelper::CreateOrderTargetData(const AActor* OrderedActor, AActor* TargetActor,
@@ -340,12 +608,13 @@ UTexture2D* URTSOrderHelper::GetNormalIcon(TSoftClassPtr<URTSOrder> OrderType, c
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetNormalIcon(OrderedActor, Index);
+    return Order->GetNormalIcon(OrderedActor, Index);
 }
 
 UTexture2D* URTSOrderHelper::GetHoveredIcon(TSoftClassPtr<URTSOrder> OrderType,
@@ -356,12 +625,13 @@ UTexture2D* URTSOrderHelper::GetHoveredIcon(TSoftClassPtr<URTSOrder> OrderType,
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetHoveredIcon(OrderedActor, Index);
+    return Order->GetHoveredIcon(OrderedActor, Index);
 }
 
 UTexture2D* URTSOrderHelper::GetPressedIcon(TSoftClassPtr<URTSOrder> OrderType,
@@ -372,12 +642,13 @@ UTexture2D* URTSOrderHelper::GetPressedIcon(TSoftClassPtr<URTSOrder> OrderType,
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetPressedIcon(OrderedActor, Index);
+    return Order->GetPressedIcon(OrderedActor, Index);
 }
 
 UTexture2D* URTSOrderHelper::GetDisabledIcon(TSoftClassPtr<URTSOrder> OrderType,
@@ -388,12 +659,13 @@ UTexture2D* URTSOrderHelper::GetDisabledIcon(TSoftClassPtr<URTSOrder> OrderType,
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetDisabledIcon(OrderedActor, Index);
+    return Order->GetDisabledIcon(OrderedActor, Index);
 }
 
 FText URTSOrderHelper::GetName(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor /*= nullptr*/,
@@ -404,12 +676,13 @@ FText URTSOrderHelper::GetName(TSoftClassPtr<URTSOrder> OrderType, const AActor*
         return FText::FromString(TEXT("URTSOrderHelper::GetName: Error: Parameter 'OrderType' was 'nullptr'."));
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return FText::FromString(TEXT("URTSOrderHelper::GetName: Error: Parameter 'OrderType' could not be loaded."));
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetName(OrderedActor, Index);
+    return Order->GetName(OrderedActor, Index);
 }
 
 FText URTSOrderHelper::GetDescription(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor /*= nullptr*/,
@@ -420,12 +693,14 @@ FText URTSOrderHelper::GetDescription(TSoftClassPtr<URTSOrder> OrderType, const
         return FText::FromString(TEXT("URTSOrderHelper::GetDescription: Error: Parameter 'OrderType' was 'nullptr'."));
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return FText::FromString(
+            TEXT("URTSOrderHelper::GetDescription: Error: Parameter 'OrderType' could not be loaded."));
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetDescription(OrderedActor, Index);
+    return Order->GetDescription(OrderedActor, Index);
 }
 
 int32 URTSOrderHelper::GetOrderButtonIndex(TSoftClassPtr<URTSOrder> OrderType)
@@ -435,12 +710,13 @@ int32 URTSOrderHelper::GetOrderButtonIndex(TSoftClassPtr<URTSOrder> OrderType)
         return -1;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return -1;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetOrderButtonIndex();
+    return Order->GetOrderButtonIndex();
 }
 
 bool URTSOrderHelper::HasFixedOrderButtonIndex(TSoftClassPtr<URTSOrder> OrderType)
@@ -450,12 +726,13 @@ bool URTSOrderHelper::HasFixedOrderButtonIndex(TSoftClassPtr<URTSOrder> OrderTyp
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->HasFixedOrderButtonIndex();
+    return Order->HasFixedOrderButtonIndex();
 }
 
 FRTSOrderPreviewData URTSOrderHelper::GetOrderPreviewData(TSoftClassPtr<URTSOrder> OrderType,
@@ -467,12 +744,13 @@ FRTSOrderPreviewData URTSOrderHelper::GetOrderPreviewData(TSoftClassPtr<URTSOrde
         return FRTSOrderPreviewData();
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return FRTSOrderPreviewData();
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetOrderPreviewData(OrderedActor, Index);
+    return Order->GetOrderPreviewData(OrderedActor, Index);
 }
 
 void URTSOrderHelper::GetOrderTagRequirements(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -485,12 +763,13 @@ void URTSOrderHelper::GetOrderTagRequirements(TSoftClassPtr<URTSOrder> OrderType
         return;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetTagRequirements(OrderedActor, Index, OutTagRequirements);
+    return Order->GetTagRequirements(OrderedActor, Index, OutTagRequirements);
 }
 
 void URTSOrderHelper::GetOrderSuccessTagRequirements(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -503,12 +782,13 @@ void URTSOrderHelper::GetOrderSuccessTagRequirements(TSoftClassPtr<URTSOrder> Or
         return;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetSuccessTagRequirements(OrderedActor, Index, OutTagRequirements);
+    return Order->GetSuccessTagRequirements(OrderedActor, Index, OutTagRequirements);
 }
 
 float URTSOrderHelper::GetOrderRequiredRange(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -520,12 +800,13 @@ float URTSOrderHelper::GetOrderRequiredRange(TSoftClassPtr<URTSOrder> OrderType,
         return 0.0f;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return 0.0f;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetRequiredRange(OrderedActor, Index);
+    return Order->GetRequiredRange(OrderedActor, Index);
 }
 
 bool URTSOrderHelper::GetAcquisitionRadiusOverride(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -538,13 +819,13 @@ bool URTSOrderHelper::GetAcquisitionRadiusOverride(TSoftClassPtr<URTSOrder> Orde
         return 0.0f;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetAcquisitionRadiusOverride(OrderedActor, Index,
-                                                                                  OutAcquisitionRadius);
+    return Order->GetAcquisitionRadiusOverride(OrderedActor, Index, OutAcquisitionRadius);
 }
 
 ERTSOrderProcessPolicy URTSOrderHelper::GetOrderProcessPolicy(TSoftClassPtr<URTSOrder> OrderType,
@@ -561,12 +842,13 @@ ERTSOrderProcessPolicy URTSOrderHelper::GetOrderProcessPolicy(TSoftClassPtr<URTS
         return ERTSOrderProcessPolicy::CAN_BE_CANCELED;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return ERTSOrderProcessPolicy::CAN_BE_CANCELED;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetOrderProcessPolicy(OrderedActor, Index);
+    return Order->GetOrderProcessPolicy(OrderedActor, Index);
 }
 
 TSoftClassPtr<URTSOrder> URTSOrderHelper::GetFallbackOrder(TSoftClassPtr<URTSOrder> OrderType)
@@ -576,12 +858,13 @@ TSoftClassPtr<URTSOrder> URTSOrderHelper::GetFallbackOrder(TSoftClassPtr<URTSOrd
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetFallbackOrder();
+    return Order->GetFallbackOrder();
 }
 
 float URTSOrderHelper::GetOrderTargetScore(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -593,12 +876,13 @@ float URTSOrderHelper::GetOrderTargetScore(TSoftClassPtr<URTSOrder> OrderType, c
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return 0.0f;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetTargetScore(OrderedActor, TargetData, Index);
+    return Order->GetTargetScore(OrderedActor, TargetData, Index);
 }
 
 bool URTSOrderHelper::IsHumanPlayerAutoOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -610,12 +894,13 @@ bool URTSOrderHelper::IsHumanPlayerAutoOrder(TSoftClassPtr<URTSOrder> OrderType,
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->IsHumanPlayerAutoOrder(OrderedActor, Index);
+    return Order->IsHumanPlayerAutoOrder(OrderedActor, Index);
 }
 
 bool URTSOrderHelper::IsAIPlayerAutoOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -627,12 +912,13 @@ bool URTSOrderHelper::IsAIPlayerAutoOrder(TSoftClassPtr<URTSOrder> OrderType, co
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->IsAIPlayerAutoOrder(OrderedActor, Index);
+    return Order->IsAIPlayerAutoOrder(OrderedActor, Index);
 }
 
 bool URTSOrderHelper::GetHumanPlayerAutoOrderInitialState(TSoftClassPtr<URTSOrder> OrderType,
@@ -645,12 +931,13 @@ bool URTSOrderHelper::GetHumanPlayerAutoOrderInitialState(TSoftClassPtr<URTSOrde
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetHumanPlayerAutoOrderInitialState(OrderedActor, Index);
+    return Order->GetHumanPlayerAutoOrderInitialState(OrderedActor, Index);
 }
 
 void URTSOrderHelper::SetHumanPlayerAutoOrderState(const AActor* OrderedActor, const FRTSOrderTypeWithIndex& Order,
@@ -677,12 +964,13 @@ void URTSOrderHelper::SetHumanPlayerAutoOrderState(const AActor* OrderedActor, c
 
 bool URTSOrderHelper::AreAutoOrdersAllowedDuringOrder(TSoftClassPtr<URTSOrder> OrderType)
 {
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->AreAutoOrdersAllowedDuringOrder();
+    return Order->AreAutoOrdersAllowedDuringOrder();
 }
 
 bool URTSOrderHelper::CanOrderBeConsideredAsSucceeded(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -693,12 +981,12 @@ bool URTSOrderHelper::CanOrderBeConsideredAsSucceeded(TSoftClassPtr<URTSOrder> O
         return false;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return false;
     }
 
-    const URTSOrder* Order = OrderType->GetDefaultObject<URTSOrder>();
     const UAbilitySystemComponent* AbilitySystem = OrderedActor->FindComponentByClass<UAbilitySystemComponent>();
 
     check(AbilitySystem != nullptr);
@@ -706,8 +994,7 @@ bool URTSOrderHelper::CanOrderBeConsideredAsSucceeded(TSoftClassPtr<URTSOrder> O
     FRTSOrderTagRequirements TagRequirements;
     Order->GetSuccessTagRequirements(OrderedActor, Index, TagRequirements);
 
-    FGameplayTagContainer OrderedActorTags;
-    AbilitySystem->GetOwnedGameplayTags(OrderedActorTags);
+    const FGameplayTagContainer& OrderedActorTags = FRTSActorTagSnapshot::Get().GetOwnedTags(OrderedActor);
 
     if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirements(OrderedActorTags, TagRequirements.SourceRequiredTags,
                                                              TagRequirements.SourceBlockedTags))
@@ -733,12 +1020,13 @@ ERTSOrderGroupExecutionType URTSOrderHelper::GetOrderGroupExecutionType(TSoftCla
         return ERTSOrderGroupExecutionType::ALL;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return ERTSOrderGroupExecutionType::ALL;
     }
 
-    return OrderType->GetDefaultObject<URTSOrder>()->GetGroupExecutionType(OrderedActor, Index);
+    return Order->GetGroupExecutionType(OrderedActor, Index);
 }
 
 FRTSOrderErrorTags URTSOrderHelper::CheckOrder(AActor* OrderedActor, const FRTSOrderData& Order)
@@ -747,13 +1035,8 @@ FRTSOrderErrorTags URTSOrderHelper::CheckOrder(AActor* OrderedActor, const FRTSO
 
     FRTSOrderErrorTags OrderErrorTags;
 
-    if (!Order.OrderType.IsValid())
-    {
-        Order.OrderType.LoadSynchronous();
-    }
-
-    TSubclassOf<URTSOrder> OrderType = Order.OrderType.Get();
-    if (OrderType == nullptr)
+    const URTSOrder* OrderObject = FRTSOrderTypeRegistry::Get().GetDefaultObject(Order);
+    if (OrderObject == nullptr)
     {
         UE_LOG(LogRTS, Error,
                TEXT("URTSOrderComponent::CheckOrder: The specified order for the actor '%s' is invalid."),
@@ -761,13 +1044,13 @@ FRTSOrderErrorTags URTSOrderHelper::CheckOrder(AActor* OrderedActor, const FRTSO
         return OrderErrorTags;
     }
 
-    if (!URTSOrderHelper::CanObeyOrder(OrderType.Get(), OrderedActor, Order.Index, &OrderErrorTags))
+    if (!URTSOrderHelper::CanObeyOrder(OrderObject, OrderedActor, Order.Index, &OrderErrorTags))
     {
         return OrderErrorTags;
     }
 
     FRTSOrderTargetData TargetData = URTSOrderHelper::CreateOrderTargetData(OrderedActor, Order.Target, Order.Location);
-    if (!URTSOrderHelper::IsValidTarget(OrderType.Get(), OrderedActor, TargetData, Order.Index, &OrderErrorTags))
+    if (!URTSOrderHelper::IsValidTarget(OrderObject, OrderedActor, TargetData, Order.Index, &OrderErrorTags))
     {
         return OrderErrorTags;
     }
@@ -782,25 +1065,14 @@ bool URTSOrderHelper::IsEnemyInAcquisitionRadius(const AActor* OrderedActor, flo
         return false;
     }
 
-    TArray<AActor*> ActorsInRange;
-    FindActors(OrderedActor->GetWorld(), AcquisitionRadius, OrderedActor->GetActorLocation(), ActorsInRange);
-
-    for (AActor* Actor : ActorsInRange)
+    // The grid knows the teams of the actors in each cell, so most cells don't need to be looked at actor by actor.
+    const FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(OrderedActor->GetWorld());
+    if (Grid == nullptr)
     {
-        if (!IsValid(Actor))
-        {
-            continue;
-        }
-
-        // Check the target tags.
-        if (URTSAbilitySystemHelper::GetRelationshipTags(OrderedActor, Actor)
-                .HasTag(URTSGlobalTags::Relationship_Hostile()))
-        {
-            return true;
-        }
+        return false;
     }
 
-    return false;
+    return Grid->IsHostileInRadius(OrderedActor, OrderedActor->GetActorLocation(), AcquisitionRadius);
 }
 
 AActor* URTSOrderHelper::FindTargetForOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor, int32 Index,
@@ -830,13 +1102,12 @@ AActor* URTSOrderHelper::FindTargetForOrderInChaseDistance(TSoftClassPtr<URTSOrd
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    const URTSOrder* Order = OrderType->GetDefaultObject<URTSOrder>();
-
     // Only target types with a real target location are relevant.
     ERTSTargetType TargetType = Order->GetTargetType(OrderedActor, Index);
     if (TargetType == ERTSTargetType::NONE || TargetType == ERTSTargetType::PASSIVE)
@@ -857,6 +1128,39 @@ AActor* URTSOrderHelper::FindTargetForOrderInChaseDistance(TSoftClassPtr<URTSOrd
     return FindBestScoredTargetForOrder(OrderType, OrderedActor, ActorsInRange, Index, OutScore);
 }
 
+bool URTSOrderHelper::RevalidateTargetForOrder(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                               AActor* Target, float AcquisitionRadius,
+                                               const FRTSCompiledOrderTagRequirements& TagRequirements,
+                                               float& OutScore)
+{
+    if (Order == nullptr || !IsValid(OrderedActor) || !IsValid(Target))
+    {
+        return false;
+    }
+
+    if (FVector::DistSquared2D(OrderedActor->GetActorLocation(), Target->GetActorLocation()) >
+        FMath::Square(AcquisitionRadius))
+    {
+        return false;
+    }
+
+    // Check the target the same way as all target searches in this frame.
+    TArray<AActor*> Targets;
+    Targets.Add(Target);
+
+    TArray<FRTSScoredTarget> ScoredTargets;
+    FindBestScoredTargetsForOrder(Order, OrderedActor, Index, Targets, TagRequirements, 1, ScoredTargets);
+
+    // Targets that wouldn't be found by a new search aren't kept either.
+    if (ScoredTargets.Num() == 0)
+    {
+        return false;
+    }
+
+    OutScore = ScoredTargets[0].Score;
+    return true;
+}
+
 void URTSOrderHelper::FindActors(UObject* WorldContextObject, float AcquisitionRadius,
                                  const FVector& OrderedActorLocation, TArray<AActor*>& OutActorsInRange)
 {
@@ -869,40 +1173,17 @@ void URTSOrderHelper::FindActorsInChaseDistance(UObject* WorldContextObject, flo
                                                 const FVector& OrderedActorHomeLocation,
                                                 TArray<AActor*>& OutActorsInRange)
 {
-    TArray<AActor*> ActorsInRange;
-    TArray<AActor*> ActorsToIgnore;
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
 
-    // NOTE(np): In A Year Of Rain, we're storing detection channels for units in the game instance.
-    // Find all targets in acquisition radius.
-    /*URTSGameInstance* GameInstance = URTSUtilities::GetRTSGameInstance(WorldContextObject);
-    UKismetSystemLibrary::CapsuleOverlapActors(WorldContextObject, OrderedActorLocation, AcquisitionRadius, 10000.0f,
-                                               GameInstance->GetPawnDetectionChannels(), APawn::StaticClass(),
-                                               ActorsToIgnore, ActorsInRange);*/
-
-    if (ActorsInRange.Num() == 0)
+    // Actors are found by location in the spatial hash grid of the world, without going through the physics scene.
+    const FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(World);
+    if (Grid == nullptr)
     {
         return;
     }
 
-    // Filter the array for valid targets.
-    for (AActor* Actor : ActorsInRange)
-    {
-        if (!IsValid(Actor))
-        {
-            continue;
-        }
-
-        FVector ActorLocation = Actor->GetActorLocation();
-
-        // If the target is too far away from our home location it is invalid.
-        float DistanceToHomeLocation = FVector::Dist2D(ActorLocation, OrderedActorHomeLocation);
-        if (DistanceToHomeLocation > ChaseDistance)
-        {
-            continue;
-        }
-
-        OutActorsInRange.Add(Actor);
-    }
+    Grid->FindActorsInChaseDistance(OrderedActorLocation, AcquisitionRadius, OrderedActorHomeLocation, ChaseDistance,
+                                    OutActorsInRange);
 }
 
 AActor* URTSOrderHelper::FindBestScoredTargetForOrder(TSoftClassPtr<URTSOrder> OrderType, const AActor* OrderedActor,
@@ -918,57 +1199,141 @@ AActor* URTSOrderHelper::FindBestScoredTargetForOrder(TSoftClassPtr<URTSOrder> O
         return nullptr;
     }
 
-    if (!OrderType.IsValid())
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(OrderType);
+    if (Order == nullptr)
     {
-        OrderType.LoadSynchronous();
+        return nullptr;
     }
 
-    const URTSOrder* Order = OrderType->GetDefaultObject<URTSOrder>();
+    // Use the cached tag requirements of the unit, if possible.
+    const URTSOrderComponent* OrderComponent = OrderedActor->FindComponentByClass<URTSOrderComponent>();
+    TSharedPtr<const FRTSCompiledOrderTagRequirements> TagRequirements;
+
+    if (OrderComponent != nullptr)
+    {
+        TagRequirements = OrderComponent->GetTagRequirements(Order, Index);
+    }
+    else
+    {
+        FRTSOrderTagRequirements OrderTagRequirements;
+        Order->GetTagRequirements(OrderedActor, Index, OrderTagRequirements);
+        TagRequirements = MakeShared<FRTSCompiledOrderTagRequirements>(OrderTagRequirements);
+    }
 
     // Filter the array for valid targets.
-    FRTSOrderTagRequirements TagRequirements;
-    Order->GetTagRequirements(OrderedActor, Index, TagRequirements);
-    TArray<TTuple<AActor*, float>> ActorsWithScore;
+    TArray<FRTSScoredTarget> ScoredTargets;
+    FindBestScoredTargetsForOrder(Order, OrderedActor, Index, Targets, *TagRequirements, 1, ScoredTargets);
+
+    if (ScoredTargets.Num() == 0)
+    {
+        OutScore = 0.0f;
+        return nullptr;
+    }
+
+    OutScore = ScoredTargets[0].Score;
+    return ScoredTargets[0].Actor;
+}
+
+void URTSOrderHelper::FindBestScoredTargetsForOrder(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                                    const TArray<AActor*>& Targets,
+                                                    const FRTSCompiledOrderTagRequirements& TagRequirements,
+                                                    int32 MaxTargets, TArray<FRTSScoredTarget>& OutTargets)
+{
+    OutTargets.Reset();
+
+    if (Order == nullptr || !IsValid(OrderedActor) || MaxTargets <= 0)
+    {
+        return;
+    }
+
+    // Snapshot the data of all targets that satisfy the tag requirements. Tag containers are only built for targets
+    // that pass.
+    FRTSActorTagSnapshot& TagSnapshot = FRTSActorTagSnapshot::Get();
+    FRTSRelationshipMatrix& RelationshipMatrix = FRTSRelationshipMatrix::Get();
+    TArray<FRTSOrderTargetData> Candidates;
+    FRTSTagBitset TargetTagBits;
     for (AActor* Actor : Targets)
     {
-        if (!IsValid(Actor))
+        int32 TargetSlot = TagSnapshot.FindOrAddSlot(Actor);
+        if (TargetSlot == INDEX_NONE)
         {
             continue;
         }
 
-        // Check the target tags.
-        FGameplayTagContainer TargetTags;
-        URTSAbilitySystemHelper::GetTags(Actor, TargetTags);
-        TargetTags.AppendTags(URTSAbilitySystemHelper::GetRelationshipTags(OrderedActor, Actor));
-        if (!URTSAbilitySystemHelper::DoesSatisfyTagRequirements(TargetTags, TagRequirements.TargetRequiredTags,
-                                                                 TagRequirements.TargetBlockedTags))
-        {
-            continue;
-        }
+        // Check the target tags. The owned tags of each target are only copied once per frame, for all searches.
+        ERTSRelationshipFlags Relationship = RelationshipMatrix.GetRelationship(OrderedActor, Actor);
+
+        TargetTagBits.Reset();
+        TargetTagBits.Append(TagSnapshot.GetOwnedTagBits(TargetSlot));
+        TargetTagBits.Append(RelationshipMatrix.GetRelationshipTagBits(Relationship));
 
-        // Apply the order specific valid target check.
-        FRTSOrderTargetData OrderTargetData(Actor, FVector2D(Actor->GetActorLocation()), TargetTags);
-        if (!Order->IsValidTarget(OrderedActor, OrderTargetData, Index))
+        if (!TagRequirements.DoesSatisfyTargetRequirements(TargetTagBits))
         {
             continue;
         }
 
-        // This actor is valid. Store it and its score in the array.
-        ActorsWithScore.Emplace(Actor, Order->GetTargetScore(OrderedActor, OrderTargetData, Index));
+        FGameplayTagContainer TargetTags = TagSnapshot.GetOwnedTags(TargetSlot);
+        TargetTags.AppendTags(RelationshipMatrix.GetRelationshipTags(Relationship));
+
+        Candidates.Emplace(Actor, FVector2D(Actor->GetActorLocation()), TargetTags);
     }
 
-    // Find the best best target out of all potential targets using the score.
-    TTuple<AActor*, float> HighestScoredActor;
-    for (TTuple<AActor*, float> ActorWithScore : ActorsWithScore)
+    // Apply the order specific valid target check, and score all valid targets.
+    TArray<float> CandidateScores;
+    CandidateScores.SetNumUninitialized(Candidates.Num());
+
+    auto ScoreCandidate = [Order, OrderedActor, Index, &Candidates, &CandidateScores](int32 CandidateIndex) {
+        const FRTSOrderTargetData& OrderTargetData = Candidates[CandidateIndex];
+        CandidateScores[CandidateIndex] = Order->IsValidTarget(OrderedActor, OrderTargetData, Index)
+                                              ? Order->GetTargetScore(OrderedActor, OrderTargetData, Index)
+                                              : TNumericLimits<float>::Lowest();
+    };
+
+    const int32 ParallelThreshold = CVarRTSParallelTargetScoringThreshold.GetValueOnGameThread();
+    if (ParallelThreshold > 0 && Candidates.Num() >= ParallelThreshold &&
+        Order->SupportsParallelTargetScoring(OrderedActor, Index))
     {
-        if (HighestScoredActor.Get<1>() < ActorWithScore.Get<1>())
+        INC_DWORD_STAT_BY(STAT_RTSParallelScoredTargets, Candidates.Num());
+        ParallelFor(Candidates.Num(), ScoreCandidate);
+    }
+    else
+    {
+        INC_DWORD_STAT_BY(STAT_RTSSerialScoredTargets, Candidates.Num());
+        for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
         {
-            HighestScoredActor = ActorWithScore;
+            ScoreCandidate(CandidateIndex);
         }
     }
 
-    OutScore = HighestScoredActor.Get<1>();
-    return HighestScoredActor.Get<0>();
+    // Find the best targets using the score. Reducing in the order of the targets yields the same targets, no matter
+    // whether the scores have been computed in parallel.
+    for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+    {
+        const float Score = CandidateScores[CandidateIndex];
+        if (Score <= 0.0f)
+        {
+            continue;
+        }
+
+        // Keep the targets sorted, preferring earlier ones with the same score.
+        int32 InsertIndex = OutTargets.Num();
+        while (InsertIndex > 0 && OutTargets[InsertIndex - 1].Score < Score)
+        {
+            --InsertIndex;
+        }
+
+        if (InsertIndex >= MaxTargets)
+        {
+            continue;
+        }
+
+        OutTargets.Insert(FRTSScoredTarget(Candidates[CandidateIndex].Actor, Score), InsertIndex);
+
+        if (OutTargets.Num() > MaxTargets)
+        {
+            OutTargets.Pop(false);
+        }
+    }
 }
 
 AActor* URTSOrderHelper::FindMostSuitableActorToObeyTheOrder(TSoftClassPtr<URTSOrder> OrderType,
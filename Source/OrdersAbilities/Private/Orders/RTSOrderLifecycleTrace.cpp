@@ -0,0 +1,202 @@
+#include "Orders/RTSOrderLifecycleTrace.h"
+
+#include "OrdersAbilities.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+
+#if RTS_ORDER_LIFECYCLE_TRACE
+
+static FAutoConsoleCommand CmdRTSDumpOrderLatencies(
+    TEXT("RTS.Orders.DumpLatencies"),
+    TEXT("Logs the 50th, 95th and 99th percentile of the latencies between the lifecycle stages of all orders, by "
+         "order type."),
+    FConsoleCommandDelegate::CreateLambda([]() { FRTSOrderLifecycleStats::Get().DumpLatencies(); }));
+
+static FAutoConsoleCommand CmdRTSResetOrderLatencies(
+    TEXT("RTS.Orders.ResetLatencies"), TEXT("Discards the latencies between the lifecycle stages of all orders."),
+    FConsoleCommandDelegate::CreateLambda([]() { FRTSOrderLifecycleStats::Get().Reset(); }));
+
+
+FRTSOrderLifecycleRecord::FRTSOrderLifecycleRecord()
+    : OrderType(NAME_None)
+    , bIsClosed(true)
+{
+    FMemory::Memzero(StageTimes);
+}
+
+FRTSOrderLifecycleTrace::FRTSOrderLifecycleTrace()
+    : NumRecords(0)
+{
+}
+
+void FRTSOrderLifecycleTrace::BeginOrder(FName OrderType, ERTSOrderLifecycleStage Stage)
+{
+    CloseCurrentRecord();
+
+    // Overwrite the oldest record.
+    FRTSOrderLifecycleRecord& Record = Records[NumRecords % RTS_ORDER_LIFECYCLE_TRACE_CAPACITY];
+    Record = FRTSOrderLifecycleRecord();
+    Record.OrderType = OrderType;
+    Record.StageTimes[(int32)Stage] = FPlatformTime::Seconds();
+    Record.bIsClosed = false;
+
+    ++NumRecords;
+}
+
+void FRTSOrderLifecycleTrace::MarkStage(ERTSOrderLifecycleStage Stage)
+{
+    FRTSOrderLifecycleRecord* Record = FindOpenRecord();
+    if (Record == nullptr || Record->StageTimes[(int32)Stage] > 0.0)
+    {
+        return;
+    }
+
+    Record->StageTimes[(int32)Stage] = FPlatformTime::Seconds();
+}
+
+void FRTSOrderLifecycleTrace::MarkStage(FName OrderType, ERTSOrderLifecycleStage Stage)
+{
+    FRTSOrderLifecycleRecord* Record = FindOpenRecord();
+    if (Record == nullptr || Record->OrderType != OrderType || Record->StageTimes[(int32)Stage] > 0.0)
+    {
+        BeginOrder(OrderType, Stage);
+        return;
+    }
+
+    Record->StageTimes[(int32)Stage] = FPlatformTime::Seconds();
+}
+
+void FRTSOrderLifecycleTrace::EndOrder()
+{
+    MarkStage(ERTSOrderLifecycleStage::ENDED);
+    CloseCurrentRecord();
+}
+
+const FRTSOrderLifecycleRecord* FRTSOrderLifecycleTrace::GetCurrentRecord() const
+{
+    if (NumRecords <= 0)
+    {
+        return nullptr;
+    }
+
+    const FRTSOrderLifecycleRecord& Record = Records[(NumRecords - 1) % RTS_ORDER_LIFECYCLE_TRACE_CAPACITY];
+    return Record.bIsClosed ? nullptr : &Record;
+}
+
+FRTSOrderLifecycleRecord* FRTSOrderLifecycleTrace::FindOpenRecord()
+{
+    return const_cast<FRTSOrderLifecycleRecord*>(static_cast<const FRTSOrderLifecycleTrace*>(this)->GetCurrentRecord());
+}
+
+void FRTSOrderLifecycleTrace::GetRecords(TArray<FRTSOrderLifecycleRecord>& OutRecords) const
+{
+    int32 NumAvailableRecords = FMath::Min(NumRecords, RTS_ORDER_LIFECYCLE_TRACE_CAPACITY);
+
+    OutRecords.Reset(NumAvailableRecords);
+
+    for (int32 Index = 1; Index <= NumAvailableRecords; ++Index)
+    {
+        OutRecords.Add(Records[(NumRecords - Index) % RTS_ORDER_LIFECYCLE_TRACE_CAPACITY]);
+    }
+}
+
+void FRTSOrderLifecycleTrace::CloseCurrentRecord()
+{
+    FRTSOrderLifecycleRecord* Record = FindOpenRecord();
+    if (Record == nullptr)
+    {
+        return;
+    }
+
+    Record->bIsClosed = true;
+    FRTSOrderLifecycleStats::Get().AddRecord(*Record);
+}
+
+FRTSOrderLifecycleStats& FRTSOrderLifecycleStats::Get()
+{
+    static FRTSOrderLifecycleStats Stats;
+    return Stats;
+}
+
+void FRTSOrderLifecycleStats::AddRecord(const FRTSOrderLifecycleRecord& Record)
+{
+    check(IsInGameThread());
+
+    FOrderTypeLatencies& Latencies = LatenciesByOrderType.FindOrAdd(Record.OrderType);
+    double PreviousStageTime = 0.0;
+
+    for (int32 Stage = 0; Stage < (int32)ERTSOrderLifecycleStage::NUM; ++Stage)
+    {
+        double StageTime = Record.StageTimes[Stage];
+        if (StageTime <= 0.0)
+        {
+            continue;
+        }
+
+        if (PreviousStageTime > 0.0)
+        {
+            float LatencyMs = (float)((StageTime - PreviousStageTime) * 1000.0);
+
+            // Keep the latest samples only, overwriting the oldest one.
+            TArray<float>& Samples = Latencies.Samples[Stage];
+            if (Samples.Num() < RTS_ORDER_LIFECYCLE_MAX_SAMPLES)
+            {
+                Samples.Add(LatencyMs);
+            }
+            else
+            {
+                Samples[Latencies.NumSamples[Stage] % RTS_ORDER_LIFECYCLE_MAX_SAMPLES] = LatencyMs;
+            }
+
+            ++Latencies.NumSamples[Stage];
+        }
+
+        PreviousStageTime = StageTime;
+    }
+}
+
+void FRTSOrderLifecycleStats::DumpLatencies() const
+{
+    static const TCHAR* StageNames[] = {TEXT("Issued"), TEXT("Checked"), TEXT("Obeyed"), TEXT("Applied"),
+                                        TEXT("Ended")};
+    static_assert(ARRAY_COUNT(StageNames) == (int32)ERTSOrderLifecycleStage::NUM,
+                  "Every order lifecycle stage needs a name.");
+
+    auto GetPercentile = [](const TArray<float>& SortedSamples, float Percentile) {
+        int32 Index = FMath::CeilToInt(Percentile * SortedSamples.Num()) - 1;
+        return SortedSamples[FMath::Clamp(Index, 0, SortedSamples.Num() - 1)];
+    };
+
+    UE_LOG(LogRTS, Log, TEXT("Order lifecycle latencies since the previous stage, in milliseconds:"));
+
+    TArray<float> SortedSamples;
+
+    for (const TPair<FName, FOrderTypeLatencies>& Pair : LatenciesByOrderType)
+    {
+        UE_LOG(LogRTS, Log, TEXT("%s"), *Pair.Key.ToString());
+
+        for (int32 Stage = 0; Stage < (int32)ERTSOrderLifecycleStage::NUM; ++Stage)
+        {
+            SortedSamples = Pair.Value.Samples[Stage];
+            if (SortedSamples.Num() == 0)
+            {
+                continue;
+            }
+
+            SortedSamples.Sort();
+
+            UE_LOG(LogRTS, Log, TEXT("    %-8s p50 %8.3f  p95 %8.3f  p99 %8.3f  (%d orders)"), StageNames[Stage],
+                   GetPercentile(SortedSamples, 0.50f), GetPercentile(SortedSamples, 0.95f),
+                   GetPercentile(SortedSamples, 0.99f), Pair.Value.NumSamples[Stage]);
+        }
+    }
+}
+
+void FRTSOrderLifecycleStats::Reset()
+{
+    LatenciesByOrderType.Reset();
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include "Orders/RTSOrderQueue.h"
+
+#include "OrdersAbilities.h"
+
+#include "GameFramework/Actor.h"
+#include "UObject/GCObject.h"
+
+
+FRTSOrderQueue::FRTSOrderQueue()
+    : Head(0)
+    , Count(0)
+{
+}
+
+int32 FRTSOrderQueue::Num() const
+{
+    return Count;
+}
+
+bool FRTSOrderQueue::IsEmpty() const
+{
+    return Count == 0;
+}
+
+bool FRTSOrderQueue::IsValidIndex(int32 Index) const
+{
+    return Index >= 0 && Index < Count;
+}
+
+const FRTSOrderData& FRTSOrderQueue::operator[](int32 Index) const
+{
+    check(IsValidIndex(Index));
+    return Slots[GetSlotIndex(Index)];
+}
+
+const FRTSOrderData& FRTSOrderQueue::First() const
+{
+    return (*this)[0];
+}
+
+FRTSOrderData& FRTSOrderQueue::First()
+{
+    check(IsValidIndex(0));
+    return Slots[GetSlotIndex(0)];
+}
+
+const FRTSOrderData& FRTSOrderQueue::Last() const
+{
+    return (*this)[Count - 1];
+}
+
+void FRTSOrderQueue::PushBack(const FRTSOrderData& Order)
+{
+    if (Count == Slots.Num())
+    {
+        Grow();
+    }
+
+    Slots[GetSlotIndex(Count)] = Order;
+    ++Count;
+}
+
+void FRTSOrderQueue::PushFront(const FRTSOrderData& Order)
+{
+    if (Count == Slots.Num())
+    {
+        Grow();
+    }
+
+    Head = (Head - 1) & (Slots.Num() - 1);
+    Slots[Head] = Order;
+    ++Count;
+}
+
+void FRTSOrderQueue::PopFront()
+{
+    check(Count > 0);
+
+    // Release the target of the order, so it doesn't keep the actor alive.
+    Slots[Head] = FRTSOrderData();
+
+    Head = (Head + 1) & (Slots.Num() - 1);
+    --Count;
+}
+
+void FRTSOrderQueue::Reset()
+{
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        Slots[GetSlotIndex(Index)] = FRTSOrderData();
+    }
+
+    Head = 0;
+    Count = 0;
+}
+
+void FRTSOrderQueue::ToArray(TArray<FRTSOrderData>& OutOrders) const
+{
+    OutOrders.Reset(Count);
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        OutOrders.Add(Slots[GetSlotIndex(Index)]);
+    }
+}
+
+void FRTSOrderQueue::FromArray(const TArray<FRTSOrderData>& Orders)
+{
+    Reset();
+
+    for (const FRTSOrderData& Order : Orders)
+    {
+        PushBack(Order);
+    }
+}
+
+void FRTSOrderQueue::AddStructReferencedObjects(FReferenceCollector& Collector) const
+{
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        FRTSOrderData& Order = const_cast<FRTSOrderData&>(Slots[GetSlotIndex(Index)]);
+        Collector.AddReferencedObject(Order.Target);
+    }
+}
+
+int32 FRTSOrderQueue::GetSlotIndex(int32 Index) const
+{
+    return (Head + Index) & (Slots.Num() - 1);
+}
+
+void FRTSOrderQueue::Grow()
+{
+    const int32 NewCapacity = FMath::Max(RTS_ORDER_QUEUE_INLINE_CAPACITY, Slots.Num() * 2);
+
+    // Unwrap the ring buffer while copying, so the front of the queue ends up in the first slot.
+    TArray<FRTSOrderData, TInlineAllocator<RTS_ORDER_QUEUE_INLINE_CAPACITY>> NewSlots;
+    NewSlots.Reserve(NewCapacity);
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        NewSlots.Add(MoveTemp(Slots[GetSlotIndex(Index)]));
+    }
+
+    NewSlots.SetNum(NewCapacity);
+
+    Slots = MoveTemp(NewSlots);
+    Head = 0;
+}
@@ -0,0 +1,90 @@
+#include "Orders/RTSOrderResultDispatcher.h"
+
+#include "OrdersAbilities.h"
+
+#include "Engine/World.h"
+
+#include "Orders/RTSCharacterAIController.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Order Result Dispatch"), STAT_RTSOrderResultDispatch, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Results Dispatched"), STAT_RTSOrderResultsDispatched, STATGROUP_RTS);
+
+
+FRTSOrderResultDispatcher* FRTSOrderResultDispatcher::Get(UWorld* World)
+{
+    // Dispatch results once per frame.
+    static FDelegateHandle WorldPreActorTickHandle;
+    if (!WorldPreActorTickHandle.IsValid())
+    {
+        WorldPreActorTickHandle =
+            FWorldDelegates::OnWorldPreActorTick.AddStatic(&FRTSOrderResultDispatcher::OnWorldPreActorTick);
+    }
+
+    return GetWorldDispatchers().FindOrAdd(World);
+}
+
+FRTSOrderResultDispatcher* FRTSOrderResultDispatcher::Find(const UWorld* World)
+{
+    return GetWorldDispatchers().Find(World);
+}
+
+void FRTSOrderResultDispatcher::ScheduleOrderResult(ARTSCharacterAIController* Controller)
+{
+    check(IsInGameThread());
+
+    if (Controller == nullptr)
+    {
+        return;
+    }
+
+    ScheduledControllers.Add(Controller);
+}
+
+void FRTSOrderResultDispatcher::DispatchOrderResults()
+{
+    check(IsInGameThread());
+
+    if (ScheduledControllers.Num() == 0)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_RTSOrderResultDispatch);
+
+    // Ending orders usually issues new ones, whose results are reported in the next frame.
+    TArray<TWeakObjectPtr<ARTSCharacterAIController>> Controllers = MoveTemp(ScheduledControllers);
+
+    for (const TWeakObjectPtr<ARTSCharacterAIController>& WeakController : Controllers)
+    {
+        // Reporting results might have destroyed other units.
+        ARTSCharacterAIController* Controller = WeakController.Get();
+        if (Controller != nullptr)
+        {
+            Controller->DispatchOrderResult();
+        }
+    }
+
+    INC_DWORD_STAT_BY(STAT_RTSOrderResultsDispatched, Controllers.Num());
+}
+
+TRTSPerWorld<FRTSOrderResultDispatcher>& FRTSOrderResultDispatcher::GetWorldDispatchers()
+{
+    static TRTSPerWorld<FRTSOrderResultDispatcher> WorldDispatchers;
+    return WorldDispatchers;
+}
+
+void FRTSOrderResultDispatcher::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    // Controllers used to report results in their own tick, which doesn't happen while paused.
+    if (World == nullptr || World->IsPaused())
+    {
+        return;
+    }
+
+    FRTSOrderResultDispatcher* Dispatcher = Find(World);
+    if (Dispatcher != nullptr)
+    {
+        Dispatcher->DispatchOrderResults();
+    }
+}
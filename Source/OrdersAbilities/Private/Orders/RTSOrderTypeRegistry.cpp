@@ -0,0 +1,147 @@
+#include "Orders/RTSOrderTypeRegistry.h"
+
+#include "OrdersAbilities.h"
+
+#include "Orders/RTSOrder.h"
+#include "Orders/RTSOrderData.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Type Cache Hits"), STAT_RTSOrderTypeCacheHits, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Type Cache Misses"), STAT_RTSOrderTypeCacheMisses, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Type Synchronous Loads"), STAT_RTSOrderTypeSynchronousLoads,
+                           STATGROUP_RTS);
+
+
+FRTSOrderTypeRegistry& FRTSOrderTypeRegistry::Get()
+{
+    static FRTSOrderTypeRegistry Registry;
+    return Registry;
+}
+
+const FRTSResolvedOrderType* FRTSOrderTypeRegistry::Resolve(const FSoftObjectPath& OrderTypePath)
+{
+    check(IsInGameThread());
+
+    if (OrderTypePath.IsNull())
+    {
+        return nullptr;
+    }
+
+    const int32* ExistingIndex = ResolvedOrderTypeIndices.Find(OrderTypePath);
+    if (ExistingIndex != nullptr)
+    {
+        INC_DWORD_STAT(STAT_RTSOrderTypeCacheHits);
+
+        FRTSResolvedOrderType& ResolvedOrderType = ResolvedOrderTypes[*ExistingIndex];
+
+#if WITH_EDITOR
+        // Blueprint classes might have been recompiled and reinstanced in the meantime.
+        UClass* CurrentClass = Cast<UClass>(OrderTypePath.ResolveObject());
+        if (CurrentClass != nullptr && CurrentClass != ResolvedOrderType.Class)
+        {
+            ResolvedOrderType.Class = CurrentClass;
+            ResolvedOrderType.DefaultObject = CurrentClass->GetDefaultObject<URTSOrder>();
+        }
+#endif
+
+        return &ResolvedOrderType;
+    }
+
+    INC_DWORD_STAT(STAT_RTSOrderTypeCacheMisses);
+
+    UClass* OrderClass = Cast<UClass>(OrderTypePath.ResolveObject());
+    if (OrderClass == nullptr)
+    {
+        // This will cause a hitch. Order types should be preloaded with LoadAsync instead.
+        INC_DWORD_STAT(STAT_RTSOrderTypeSynchronousLoads);
+        UE_LOG(LogRTS, Log, TEXT("FRTSOrderTypeRegistry::Resolve: Loading order type %s synchronously."),
+               *OrderTypePath.ToString());
+
+        OrderClass = Cast<UClass>(OrderTypePath.TryLoad());
+    }
+
+    if (OrderClass == nullptr || !OrderClass->IsChildOf(URTSOrder::StaticClass()))
+    {
+        UE_LOG(LogRTS, Error, TEXT("FRTSOrderTypeRegistry::Resolve: %s is not a valid order type."),
+               *OrderTypePath.ToString());
+        return nullptr;
+    }
+
+    FRTSResolvedOrderType* ResolvedOrderType = new FRTSResolvedOrderType();
+    ResolvedOrderType->Path = OrderTypePath;
+    ResolvedOrderType->Class = OrderClass;
+    ResolvedOrderType->DefaultObject = OrderClass->GetDefaultObject<URTSOrder>();
+
+    int32 Index = ResolvedOrderTypes.Add(ResolvedOrderType);
+    ResolvedOrderTypeIndices.Add(OrderTypePath, Index);
+
+    return ResolvedOrderType;
+}
+
+const URTSOrder* FRTSOrderTypeRegistry::GetDefaultObject(const TSoftClassPtr<URTSOrder>& OrderType)
+{
+    const FRTSResolvedOrderType* ResolvedOrderType = Resolve(OrderType.ToSoftObjectPath());
+    return ResolvedOrderType != nullptr ? ResolvedOrderType->DefaultObject : nullptr;
+}
+
+const URTSOrder* FRTSOrderTypeRegistry::GetDefaultObject(const FRTSOrderData& Order)
+{
+    // The order type of the order might have been changed after the handle was cached, e.g. from Blueprints.
+    if (Order.ResolvedOrderType != nullptr && Order.ResolvedOrderType->Path == Order.OrderType.ToSoftObjectPath())
+    {
+        INC_DWORD_STAT(STAT_RTSOrderTypeCacheHits);
+        return Order.ResolvedOrderType->DefaultObject;
+    }
+
+    Order.ResolvedOrderType = Resolve(Order.OrderType.ToSoftObjectPath());
+    return Order.ResolvedOrderType != nullptr ? Order.ResolvedOrderType->DefaultObject : nullptr;
+}
+
+bool FRTSOrderTypeRegistry::IsLoaded(const FSoftObjectPath& OrderTypePath) const
+{
+    return OrderTypePath.IsNull() || ResolvedOrderTypeIndices.Contains(OrderTypePath) ||
+           OrderTypePath.ResolveObject() != nullptr;
+}
+
+void FRTSOrderTypeRegistry::LoadAsync(const TArray<FSoftObjectPath>& OrderTypePaths, FStreamableDelegate OnLoaded)
+{
+    check(IsInGameThread());
+
+    TArray<FSoftObjectPath> OrderTypePathsToLoad;
+
+    for (const FSoftObjectPath& OrderTypePath : OrderTypePaths)
+    {
+        if (!IsLoaded(OrderTypePath))
+        {
+            OrderTypePathsToLoad.AddUnique(OrderTypePath);
+        }
+    }
+
+    if (OrderTypePathsToLoad.Num() == 0)
+    {
+        OnAsyncLoadCompleted(OrderTypePaths, OnLoaded);
+        return;
+    }
+
+    StreamableManager.RequestAsyncLoad(
+        OrderTypePathsToLoad,
+        FStreamableDelegate::CreateRaw(this, &FRTSOrderTypeRegistry::OnAsyncLoadCompleted, OrderTypePaths, OnLoaded));
+}
+
+void FRTSOrderTypeRegistry::OnAsyncLoadCompleted(TArray<FSoftObjectPath> OrderTypePaths, FStreamableDelegate OnLoaded)
+{
+    for (const FSoftObjectPath& OrderTypePath : OrderTypePaths)
+    {
+        Resolve(OrderTypePath);
+    }
+
+    OnLoaded.ExecuteIfBound();
+}
+
+void FRTSOrderTypeRegistry::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    for (FRTSResolvedOrderType& ResolvedOrderType : ResolvedOrderTypes)
+    {
+        Collector.AddReferencedObject(ResolvedOrderType.Class);
+    }
+}
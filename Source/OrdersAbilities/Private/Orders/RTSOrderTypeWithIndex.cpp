@@ -21,14 +21,10 @@ FString FRTSOrderTypeWithIndex::ToString() const
 {
     FString s;
 
-    if (OrderType != nullptr)
+    if (!OrderType.IsNull())
     {
-        if (!OrderType.IsValid())
-        {
-            OrderType.LoadSynchronous();
-        }
-
-        s += OrderType->GetName();
+        // Don't load the order type just for logging it.
+        s += OrderType.GetAssetName();
     }
     else
     {
@@ -0,0 +1,13 @@
+#include "Orders/RTSPendingOrder.h"
+
+
+FRTSPendingOrder::FRTSPendingOrder()
+{
+    IssueMode = ERTSOrderIssueMode::ISSUE;
+}
+
+FRTSPendingOrder::FRTSPendingOrder(const FRTSOrderData& InOrder, ERTSOrderIssueMode InIssueMode)
+    : Order(InOrder)
+    , IssueMode(InIssueMode)
+{
+}
@@ -0,0 +1,199 @@
+#include "Orders/RTSReplicatedOrderQueue.h"
+
+#include "OrdersAbilities.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Order Queue Replicated Bits"), STAT_RTSOrderQueueReplicatedBits, STATGROUP_RTS);
+
+
+FRTSReplicatedOrder::FRTSReplicatedOrder()
+    : SequenceNumber(0)
+{
+}
+
+FRTSReplicatedOrder::FRTSReplicatedOrder(const FRTSOrderData& InOrder, int32 InSequenceNumber)
+    : Order(InOrder)
+    , SequenceNumber(InSequenceNumber)
+{
+}
+
+void FRTSReplicatedOrder::PreReplicatedRemove(const FRTSReplicatedOrderQueue& InArraySerializer)
+{
+    InArraySerializer.bHasReceivedChanges = true;
+}
+
+void FRTSReplicatedOrder::PostReplicatedAdd(const FRTSReplicatedOrderQueue& InArraySerializer)
+{
+    InArraySerializer.bHasReceivedChanges = true;
+}
+
+void FRTSReplicatedOrder::PostReplicatedChange(const FRTSReplicatedOrderQueue& InArraySerializer)
+{
+    InArraySerializer.bHasReceivedChanges = true;
+}
+
+FRTSReplicatedOrderQueue::FRTSReplicatedOrderQueue()
+    : FrontSequenceNumber(0)
+    , BackSequenceNumber(0)
+    , bHasReceivedChanges(false)
+{
+}
+
+int32 FRTSReplicatedOrderQueue::Num() const
+{
+    return Orders.Num();
+}
+
+bool FRTSReplicatedOrderQueue::IsEmpty() const
+{
+    return Orders.IsEmpty();
+}
+
+bool FRTSReplicatedOrderQueue::IsValidIndex(int32 Index) const
+{
+    return Orders.IsValidIndex(Index);
+}
+
+const FRTSOrderData& FRTSReplicatedOrderQueue::operator[](int32 Index) const
+{
+    return Orders[Index];
+}
+
+const FRTSOrderData& FRTSReplicatedOrderQueue::First() const
+{
+    return Orders.First();
+}
+
+FRTSOrderData& FRTSReplicatedOrderQueue::First()
+{
+    return Orders.First();
+}
+
+const FRTSOrderData& FRTSReplicatedOrderQueue::Last() const
+{
+    return Orders.Last();
+}
+
+void FRTSReplicatedOrderQueue::PushBack(const FRTSOrderData& Order)
+{
+    Orders.PushBack(Order);
+
+    AddItem(Order, BackSequenceNumber);
+    ++BackSequenceNumber;
+}
+
+void FRTSReplicatedOrderQueue::PushFront(const FRTSOrderData& Order)
+{
+    Orders.PushFront(Order);
+
+    --FrontSequenceNumber;
+    AddItem(Order, FrontSequenceNumber);
+}
+
+void FRTSReplicatedOrderQueue::PopFront()
+{
+    if (Orders.IsEmpty())
+    {
+        return;
+    }
+
+    Orders.PopFront();
+
+    int32 FrontIndex = INDEX_NONE;
+    if (ItemIndices.RemoveAndCopyValue(FrontSequenceNumber, FrontIndex))
+    {
+        // Items of fast arrays are identified by their replication ID, not by their index.
+        Items.RemoveAtSwap(FrontIndex);
+
+        if (Items.IsValidIndex(FrontIndex))
+        {
+            ItemIndices.Add(Items[FrontIndex].SequenceNumber, FrontIndex);
+        }
+
+        MarkArrayDirty();
+    }
+
+    ++FrontSequenceNumber;
+}
+
+void FRTSReplicatedOrderQueue::Reset()
+{
+    Orders.Reset();
+
+    if (Items.Num() == 0)
+    {
+        return;
+    }
+
+    Items.Reset();
+    ItemIndices.Reset();
+
+    // Keep counting, so clients can never confuse new orders with removed ones.
+    FrontSequenceNumber = BackSequenceNumber;
+
+    MarkArrayDirty();
+}
+
+void FRTSReplicatedOrderQueue::ToArray(TArray<FRTSOrderData>& OutOrders) const
+{
+    Orders.ToArray(OutOrders);
+}
+
+bool FRTSReplicatedOrderQueue::ApplyReceivedChanges()
+{
+    if (!bHasReceivedChanges)
+    {
+        return false;
+    }
+
+    bHasReceivedChanges = false;
+
+    TArray<const FRTSReplicatedOrder*> SortedItems;
+    SortedItems.Reserve(Items.Num());
+
+    for (const FRTSReplicatedOrder& Item : Items)
+    {
+        SortedItems.Add(&Item);
+    }
+
+    SortedItems.Sort([](const FRTSReplicatedOrder& A, const FRTSReplicatedOrder& B) {
+        return A.SequenceNumber < B.SequenceNumber;
+    });
+
+    Orders.Reset();
+
+    for (const FRTSReplicatedOrder* Item : SortedItems)
+    {
+        Orders.PushBack(Item->Order);
+    }
+
+    return true;
+}
+
+bool FRTSReplicatedOrderQueue::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+#if STATS
+    const int64 NumBitsBefore = DeltaParms.Writer != nullptr ? DeltaParms.Writer->GetNumBits() : 0;
+#endif
+
+    bool bSuccess =
+        FFastArraySerializer::FastArrayDeltaSerialize<FRTSReplicatedOrder, FRTSReplicatedOrderQueue>(Items, DeltaParms,
+                                                                                                     *this);
+
+#if STATS
+    if (DeltaParms.Writer != nullptr)
+    {
+        INC_DWORD_STAT_BY(STAT_RTSOrderQueueReplicatedBits, DeltaParms.Writer->GetNumBits() - NumBitsBefore);
+    }
+#endif
+
+    return bSuccess;
+}
+
+void FRTSReplicatedOrderQueue::AddItem(const FRTSOrderData& Order, int32 SequenceNumber)
+{
+    const int32 Index = Items.Add(FRTSReplicatedOrder(Order, SequenceNumber));
+    ItemIndices.Add(SequenceNumber, Index);
+
+    MarkItemDirty(Items[Index]);
+}
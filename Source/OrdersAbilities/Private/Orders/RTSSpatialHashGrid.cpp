@@ -0,0 +1,482 @@
+#include "Orders/RTSSpatialHashGrid.h"
+
+#include "OrdersAbilities.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+#include "AbilitySystem/RTSRelationshipMatrix.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Spatial Grid Query"), STAT_RTSSpatialGridQuery, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Spatial Grid Queries"), STAT_RTSSpatialGridQueries, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Spatial Grid Actors Tested"), STAT_RTSSpatialGridActorsTested, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Spatial Grid Cell Changes"), STAT_RTSSpatialGridCellChanges, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Spatial Grid Hostile Queries"), STAT_RTSSpatialGridHostileQueries,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Spatial Grid Hostile Cells Counted"), STAT_RTSSpatialGridHostileCellsCounted,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Spatial Grid Hostile Cells Checked Exactly"),
+                           STAT_RTSSpatialGridHostileCellsCheckedExactly, STATGROUP_RTS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("RTS - Spatial Grid Actors"), STAT_RTSSpatialGridActors, STATGROUP_RTS);
+
+static TAutoConsoleVariable<float> CVarRTSSpatialGridCellSize(
+    TEXT("RTS.SpatialGrid.CellSize"), 1000.0f,
+    TEXT("Width and height of the cells of the spatial hash grid used for finding order targets, in world units. "
+         "Applied to grids created afterwards."),
+    ECVF_Default);
+
+
+FRTSSpatialHashGrid::FRTSSpatialHashGrid(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, 1.0f))
+{
+}
+
+FRTSSpatialHashGrid::~FRTSSpatialHashGrid()
+{
+    // Don't get notified about movement after the grid has been destroyed.
+    for (const TPair<AActor*, FActorEntry>& Pair : Entries)
+    {
+        USceneComponent* RootComponent = Pair.Value.RootComponent.Get();
+        if (RootComponent != nullptr)
+        {
+            RootComponent->TransformUpdated.Remove(Pair.Value.TransformUpdatedHandle);
+        }
+    }
+
+    DEC_DWORD_STAT_BY(STAT_RTSSpatialGridActors, Entries.Num());
+}
+
+FRTSSpatialHashGrid* FRTSSpatialHashGrid::Get(const UWorld* World)
+{
+    return GetWorldGrids().FindOrAdd(World, CVarRTSSpatialGridCellSize.GetValueOnGameThread());
+}
+
+FRTSSpatialHashGrid* FRTSSpatialHashGrid::Find(const UWorld* World)
+{
+    return GetWorldGrids().Find(World);
+}
+
+void FRTSSpatialHashGrid::RegisterActor(AActor* Actor)
+{
+    if (Actor == nullptr)
+    {
+        return;
+    }
+
+    FActorEntry* ExistingEntry = Entries.Find(Actor);
+    if (ExistingEntry != nullptr)
+    {
+        ++ExistingEntry->RegistrationCount;
+        return;
+    }
+
+    const FVector Location = Actor->GetActorLocation();
+
+    FActorEntry& Entry = Entries.Add(Actor);
+    Entry.Cell = GetCell(Location);
+    Entry.TeamId = FRTSRelationshipMatrix::Get().GetTeam(Actor);
+    Entry.RegistrationCount = 1;
+    Entry.RootComponent = Actor->GetRootComponent();
+
+    if (Entry.RootComponent.IsValid())
+    {
+        Entry.TransformUpdatedHandle =
+            Entry.RootComponent->TransformUpdated.AddRaw(this, &FRTSSpatialHashGrid::OnTransformUpdated);
+    }
+
+    AddToCell(Actor, Entry, Location);
+
+    INC_DWORD_STAT(STAT_RTSSpatialGridActors);
+
+    OnActorEnteredCell.Broadcast(Actor, Entry.Cell);
+}
+
+void FRTSSpatialHashGrid::UnregisterActor(AActor* Actor)
+{
+    FActorEntry* Entry = Entries.Find(Actor);
+    if (Entry == nullptr)
+    {
+        return;
+    }
+
+    if (--Entry->RegistrationCount > 0)
+    {
+        return;
+    }
+
+    USceneComponent* RootComponent = Entry->RootComponent.Get();
+    if (RootComponent != nullptr)
+    {
+        RootComponent->TransformUpdated.Remove(Entry->TransformUpdatedHandle);
+    }
+
+    RemoveFromCell(*Entry);
+    Entries.Remove(Actor);
+
+    DEC_DWORD_STAT(STAT_RTSSpatialGridActors);
+}
+
+void FRTSSpatialHashGrid::UpdateActor(AActor* Actor)
+{
+    FActorEntry* Entry = Entries.Find(Actor);
+    if (Entry == nullptr)
+    {
+        return;
+    }
+
+    const FVector Location = Actor->GetActorLocation();
+
+    FIntPoint NewCell = GetCell(Location);
+    if (NewCell == Entry->Cell)
+    {
+        // Just update the location in the cell.
+        FCell& Cell = Cells[Entry->Cell];
+        Cell.LocationsX[Entry->CellIndex] = Location.X;
+        Cell.LocationsY[Entry->CellIndex] = Location.Y;
+        return;
+    }
+
+    INC_DWORD_STAT(STAT_RTSSpatialGridCellChanges);
+
+    // Pick up team changes on the way, which are rare enough to not check them on every move.
+    RemoveFromCell(*Entry);
+    Entry->Cell = NewCell;
+    Entry->TeamId = FRTSRelationshipMatrix::Get().GetTeam(Actor);
+    AddToCell(Actor, *Entry, Location);
+
+    OnActorEnteredCell.Broadcast(Actor, NewCell);
+}
+
+void FRTSSpatialHashGrid::UpdateActorTeam(AActor* Actor)
+{
+    FActorEntry* Entry = Entries.Find(Actor);
+    if (Entry == nullptr)
+    {
+        return;
+    }
+
+    FGenericTeamId NewTeamId = FRTSRelationshipMatrix::Get().GetTeam(Actor);
+    if (NewTeamId == Entry->TeamId)
+    {
+        return;
+    }
+
+    const FCell& Cell = Cells[Entry->Cell];
+    const FVector Location(Cell.LocationsX[Entry->CellIndex], Cell.LocationsY[Entry->CellIndex], 0.0f);
+
+    RemoveFromCell(*Entry);
+    Entry->TeamId = NewTeamId;
+    AddToCell(Actor, *Entry, Location);
+}
+
+void FRTSSpatialHashGrid::FindActorsInRadius(const FVector& Location, float Radius, TArray<AActor*>& OutActors) const
+{
+    FindActorsInChaseDistance(Location, Radius, Location, Radius, OutActors);
+}
+
+void FRTSSpatialHashGrid::FindActorsInChaseDistance(const FVector& Location, float Radius, const FVector& HomeLocation,
+                                                    float ChaseDistance, TArray<AActor*>& OutActors) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_RTSSpatialGridQuery);
+    INC_DWORD_STAT(STAT_RTSSpatialGridQueries);
+
+    if (Radius < 0.0f || ChaseDistance < 0.0f)
+    {
+        return;
+    }
+
+    const float RadiusSquared = FMath::Square(Radius);
+    const float ChaseDistanceSquared = FMath::Square(ChaseDistance);
+
+    // Only check cells overlapping the bounds of the query radius.
+    const FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.0f));
+    const FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.0f));
+
+    TArray<int32> CandidateIndices;
+
+    for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+    {
+        for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+        {
+            const FCell* Cell = Cells.Find(FIntPoint(CellX, CellY));
+            if (Cell == nullptr)
+            {
+                continue;
+            }
+
+            INC_DWORD_STAT_BY(STAT_RTSSpatialGridActorsTested, Cell->Actors.Num());
+
+            // Actors that are too far away from the home location are invalid.
+            CandidateIndices.Reset();
+            FilterCell(*Cell, Location, RadiusSquared, HomeLocation, ChaseDistanceSquared, CandidateIndices);
+
+            for (int32 CandidateIndex : CandidateIndices)
+            {
+                AActor* Actor = Cell->Actors[CandidateIndex];
+                if (IsValid(Actor))
+                {
+                    OutActors.Add(Actor);
+                }
+            }
+        }
+    }
+}
+
+bool FRTSSpatialHashGrid::IsHostileInRadius(const AActor* Actor, const FVector& Location, float Radius) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_RTSSpatialGridQuery);
+    INC_DWORD_STAT(STAT_RTSSpatialGridHostileQueries);
+
+    if (Radius < 0.0f)
+    {
+        return false;
+    }
+
+    FRTSRelationshipMatrix& RelationshipMatrix = FRTSRelationshipMatrix::Get();
+    const FGenericTeamId TeamId = RelationshipMatrix.GetTeam(Actor);
+    const float RadiusSquared = FMath::Square(Radius);
+
+    const FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.0f));
+    const FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.0f));
+
+    TArray<int32> CandidateIndices;
+
+    for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+    {
+        for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+        {
+            const FCell* Cell = Cells.Find(FIntPoint(CellX, CellY));
+            if (Cell == nullptr)
+            {
+                continue;
+            }
+
+            bool bHasHostileTeam = false;
+            for (const FCellTeam& CellTeam : Cell->Teams)
+            {
+                if (EnumHasAnyFlags(RelationshipMatrix.GetTeamRelationship(TeamId, CellTeam.TeamId),
+                                    ERTSRelationshipFlags::HOSTILE))
+                {
+                    bHasHostileTeam = true;
+                    break;
+                }
+            }
+
+            if (!bHasHostileTeam)
+            {
+                continue;
+            }
+
+            // If even the farthest corner of the cell is inside the radius, all of its actors are.
+            const float MaxDistanceX =
+                FMath::Max(FMath::Abs(CellX * CellSize - Location.X), FMath::Abs((CellX + 1) * CellSize - Location.X));
+            const float MaxDistanceY =
+                FMath::Max(FMath::Abs(CellY * CellSize - Location.Y), FMath::Abs((CellY + 1) * CellSize - Location.Y));
+
+            if (FMath::Square(MaxDistanceX) + FMath::Square(MaxDistanceY) <= RadiusSquared)
+            {
+                INC_DWORD_STAT(STAT_RTSSpatialGridHostileCellsCounted);
+                return true;
+            }
+
+            // Cell is on the boundary of the radius, so check its actors one by one.
+            INC_DWORD_STAT(STAT_RTSSpatialGridHostileCellsCheckedExactly);
+
+            CandidateIndices.Reset();
+            FilterCell(*Cell, Location, RadiusSquared, Location, RadiusSquared, CandidateIndices);
+
+            for (int32 CandidateIndex : CandidateIndices)
+            {
+                AActor* CellActor = Cell->Actors[CandidateIndex];
+                if (!IsValid(CellActor))
+                {
+                    continue;
+                }
+
+                // Teams counted for cells might be outdated if a team change hasn't been reported, so check the actual
+                // team of the actor before claiming it's hostile.
+                const FGenericTeamId CellActorTeamId = RelationshipMatrix.GetTeam(CellActor);
+                if (EnumHasAnyFlags(RelationshipMatrix.GetTeamRelationship(TeamId, CellActorTeamId),
+                                    ERTSRelationshipFlags::HOSTILE))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+int32 FRTSSpatialHashGrid::Num() const
+{
+    return Entries.Num();
+}
+
+float FRTSSpatialHashGrid::GetCellSize() const
+{
+    return CellSize;
+}
+
+FIntPoint FRTSSpatialHashGrid::GetCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FRTSSpatialHashGrid::GetCellsInRadius(const FVector& Location, float Radius, TArray<FIntPoint>& OutCells) const
+{
+    const FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.0f));
+    const FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.0f));
+
+    for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+    {
+        for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+        {
+            OutCells.Add(FIntPoint(CellX, CellY));
+        }
+    }
+}
+
+void FRTSSpatialHashGrid::GetActorsInCells(const TArray<FIntPoint>& CellsToSearch, TArray<AActor*>& OutActors) const
+{
+    for (const FIntPoint& CellCoordinates : CellsToSearch)
+    {
+        const FCell* Cell = Cells.Find(CellCoordinates);
+        if (Cell != nullptr)
+        {
+            OutActors.Append(Cell->Actors);
+        }
+    }
+}
+
+TRTSPerWorld<FRTSSpatialHashGrid>& FRTSSpatialHashGrid::GetWorldGrids()
+{
+    static TRTSPerWorld<FRTSSpatialHashGrid> WorldGrids;
+    return WorldGrids;
+}
+
+void FRTSSpatialHashGrid::AddToCell(AActor* Actor, FActorEntry& Entry, const FVector& Location)
+{
+    FCell& Cell = Cells.FindOrAdd(Entry.Cell);
+
+    Entry.CellIndex = Cell.Actors.Add(Actor);
+    Cell.LocationsX.Add(Location.X);
+    Cell.LocationsY.Add(Location.Y);
+
+    for (FCellTeam& CellTeam : Cell.Teams)
+    {
+        if (CellTeam.TeamId == Entry.TeamId)
+        {
+            ++CellTeam.NumActors;
+            return;
+        }
+    }
+
+    FCellTeam CellTeam;
+    CellTeam.TeamId = Entry.TeamId;
+    CellTeam.NumActors = 1;
+    Cell.Teams.Add(CellTeam);
+}
+
+void FRTSSpatialHashGrid::RemoveFromCell(const FActorEntry& Entry)
+{
+    FCell* Cell = Cells.Find(Entry.Cell);
+    if (Cell == nullptr)
+    {
+        return;
+    }
+
+    // Keep the arrays of the cell packed by moving its last actor into the gap.
+    Cell->Actors.RemoveAtSwap(Entry.CellIndex, 1, false);
+    Cell->LocationsX.RemoveAtSwap(Entry.CellIndex, 1, false);
+    Cell->LocationsY.RemoveAtSwap(Entry.CellIndex, 1, false);
+
+    if (Cell->Actors.IsValidIndex(Entry.CellIndex))
+    {
+        Entries[Cell->Actors[Entry.CellIndex]].CellIndex = Entry.CellIndex;
+    }
+
+    for (int32 TeamIndex = 0; TeamIndex < Cell->Teams.Num(); ++TeamIndex)
+    {
+        if (Cell->Teams[TeamIndex].TeamId == Entry.TeamId)
+        {
+            if (--Cell->Teams[TeamIndex].NumActors <= 0)
+            {
+                Cell->Teams.RemoveAtSwap(TeamIndex);
+            }
+
+            break;
+        }
+    }
+
+    if (Cell->Actors.Num() == 0)
+    {
+        Cells.Remove(Entry.Cell);
+    }
+}
+
+void FRTSSpatialHashGrid::FilterCell(const FCell& Cell, const FVector& Location, float RadiusSquared,
+                                     const FVector& HomeLocation, float ChaseDistanceSquared,
+                                     TArray<int32>& OutIndices)
+{
+    const int32 NumActors = Cell.Actors.Num();
+    const float* LocationsX = Cell.LocationsX.GetData();
+    const float* LocationsY = Cell.LocationsY.GetData();
+
+    const VectorRegister LocationX = VectorSetFloat1(Location.X);
+    const VectorRegister LocationY = VectorSetFloat1(Location.Y);
+    const VectorRegister HomeLocationX = VectorSetFloat1(HomeLocation.X);
+    const VectorRegister HomeLocationY = VectorSetFloat1(HomeLocation.Y);
+    const VectorRegister MaxDistanceSquared = VectorSetFloat1(RadiusSquared);
+    const VectorRegister MaxHomeDistanceSquared = VectorSetFloat1(ChaseDistanceSquared);
+
+    // Check four actors at a time.
+    int32 Index = 0;
+    for (; Index + 4 <= NumActors; Index += 4)
+    {
+        const VectorRegister X = VectorLoad(LocationsX + Index);
+        const VectorRegister Y = VectorLoad(LocationsY + Index);
+
+        const VectorRegister DeltaX = VectorSubtract(X, LocationX);
+        const VectorRegister DeltaY = VectorSubtract(Y, LocationY);
+        const VectorRegister DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+
+        const VectorRegister HomeDeltaX = VectorSubtract(X, HomeLocationX);
+        const VectorRegister HomeDeltaY = VectorSubtract(Y, HomeLocationY);
+        const VectorRegister HomeDistanceSquared =
+            VectorMultiplyAdd(HomeDeltaX, HomeDeltaX, VectorMultiply(HomeDeltaY, HomeDeltaY));
+
+        const VectorRegister InRange = VectorBitwiseAnd(VectorCompareGE(MaxDistanceSquared, DistanceSquared),
+                                                        VectorCompareGE(MaxHomeDistanceSquared, HomeDistanceSquared));
+
+        uint32 InRangeMask = (uint32)VectorMaskBits(InRange);
+        while (InRangeMask != 0)
+        {
+            OutIndices.Add(Index + (int32)FMath::CountTrailingZeros(InRangeMask));
+            InRangeMask &= InRangeMask - 1;
+        }
+    }
+
+    // Check the remaining actors one by one.
+    for (; Index < NumActors; ++Index)
+    {
+        const float DistanceSquared =
+            FMath::Square(LocationsX[Index] - Location.X) + FMath::Square(LocationsY[Index] - Location.Y);
+        const float HomeDistanceSquared =
+            FMath::Square(LocationsX[Index] - HomeLocation.X) + FMath::Square(LocationsY[Index] - HomeLocation.Y);
+
+        if (DistanceSquared <= RadiusSquared && HomeDistanceSquared <= ChaseDistanceSquared)
+        {
+            OutIndices.Add(Index);
+        }
+    }
+}
+
+void FRTSSpatialHashGrid::OnTransformUpdated(USceneComponent* UpdatedComponent,
+                                             EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+    UpdateActor(UpdatedComponent->GetOwner());
+}
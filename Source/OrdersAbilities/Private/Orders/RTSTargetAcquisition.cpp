@@ -0,0 +1,200 @@
+#include "Orders/RTSTargetAcquisition.h"
+
+#include "OrdersAbilities.h"
+
+#include "GameFramework/Actor.h"
+
+#include "Orders/RTSCompiledOrderTagRequirements.h"
+#include "Orders/RTSOrder.h"
+#include "Orders/RTSOrderComponent.h"
+#include "Orders/RTSOrderHelper.h"
+#include "Orders/RTSOrderTypeRegistry.h"
+#include "Orders/RTSSpatialHashGrid.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("RTS - Target Acquisition"), STAT_RTSTargetAcquisition, STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Target Acquisition Searches"), STAT_RTSTargetAcquisitionSearches,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Target Acquisition Groups Gathered"), STAT_RTSTargetAcquisitionGroupsGathered,
+                           STATGROUP_RTS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RTS - Target Acquisition Groups Shared"), STAT_RTSTargetAcquisitionGroupsShared,
+                           STATGROUP_RTS);
+
+
+FRTSScoredTarget::FRTSScoredTarget(AActor* InActor, float InScore)
+    : Actor(InActor)
+    , Score(InScore)
+{
+}
+
+FRTSTargetAcquisitionRequest::FRTSTargetAcquisitionRequest(const AActor* InOrderedActor,
+                                                           TSoftClassPtr<URTSOrder> InOrderType, int32 InIndex,
+                                                           float InAcquisitionRadius)
+    : OrderedActor(InOrderedActor)
+    , OrderType(InOrderType)
+    , Index(InIndex)
+    , AcquisitionRadius(InAcquisitionRadius)
+{
+}
+
+FRTSTargetAcquisition::FCandidateGroup::FCandidateGroup()
+    : GatherRadius(-1.0f)
+{
+}
+
+FRTSTargetAcquisition::FRTSTargetAcquisition()
+    : CandidateGroupsFrame(0)
+{
+}
+
+FRTSTargetAcquisition* FRTSTargetAcquisition::Get(const UWorld* World)
+{
+    return GetWorldTargetAcquisitions().FindOrAdd(World);
+}
+
+void FRTSTargetAcquisition::FindBestTargets(const FRTSTargetAcquisitionRequest& Request, int32 MaxTargets,
+                                            TArray<FRTSScoredTarget>& OutTargets)
+{
+    check(IsInGameThread());
+
+    SCOPE_CYCLE_COUNTER(STAT_RTSTargetAcquisition);
+    INC_DWORD_STAT(STAT_RTSTargetAcquisitionSearches);
+
+    OutTargets.Reset();
+
+    const AActor* OrderedActor = Request.OrderedActor;
+    if (!IsValid(OrderedActor) || Request.OrderType == nullptr || MaxTargets <= 0)
+    {
+        return;
+    }
+
+    const URTSOrder* Order = FRTSOrderTypeRegistry::Get().GetDefaultObject(Request.OrderType);
+    if (Order == nullptr)
+    {
+        return;
+    }
+
+    // Only target types with a real target location are relevant.
+    ERTSTargetType TargetType = Order->GetTargetType(OrderedActor, Request.Index);
+    if (TargetType == ERTSTargetType::NONE || TargetType == ERTSTargetType::PASSIVE)
+    {
+        return;
+    }
+
+    const FCandidateGroup* CandidateGroup =
+        GatherCandidates(Order, OrderedActor, Request.Index, Request.AcquisitionRadius);
+    if (CandidateGroup == nullptr)
+    {
+        return;
+    }
+
+    // Use the cached tag requirements of the unit, if possible.
+    const URTSOrderComponent* OrderComponent = OrderedActor->FindComponentByClass<URTSOrderComponent>();
+    TSharedPtr<const FRTSCompiledOrderTagRequirements> TagRequirements;
+
+    if (OrderComponent != nullptr)
+    {
+        TagRequirements = OrderComponent->GetTagRequirements(Order, Request.Index);
+    }
+    else
+    {
+        TSharedRef<FRTSCompiledOrderTagRequirements> LocalTagRequirements =
+            MakeShared<FRTSCompiledOrderTagRequirements>();
+        Order->GetTagRequirements(OrderedActor, Request.Index, *LocalTagRequirements);
+        LocalTagRequirements->Compile();
+        TagRequirements = LocalTagRequirements;
+    }
+
+    const FVector Location = OrderedActor->GetActorLocation();
+    const float RadiusSquared = FMath::Square(Request.AcquisitionRadius);
+
+    TArray<AActor*> Candidates;
+
+    for (int32 CandidateIndex = 0; CandidateIndex < CandidateGroup->Actors.Num(); ++CandidateIndex)
+    {
+        // The group might have been gathered for a larger radius or by another unit.
+        const float DistanceSquared = FMath::Square(CandidateGroup->LocationsX[CandidateIndex] - Location.X) +
+                                      FMath::Square(CandidateGroup->LocationsY[CandidateIndex] - Location.Y);
+        if (DistanceSquared <= RadiusSquared)
+        {
+            Candidates.Add(CandidateGroup->Actors[CandidateIndex]);
+        }
+    }
+
+    URTSOrderHelper::FindBestScoredTargetsForOrder(Order, OrderedActor, Request.Index, Candidates, *TagRequirements,
+                                                   MaxTargets, OutTargets);
+}
+
+void FRTSTargetAcquisition::FindBestTargets(const TArray<FRTSTargetAcquisitionRequest>& Requests, int32 MaxTargets,
+                                            TArray<TArray<FRTSScoredTarget>>& OutTargets)
+{
+    OutTargets.SetNum(Requests.Num());
+
+    // Requests of units close to each other share their groups, as long as they are handled in the same frame.
+    for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); ++RequestIndex)
+    {
+        FindBestTargets(Requests[RequestIndex], MaxTargets, OutTargets[RequestIndex]);
+    }
+}
+
+TRTSPerWorld<FRTSTargetAcquisition>& FRTSTargetAcquisition::GetWorldTargetAcquisitions()
+{
+    static TRTSPerWorld<FRTSTargetAcquisition> WorldTargetAcquisitions;
+    return WorldTargetAcquisitions;
+}
+
+void FRTSTargetAcquisition::ResetIfNewFrame()
+{
+    if (CandidateGroupsFrame == GFrameCounter)
+    {
+        return;
+    }
+
+    CandidateGroupsFrame = GFrameCounter;
+    CandidateGroups.Reset();
+}
+
+const FRTSTargetAcquisition::FCandidateGroup*
+FRTSTargetAcquisition::GatherCandidates(const URTSOrder* Order, const AActor* OrderedActor, int32 Index,
+                                        float AcquisitionRadius)
+{
+    const FRTSSpatialHashGrid* Grid = FRTSSpatialHashGrid::Find(OrderedActor->GetWorld());
+    if (Grid == nullptr)
+    {
+        return nullptr;
+    }
+
+    ResetIfNewFrame();
+
+    // Gather the targets of all units in the grid cell around its center, so the group covers the acquisition radius
+    // of each of them.
+    const FIntPoint Cell = Grid->GetCell(OrderedActor->GetActorLocation());
+    const float CellSize = Grid->GetCellSize();
+    const FVector CellCenter((Cell.X + 0.5f) * CellSize, (Cell.Y + 0.5f) * CellSize, 0.0f);
+    const float GatherRadius = CellSize * FMath::Sqrt(0.5f) + AcquisitionRadius;
+
+    FCandidateGroup& CandidateGroup = CandidateGroups.FindOrAdd(MakeTuple(Cell, Order, Index));
+    if (CandidateGroup.GatherRadius >= GatherRadius)
+    {
+        INC_DWORD_STAT(STAT_RTSTargetAcquisitionGroupsShared);
+        return &CandidateGroup;
+    }
+
+    INC_DWORD_STAT(STAT_RTSTargetAcquisitionGroupsGathered);
+
+    CandidateGroup.GatherRadius = GatherRadius;
+    CandidateGroup.Actors.Reset();
+    CandidateGroup.LocationsX.Reset();
+    CandidateGroup.LocationsY.Reset();
+
+    Grid->FindActorsInRadius(CellCenter, GatherRadius, CandidateGroup.Actors);
+
+    for (const AActor* Actor : CandidateGroup.Actors)
+    {
+        const FVector ActorLocation = Actor->GetActorLocation();
+        CandidateGroup.LocationsX.Add(ActorLocation.X);
+        CandidateGroup.LocationsY.Add(ActorLocation.Y);
+    }
+
+    return &CandidateGroup;
+}
@@ -375,7 +375,7 @@ float URTSUseAbilityOrder::GetTargetScore(const AActor* OrderedActor, const FRTS
 
     if (Ability == nullptr || !Ability->IsTargetScoreOverriden())
     {
-        Super::GetTargetScore(OrderedActor, TargetData, Index);
+        return Super::GetTargetScore(OrderedActor, TargetData, Index);
     }
 
     float TargetScore;
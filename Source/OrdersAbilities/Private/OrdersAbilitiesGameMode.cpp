@@ -1 +1,33 @@
 #include "OrdersAbilitiesGameMode.h"
+
+#include "OrdersAbilities.h"
+
+#include "Orders/RTSAutoOrderScheduler.h"
+
+
+void AOrdersAbilitiesGameMode::AddAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent)
+{
+	FRTSAutoOrderScheduler* Scheduler = FRTSAutoOrderScheduler::Get(GetWorld());
+	if (Scheduler != nullptr)
+	{
+		Scheduler->AddAutoOrderComponent(AutoOrderComponent);
+	}
+}
+
+void AOrdersAbilitiesGameMode::RemoveAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent)
+{
+	FRTSAutoOrderScheduler* Scheduler = FRTSAutoOrderScheduler::Find(GetWorld());
+	if (Scheduler != nullptr)
+	{
+		Scheduler->RemoveAutoOrderComponent(AutoOrderComponent);
+	}
+}
+
+void AOrdersAbilitiesGameMode::WakeUpAutoOrderComponent(URTSAutoOrderComponent* AutoOrderComponent)
+{
+	FRTSAutoOrderScheduler* Scheduler = FRTSAutoOrderScheduler::Find(GetWorld());
+	if (Scheduler != nullptr)
+	{
+		Scheduler->WakeUpAutoOrderComponent(AutoOrderComponent);
+	}
+}
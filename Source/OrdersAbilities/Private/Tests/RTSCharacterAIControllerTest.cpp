@@ -0,0 +1,99 @@
+#include "OrdersAbilities.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#include "Orders/RTSCharacterAIController.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTSCharacterAIControllerTickBenchmarkTest,
+                                 "OrdersAbilities.CharacterAIController.TickBenchmark",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FRTSCharacterAIControllerTickBenchmarkTest::RunTest(const FString& Parameters)
+{
+    const int32 NumControllers = 1000;
+    const int32 NumFocusedControllers = 100;
+    const int32 NumFrames = 60;
+    const float DeltaTime = 1.0f / 60.0f;
+
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    // Actors only register their tick functions when play has begun.
+    World->InitializeActorsForPlay(FURL());
+    World->BeginPlay();
+
+    TArray<ARTSCharacterAIController*> Controllers;
+
+    for (int32 Index = 0; Index < NumControllers; ++Index)
+    {
+        Controllers.Add(World->SpawnActor<ARTSCharacterAIController>());
+    }
+
+    // Counts the controllers that will tick, and measures the time of ticking the world a few frames.
+    auto TickWorld = [World, &Controllers, NumFrames, DeltaTime](int32& OutNumTickingControllers) -> double {
+        OutNumTickingControllers = 0;
+
+        for (const ARTSCharacterAIController* Controller : Controllers)
+        {
+            OutNumTickingControllers += Controller->IsActorTickEnabled();
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            World->Tick(LEVELTICK_All, DeltaTime);
+        }
+
+        return FPlatformTime::Seconds() - StartTime;
+    };
+
+    int32 NumTickingControllers = 0;
+    const double IdleTime = TickWorld(NumTickingControllers);
+    TestEqual(TEXT("Ticking controllers without focus"), NumTickingControllers, 0);
+
+    // Only controllers with a focus need to update their control rotation each frame.
+    for (int32 Index = 0; Index < NumFocusedControllers; ++Index)
+    {
+        Controllers[Index]->SetFocalPoint(FVector(100.0f * Index, 0.0f, 0.0f));
+    }
+
+    const double FocusedTime = TickWorld(NumTickingControllers);
+    TestEqual(TEXT("Ticking controllers with focus"), NumTickingControllers, NumFocusedControllers);
+
+    // Compare with all controllers ticking, like they did before.
+    for (int32 Index = NumFocusedControllers; Index < NumControllers; ++Index)
+    {
+        Controllers[Index]->SetFocalPoint(FVector(100.0f * Index, 0.0f, 0.0f));
+    }
+
+    const double AllTickingTime = TickWorld(NumTickingControllers);
+    TestEqual(TEXT("Ticking controllers all with focus"), NumTickingControllers, NumControllers);
+
+    // Controllers stop ticking as soon as their focus has been cleared.
+    for (ARTSCharacterAIController* Controller : Controllers)
+    {
+        Controller->ClearFocus(EAIFocusPriority::Gameplay);
+    }
+
+    TickWorld(NumTickingControllers);
+    TestEqual(TEXT("Ticking controllers after clearing focus"), NumTickingControllers, 0);
+
+    AddInfo(FString::Printf(TEXT("%d frames with %d controllers: no focus %.3f ms, %d focused %.3f ms, all ticking "
+                                 "%.3f ms."),
+                            NumFrames, NumControllers, IdleTime * 1000.0, NumFocusedControllers, FocusedTime * 1000.0,
+                            AllTickingTime * 1000.0));
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    return true;
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "OrdersAbilities.h"
+
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/PackageName.h"
+#include "Tests/AutomationCommon.h"
+
+#include "Orders/RTSFlowField.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TAutoConsoleVariable<FString> CVarRTSFlowFieldBenchmarkMap(
+    TEXT("RTS.FlowFields.BenchmarkMap"), TEXT("/Game/Tests/FlowFieldBenchmark"),
+    TEXT("Map to compare flow fields against per-unit pathing on. Needs navigation data for at least 6000 world "
+         "units around the world origin."),
+    ECVF_Default);
+
+/** Moves a large group across the map with paths found per unit, and along a flow field, and compares both. */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FRTSCompareFlowFieldWithPathingCommand, FAutomationTestBase*, Test);
+
+bool FRTSCompareFlowFieldWithPathingCommand::Update()
+{
+    const int32 NumUnits = 200;
+    const int32 UnitsPerRow = 20;
+    const float UnitSpacing = 100.0f;
+    const float GroupDistance = 5000.0f;
+    const float CellSize = 200.0f;
+    const int32 LookAheadCells = 4;
+    const FVector ProjectionExtent(UnitSpacing, UnitSpacing, 1000.0f);
+
+    UWorld* World = nullptr;
+    for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+    {
+        if (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE)
+        {
+            World = WorldContext.World();
+            break;
+        }
+    }
+
+    UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+    if (NavigationSystem == nullptr)
+    {
+        Test->AddError(TEXT("No navigation system in the benchmark map."));
+        return true;
+    }
+
+    // Wait for navigation data that is built at runtime.
+    if (NavigationSystem->IsNavigationBuildInProgress())
+    {
+        return false;
+    }
+
+    const ANavigationData* NavData = NavigationSystem->GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
+    FNavLocation Destination;
+
+    if (NavData == nullptr || !NavData->ProjectPoint(FVector::ZeroVector, Destination, ProjectionExtent))
+    {
+        Test->AddError(TEXT("No navigation data at the world origin of the benchmark map."));
+        return true;
+    }
+
+    // Place the whole group far away from the destination, as for a move order across the map.
+    TArray<FVector> UnitLocations;
+
+    for (int32 UnitIndex = 0; UnitIndex < NumUnits; ++UnitIndex)
+    {
+        const FVector Location(GroupDistance + (UnitIndex % UnitsPerRow) * UnitSpacing,
+                               (UnitIndex / UnitsPerRow - NumUnits / UnitsPerRow / 2) * UnitSpacing, 0.0f);
+        FNavLocation ProjectedLocation;
+
+        if (NavData->ProjectPoint(Location, ProjectedLocation, ProjectionExtent))
+        {
+            UnitLocations.Add(ProjectedLocation.Location);
+        }
+    }
+
+    // Find a path for each unit, as without flow fields.
+    int32 NumPathsFound = 0;
+    const double PathingStartTime = FPlatformTime::Seconds();
+
+    for (const FVector& UnitLocation : UnitLocations)
+    {
+        FPathFindingQuery Query(NavigationSystem, *NavData, UnitLocation, Destination.Location);
+        if (NavigationSystem->FindPathSync(Query).IsSuccessful())
+        {
+            ++NumPathsFound;
+        }
+    }
+
+    const double PathingTime = FPlatformTime::Seconds() - PathingStartTime;
+
+    // Build a single flow field for the whole group, and let each unit follow it to the destination.
+    const double BuildStartTime = FPlatformTime::Seconds();
+    const int32 HalfExtentInCells =
+        FMath::CeilToInt((GroupDistance + UnitsPerRow * UnitSpacing + UnitSpacing) / CellSize);
+
+    FRTSFlowField FlowField(Destination.Location, CellSize, HalfExtentInCells);
+    while (!FlowField.Build(NavData, FPlatformTime::Seconds() + 1.0))
+    {
+    }
+
+    const double BuildTime = FPlatformTime::Seconds() - BuildStartTime;
+
+    int32 NumFlowFieldPathsFound = 0;
+    const int32 MaxWaypoints = FMath::Square(HalfExtentInCells * 2 + 1);
+    const double FollowStartTime = FPlatformTime::Seconds();
+
+    for (const FVector& UnitLocation : UnitLocations)
+    {
+        FVector Location = UnitLocation;
+
+        for (int32 WaypointIndex = 0; WaypointIndex < MaxWaypoints; ++WaypointIndex)
+        {
+            FVector Waypoint;
+            if (!FlowField.GetWaypoint(Location, LookAheadCells, Waypoint))
+            {
+                break;
+            }
+
+            // Only the destination cell leads to itself.
+            if (Waypoint.Equals(Location))
+            {
+                ++NumFlowFieldPathsFound;
+                break;
+            }
+
+            Location = Waypoint;
+        }
+    }
+
+    const double FollowTime = FPlatformTime::Seconds() - FollowStartTime;
+
+    Test->AddInfo(FString::Printf(TEXT("Per-unit pathing: %d of %d paths found in %.2f ms."), NumPathsFound,
+                                  UnitLocations.Num(), PathingTime * 1000.0));
+    Test->AddInfo(FString::Printf(
+        TEXT("Flow field: %d of %d units reached the destination. Built in %.2f ms, followed in %.2f ms."),
+        NumFlowFieldPathsFound, UnitLocations.Num(), BuildTime * 1000.0, FollowTime * 1000.0));
+
+    Test->TestTrue(TEXT("Flow field is valid"), FlowField.IsValid());
+    // Units in cells whose center isn't walkable can't follow the field, and find paths on their own instead.
+    Test->TestTrue(TEXT("Most units reach the destination along the flow field"),
+                   NumFlowFieldPathsFound * 10 >= NumPathsFound * 9);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTSFlowFieldPathingComparisonTest, "OrdersAbilities.FlowField.PathingComparison",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                     EAutomationTestFlags::PerfFilter)
+
+bool FRTSFlowFieldPathingComparisonTest::RunTest(const FString& Parameters)
+{
+    const FString MapName = CVarRTSFlowFieldBenchmarkMap.GetValueOnGameThread();
+    if (!FPackageName::DoesPackageExist(MapName))
+    {
+        AddWarning(FString::Printf(TEXT("Benchmark map %s not found, see RTS.FlowFields.BenchmarkMap."), *MapName));
+        return true;
+    }
+
+    AutomationOpenMap(MapName);
+    ADD_LATENT_AUTOMATION_COMMAND(FRTSCompareFlowFieldWithPathingCommand(this));
+    return true;
+}
+
+#endif
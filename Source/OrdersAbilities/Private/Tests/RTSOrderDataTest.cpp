@@ -0,0 +1,112 @@
+#include "OrdersAbilities.h"
+
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+#include "Orders/RTSOrderData.h"
+#include "Orders/RTSStopOrder.h"
+#include "RTSTestPackageMap.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTSOrderDataNetSerializeTest, "OrdersAbilities.OrderData.NetSerialize",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FRTSOrderDataNetSerializeTest::RunTest(const FString& Parameters)
+{
+    URTSTestPackageMap* PackageMap = NewObject<URTSTestPackageMap>();
+    AActor* Target = GetMutableDefault<AActor>();
+    const TSoftClassPtr<URTSOrder> OrderType(URTSStopOrder::StaticClass());
+
+    IConsoleVariable* PrecisionVariable =
+        IConsoleManager::Get().FindConsoleVariable(TEXT("RTS.Net.OrderLocationPrecision"));
+    const float OriginalPrecision = PrecisionVariable->GetFloat();
+
+    // Sends the specified order through a bit stream, and checks that it arrives with the specified location tolerance.
+    auto TestRoundTrip = [this, PackageMap](const FString& What, const FRTSOrderData& SentOrder, float Tolerance) {
+        FBitWriter Writer(0, true);
+        bool bSuccess = false;
+        FRTSOrderData(SentOrder).NetSerialize(Writer, PackageMap, bSuccess);
+        TestTrue(What + TEXT(" is written"), bSuccess && !Writer.IsError());
+
+        FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+        FRTSOrderData ReceivedOrder;
+        ReceivedOrder.NetSerialize(Reader, PackageMap, bSuccess);
+        TestTrue(What + TEXT(" is read"), bSuccess && !Reader.IsError());
+        TestTrue(What + TEXT(" is read completely"), Reader.GetBitsLeft() == 0);
+
+        TestTrue(What + TEXT(" keeps its order type"), ReceivedOrder.OrderType == SentOrder.OrderType);
+        TestTrue(What + TEXT(" keeps whether to use its location"),
+                 ReceivedOrder.bUseLocation == SentOrder.bUseLocation);
+        TestTrue(What + TEXT(" keeps its target"), ReceivedOrder.Target == SentOrder.Target);
+        TestEqual(What + TEXT(" keeps its index"), ReceivedOrder.Index, SentOrder.Index);
+
+        if (SentOrder.bUseLocation)
+        {
+            TestEqual(What + TEXT(" keeps its location"), FVector(ReceivedOrder.Location, 0.0f),
+                      FVector(SentOrder.Location, 0.0f), Tolerance);
+        }
+        else
+        {
+            TestTrue(What + TEXT(" has no location"), ReceivedOrder.Location.IsZero());
+        }
+    };
+
+    // Negative, fractional and large coordinates, including ones that can't be quantized with the default precision.
+    TArray<FVector2D> Locations;
+    Locations.Add(FVector2D::ZeroVector);
+    Locations.Add(FVector2D(123.4f, -567.8f));
+    Locations.Add(FVector2D(-0.4f, 0.6f));
+    Locations.Add(FVector2D(-1000000.0f, 2500000.0f));
+    Locations.Add(FVector2D(3.0e9f, -3.0e9f));
+
+    // The unset index, and small, negative and large ones.
+    TArray<int32> Indices;
+    Indices.Add(-1);
+    Indices.Add(0);
+    Indices.Add(5);
+    Indices.Add(-2);
+    Indices.Add(1000000);
+    Indices.Add(MAX_int32);
+    Indices.Add(MIN_int32);
+
+    PrecisionVariable->Set(1.0f, ECVF_SetByCode);
+
+    // Every combination of order type, location, target and index being set.
+    for (int32 Combination = 0; Combination < 16; ++Combination)
+    {
+        const bool bHasOrderType = (Combination & 1) != 0;
+        const bool bHasLocation = (Combination & 2) != 0;
+        const bool bHasTarget = (Combination & 4) != 0;
+        const bool bHasIndex = (Combination & 8) != 0;
+
+        for (int32 LocationIndex = 0; LocationIndex < (bHasLocation ? Locations.Num() : 1); ++LocationIndex)
+        {
+            for (int32 IndexIndex = bHasIndex ? 1 : 0; IndexIndex < (bHasIndex ? Indices.Num() : 1); ++IndexIndex)
+            {
+                FRTSOrderData Order;
+                Order.OrderType = bHasOrderType ? OrderType : nullptr;
+                Order.bUseLocation = bHasLocation;
+                Order.Location = bHasLocation ? Locations[LocationIndex] : FVector2D::ZeroVector;
+                Order.Target = bHasTarget ? Target : nullptr;
+                Order.Index = Indices[IndexIndex];
+
+                TestRoundTrip(FString::Printf(TEXT("Order %s"), *Order.ToString()), Order, 0.5f);
+            }
+        }
+    }
+
+    // Precisions that would make quantized coordinates overflow are clamped.
+    PrecisionVariable->Set(0.0f, ECVF_SetByCode);
+    TestRoundTrip(TEXT("Order sent with zero precision"),
+                  FRTSOrderData(OrderType, FVector2D(-12345.678f, 98765.432f)), 0.02f);
+
+    PrecisionVariable->Set(OriginalPrecision, ECVF_SetByCode);
+    return true;
+}
+
+#endif
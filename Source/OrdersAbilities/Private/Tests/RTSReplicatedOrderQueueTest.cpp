@@ -0,0 +1,135 @@
+#include "OrdersAbilities.h"
+
+#include "Engine/NetSerialization.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/UnrealType.h"
+
+#include "Orders/RTSMoveOrder.h"
+#include "Orders/RTSReplicatedOrderQueue.h"
+#include "RTSTestPackageMap.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Serializes all replicated properties of fast array items, like the replication layout of an actor channel would. */
+class FRTSTestNetSerializeCB : public INetSerializeCB
+{
+public:
+    virtual void NetSerializeStruct(UScriptStruct* Struct, FBitArchive& Ar, UPackageMap* Map, void* Data,
+                                    bool& bHasUnmapped) override
+    {
+        for (TFieldIterator<UProperty> It(Struct); It; ++It)
+        {
+            if (It->HasAnyPropertyFlags(CPF_RepSkip))
+            {
+                continue;
+            }
+
+            for (int32 ArrayIndex = 0; ArrayIndex < It->ArrayDim; ++ArrayIndex)
+            {
+                It->NetSerializeItem(Ar, Map, It->ContainerPtrToValuePtr<void>(Data, ArrayIndex));
+            }
+        }
+    }
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTSReplicatedOrderQueueBandwidthTest,
+                                 "OrdersAbilities.ReplicatedOrderQueue.Bandwidth",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FRTSReplicatedOrderQueueBandwidthTest::RunTest(const FString& Parameters)
+{
+    const int32 NumWaypoints = 20;
+
+    URTSTestPackageMap* PackageMap = NewObject<URTSTestPackageMap>();
+    FRTSTestNetSerializeCB NetSerializeCB;
+    const TSoftClassPtr<URTSOrder> MoveOrder(URTSMoveOrder::StaticClass());
+
+    FRTSReplicatedOrderQueue ServerQueue;
+    FRTSReplicatedOrderQueue ClientQueue;
+    TSharedPtr<INetDeltaBaseState> LastState;
+
+    // Sends all changes since the last call to the client, and returns the number of bits written.
+    auto Replicate = [&](const FString& What) -> int64 {
+        FBitWriter Writer(0, true);
+        TSharedPtr<INetDeltaBaseState> NewState;
+
+        FNetDeltaSerializeInfo WriteParms;
+        WriteParms.Writer = &Writer;
+        WriteParms.Map = PackageMap;
+        WriteParms.NetSerializeCB = &NetSerializeCB;
+        WriteParms.OldState = LastState.Get();
+        WriteParms.NewState = &NewState;
+        TestTrue(What + TEXT(" is written"), ServerQueue.NetDeltaSerialize(WriteParms) && !Writer.IsError());
+
+        if (NewState.IsValid())
+        {
+            LastState = NewState;
+        }
+
+        if (Writer.GetNumBits() == 0)
+        {
+            return 0;
+        }
+
+        FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+
+        FNetDeltaSerializeInfo ReadParms;
+        ReadParms.Reader = &Reader;
+        ReadParms.Map = PackageMap;
+        ReadParms.NetSerializeCB = &NetSerializeCB;
+        TestTrue(What + TEXT(" is read"), ClientQueue.NetDeltaSerialize(ReadParms) && !Reader.IsError());
+        ClientQueue.ApplyReceivedChanges();
+
+        TArray<FRTSOrderData> ServerOrders;
+        TArray<FRTSOrderData> ClientOrders;
+        ServerQueue.ToArray(ServerOrders);
+        ClientQueue.ToArray(ClientOrders);
+
+        TestEqual(What + TEXT(" keeps the number of orders"), ClientOrders.Num(), ServerOrders.Num());
+        TestTrue(What + TEXT(" keeps the orders in order"), ClientOrders == ServerOrders);
+
+        return Writer.GetNumBits();
+    };
+
+    for (int32 Index = 0; Index < NumWaypoints; ++Index)
+    {
+        ServerQueue.PushBack(FRTSOrderData(MoveOrder, FVector2D(Index * 100.0f, -Index * 50.0f)));
+    }
+
+    const int64 FullQueueBits = Replicate(TEXT("Initial queue"));
+
+    // Appending a single waypoint should only send that waypoint, not the whole queue again.
+    ServerQueue.PushBack(FRTSOrderData(MoveOrder, FVector2D(-300.0f, 700.0f)));
+    const int64 AppendBits = Replicate(TEXT("Appended waypoint"));
+
+    AddInfo(FString::Printf(TEXT("%d queued orders: %lld bits, appending a waypoint: %lld bits."), NumWaypoints,
+                            FullQueueBits, AppendBits));
+    TestTrue(TEXT("Appending a waypoint sends less than a quarter of the bits of the whole queue"),
+             AppendBits * 4 < FullQueueBits);
+
+    // Popping, pushing to the front and clearing must arrive in the correct order as well.
+    ServerQueue.PopFront();
+    Replicate(TEXT("Popped order"));
+
+    ServerQueue.PushFront(FRTSOrderData(MoveOrder, FVector2D(42.0f, 24.0f)));
+    Replicate(TEXT("Order pushed to the front"));
+
+    ServerQueue.PopFront();
+    ServerQueue.PopFront();
+    ServerQueue.PushBack(FRTSOrderData(MoveOrder, FVector2D(1.0f, 2.0f)));
+    Replicate(TEXT("Mixed changes"));
+
+    ServerQueue.Reset();
+    Replicate(TEXT("Cleared queue"));
+    TestTrue(TEXT("Cleared queue is empty on the client"), ClientQueue.IsEmpty());
+
+    ServerQueue.PushBack(FRTSOrderData(MoveOrder, FVector2D(5.0f, 5.0f)));
+    Replicate(TEXT("Order after clearing"));
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include "OrdersAbilities.h"
+
+#include "AIController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#include "Orders/RTSSpatialHashGrid.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTSSpatialHashGridBenchmarkTest, "OrdersAbilities.SpatialHashGrid.Benchmark",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FRTSSpatialHashGridBenchmarkTest::RunTest(const FString& Parameters)
+{
+    const int32 NumActors = 2000;
+    const int32 NumQueries = 1000;
+    const float MapSize = 20000.0f;
+    const float CellSize = 1000.0f;
+    const float Radius = 1500.0f;
+    const float ChaseDistance = 2000.0f;
+
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    // AI controllers are actors with a team and a root component, which is all the grid needs.
+    FRandomStream RandomStream(42);
+    FRTSSpatialHashGrid Grid(CellSize);
+    TArray<AAIController*> Actors;
+
+    for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+    {
+        const FVector Location(RandomStream.FRandRange(0.0f, MapSize), RandomStream.FRandRange(0.0f, MapSize), 0.0f);
+
+        AAIController* Actor = World->SpawnActor<AAIController>(Location, FRotator::ZeroRotator);
+        Actor->SetGenericTeamId(FGenericTeamId(ActorIndex % 2));
+
+        Grid.RegisterActor(Actor);
+        Actors.Add(Actor);
+    }
+
+    TestEqual(TEXT("Actors in grid"), Grid.Num(), NumActors);
+
+    TArray<FVector> QueryLocations;
+    for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+    {
+        QueryLocations.Add(Actors[RandomStream.RandHelper(NumActors)]->GetActorLocation());
+    }
+
+    // Radius queries, checked against testing all actors.
+    TArray<AActor*> FoundActors;
+    int32 NumFoundActors = 0;
+    double StartTime = FPlatformTime::Seconds();
+
+    for (const FVector& Location : QueryLocations)
+    {
+        FoundActors.Reset();
+        Grid.FindActorsInRadius(Location, Radius, FoundActors);
+        NumFoundActors += FoundActors.Num();
+    }
+
+    const double RadiusTime = FPlatformTime::Seconds() - StartTime;
+
+    int32 NumExpectedActors = 0;
+    StartTime = FPlatformTime::Seconds();
+
+    for (const FVector& Location : QueryLocations)
+    {
+        for (const AActor* Actor : Actors)
+        {
+            NumExpectedActors += FVector::DistSquared2D(Actor->GetActorLocation(), Location) <= FMath::Square(Radius);
+        }
+    }
+
+    const double BruteForceTime = FPlatformTime::Seconds() - StartTime;
+
+    TestEqual(TEXT("Actors found in radius"), NumFoundActors, NumExpectedActors);
+
+    // Chase distance queries, with the home location some distance away.
+    StartTime = FPlatformTime::Seconds();
+
+    for (const FVector& Location : QueryLocations)
+    {
+        FoundActors.Reset();
+        Grid.FindActorsInChaseDistance(Location, Radius, Location + FVector(ChaseDistance * 0.5f, 0.0f, 0.0f),
+                                       ChaseDistance, FoundActors);
+    }
+
+    const double ChaseDistanceTime = FPlatformTime::Seconds() - StartTime;
+
+    // Hostile checks, mostly answered by the team counts of the cells.
+    int32 NumHostileQueries = 0;
+    StartTime = FPlatformTime::Seconds();
+
+    for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+    {
+        NumHostileQueries += Grid.IsHostileInRadius(Actors[QueryIndex % NumActors], QueryLocations[QueryIndex], Radius);
+    }
+
+    const double HostileTime = FPlatformTime::Seconds() - StartTime;
+
+    TestTrue(TEXT("Hostile actors found in a crowded map"), NumHostileQueries > 0);
+
+    AddInfo(FString::Printf(TEXT("%d queries on %d actors: radius %.3f ms (brute force %.3f ms), chase distance "
+                                 "%.3f ms, hostile in radius %.3f ms."),
+                            NumQueries, NumActors, RadiusTime * 1000.0, BruteForceTime * 1000.0,
+                            ChaseDistanceTime * 1000.0, HostileTime * 1000.0));
+
+    for (AAIController* Actor : Actors)
+    {
+        Grid.UnregisterActor(Actor);
+    }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    return true;
+}
+
+#endif
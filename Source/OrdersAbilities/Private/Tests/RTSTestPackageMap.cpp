@@ -0,0 +1,23 @@
+#include "RTSTestPackageMap.h"
+
+#include "OrdersAbilities.h"
+
+
+bool URTSTestPackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+    int32 ObjectIndex = INDEX_NONE;
+
+    if (Ar.IsSaving() && Obj != nullptr)
+    {
+        ObjectIndex = Objects.AddUnique(Obj);
+    }
+
+    Ar << ObjectIndex;
+
+    if (Ar.IsLoading())
+    {
+        Obj = Objects.IsValidIndex(ObjectIndex) ? Objects[ObjectIndex] : nullptr;
+    }
+
+    return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "RTSTestPackageMap.generated.h"
+
+/**
+ * Package map for serialization tests, which sends objects as their index in a list shared by all archives using the
+ * map, without any net driver or connection.
+ */
+UCLASS(Transient)
+class URTSTestPackageMap : public UPackageMap
+{
+    GENERATED_BODY()
+
+public:
+    //~ Begin UPackageMap Interface
+    virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj,
+                                 FNetworkGUID* OutNetGUID = nullptr) override;
+    //~ End UPackageMap Interface
+
+private:
+    /** All objects that have been sent through the map, by index. */
+    UPROPERTY()
+    TArray<UObject*> Objects;
+};